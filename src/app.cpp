@@ -30,6 +30,7 @@
 #include "clhelp.h"
 #include "images.h"
 #include "iconprovider.h"
+#include "starttrace.h"
 #include "wzdebug.h"
 
 #include <QFile>
@@ -141,6 +142,7 @@ void TApp::changeStyleSheet(const QString& style) {
 
 void TApp::setupStyle() {
     WZT;
+    WZSTARTTRACE("TApp::setupStyle");
 
     // Set application style
     // From help: Warning: To ensure that the application's style is set
@@ -177,6 +179,7 @@ bool TApp::loadCatalog(QTranslator& translator,
 
 void TApp::loadTranslation() {
     WZDEBUG("");
+    WZSTARTTRACE("TApp::loadTranslation");
 
     QString locale = Settings::pref->language;
     if (locale.isEmpty()) {
@@ -195,13 +198,17 @@ void TApp::loadTranslation() {
 
 void TApp::loadConfig(bool portable) {
     WZD;
+    WZSTARTTRACE("TApp::loadConfig");
 
     // Setup config dir
     Settings::TPaths::setConfigPath(portable);
     // Create settings
     Settings::pref = new Settings::TPreferences();
     // Load settings
-    Settings::pref->load();
+    {
+        WZSTARTTRACE("TPreferences::load");
+        Settings::pref->load();
+    }
     // Setup style
     setupStyle();
     // Load translation
@@ -242,6 +249,7 @@ bool TApp::processArgName(const QString& name, QStringList& args) const {
 }
 
 TApp::TExitCode TApp::processArgs() {
+    WZSTARTTRACE("TApp::processArgs");
 
     QStringList args = arguments();
 
@@ -278,7 +286,7 @@ TApp::TExitCode TApp::processArgs() {
         QString argument = args.at(n);
         QString name = getArgName(argument);
 
-        if (name == "loglevel") {
+        if (name == "loglevel" || name == "trace-startup") {
             // Already handled by main
             n++;
         } else if (name == "send-actions") {
@@ -413,8 +421,13 @@ void TApp::onMessageReceived(QString msg) {
 
 void TApp::createGUI() {
     WZTRACE("Creating main window");
+    WZSTARTTRACE("TApp::createGUI");
 
-    Gui::TMainWindowTray* mw = new Gui::TMainWindowTray();
+    Gui::TMainWindowTray* mw;
+    {
+        WZSTARTTRACE("TMainWindow construction");
+        mw = new Gui::TMainWindowTray();
+    }
 
     connect(this, &TApp::messageReceived,
             this, &TApp::onMessageReceived);
@@ -425,7 +438,10 @@ void TApp::createGUI() {
             this, &TApp::onRequestRestart);
 
     WZTRACE("Loading settings main window");
-    mw->loadSettings();
+    {
+        WZSTARTTRACE("TMainWindow::loadSettings");
+        mw->loadSettings();
+    }
 
     mw->setForceCloseOnFinish(close_at_end);
     if (move_gui) {
@@ -487,6 +503,7 @@ void TApp::start() {
         if (!media_title.isEmpty()) {
             player->addForcedTitle(files_to_play[0], media_title);
         }
+        TStartTrace::begin("Playlist restore");
         mw->getPlaylist()->openFiles(files_to_play, current_file);
     }
 
@@ -0,0 +1,278 @@
+// Replays transcripts recorded by TProcess through the player parsers and
+// reports lines per second, allocations per line and the emitted signals.
+
+#include "player/process/mpvprocess.h"
+#include "player/process/mplayerprocess.h"
+#include "settings/paths.h"
+#include "settings/preferences.h"
+#include "mediadata.h"
+
+#include "log4qt/logmanager.h"
+#include "log4qt/level.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+
+
+// Count allocations by interposing malloc. Only available for glibc.
+static std::atomic<quint64> allocations(0);
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_calloc(size_t n, size_t size);
+
+void* malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void* calloc(size_t n, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+} // extern "C"
+#endif
+
+// Size of the chunks fed to the parser, similar to what QProcess delivers
+const int CHUNK_SIZE = 4096;
+
+using namespace Player::Process;
+
+
+// Process only splitting lines, to measure the framing on its own
+class TNullProcess : public TProcess {
+public:
+    TNullProcess() : TProcess(0, "null"), lines(0) {}
+    int lines;
+protected:
+    virtual bool parseLine(QString&) override {
+        lines++;
+        return true;
+    }
+};
+
+// Framing as done by TProcess before it reused its buffers
+static int legacyFraming(const QByteArray& transcript) {
+
+    int lines = 0;
+    QByteArray remaining_output;
+    for (int i = 0; i < transcript.size(); i += CHUNK_SIZE) {
+        remaining_output += transcript.mid(i, CHUNK_SIZE);
+
+        const char* start = remaining_output.constData();
+        const char* end = start + remaining_output.size();
+        const char* pos = start;
+        while (pos < end && *pos != '\r' && *pos != '\n') {
+            pos++;
+        }
+        while (pos < end) {
+            if (pos > start) {
+                QString line = QString::fromLocal8Bit(start, pos - start);
+                Q_UNUSED(line)
+                lines++;
+            }
+            start = pos + 1;
+            pos = start;
+            while (pos < end && *pos != '\r' && *pos != '\n') {
+                pos++;
+            }
+        }
+        remaining_output = remaining_output.mid(
+            start - remaining_output.constData());
+    }
+    return lines;
+}
+
+static void report(QTextStream& out, const QString& name, int lines,
+                   qint64 bytes, qint64 ns, quint64 allocs) {
+
+    double secs = double(ns) / 1000000000;
+    out << QString("  %1: %2 lines in %3 ms, %4 lines/sec, %5 MB/sec, "
+                   "%6 allocations/line")
+           .arg(name, -10)
+           .arg(lines)
+           .arg(double(ns) / 1000000, 0, 'f', 1)
+           .arg(secs > 0 ? lines / secs : 0, 0, 'f', 0)
+           .arg(secs > 0 ? bytes / secs / 1048576 : 0, 0, 'f', 1)
+           .arg(lines > 0 ? double(allocs) / lines : 0, 0, 'f', 2)
+        << endl;
+}
+
+// Returns the number of lines in transcript
+static int benchFraming(QTextStream& out, const QByteArray& transcript,
+                        int repeat) {
+
+    QElapsedTimer timer;
+    int lines = 0;
+    quint64 allocs = allocations;
+    timer.start();
+    for (int r = 0; r < repeat; r++) {
+        lines += legacyFraming(transcript);
+    }
+    report(out, "legacy", lines, qint64(transcript.size()) * repeat,
+           timer.nsecsElapsed(), allocations - allocs);
+
+    TNullProcess proc;
+    allocs = allocations;
+    timer.start();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < transcript.size(); i += CHUNK_SIZE) {
+            proc.replay(transcript.constData() + i,
+                        qMin(CHUNK_SIZE, transcript.size() - i));
+        }
+    }
+    report(out, "framing", proc.lines, qint64(transcript.size()) * repeat,
+           timer.nsecsElapsed(), allocations - allocs);
+
+    return proc.lines / repeat;
+}
+
+#define COUNT_SIGNAL(signal) \
+    QObject::connect(proc, &TPlayerProcess::signal, \
+                     [&counts]() { counts[#signal]++; })
+
+static void benchParser(QTextStream& out, const QByteArray& transcript,
+                        int lines, bool mplayer, int repeat) {
+
+    QMap<QString, int> counts;
+    qint64 ns = 0;
+    quint64 allocs = 0;
+
+    for (int r = 0; r < repeat; r++) {
+        TMediaData md;
+        TPlayerProcess* proc;
+        if (mplayer) {
+            proc = new TMPlayerProcess(0, "bench", &md);
+        } else {
+            proc = new TMPVProcess(0, "bench", &md);
+        }
+
+        COUNT_SIGNAL(playingStarted);
+        COUNT_SIGNAL(receivedVideoOut);
+        COUNT_SIGNAL(durationChanged);
+        COUNT_SIGNAL(receivedPositionMS);
+        COUNT_SIGNAL(receivedPause);
+        COUNT_SIGNAL(receivedMessage);
+        COUNT_SIGNAL(receivedBuffering);
+        COUNT_SIGNAL(receivedBufferingEnded);
+        COUNT_SIGNAL(receivedScreenshot);
+        COUNT_SIGNAL(receivedUpdatingFontCache);
+        COUNT_SIGNAL(receivedStreamTitle);
+        COUNT_SIGNAL(receivedVideoTracks);
+        COUNT_SIGNAL(receivedVideoTrackChanged);
+        COUNT_SIGNAL(receivedAudioTracks);
+        COUNT_SIGNAL(receivedAudioTrackChanged);
+        COUNT_SIGNAL(receivedSubtitleTracks);
+        COUNT_SIGNAL(receivedSubtitleTrackChanged);
+        COUNT_SIGNAL(receivedTitleTracks);
+        COUNT_SIGNAL(receivedTitleTrackChanged);
+        COUNT_SIGNAL(receivedChapters);
+        COUNT_SIGNAL(receivedAngles);
+        COUNT_SIGNAL(videoBitRateChanged);
+        COUNT_SIGNAL(audioBitRateChanged);
+
+        QElapsedTimer timer;
+        quint64 a = allocations;
+        timer.start();
+        for (int i = 0; i < transcript.size(); i += CHUNK_SIZE) {
+            proc->replay(transcript.constData() + i,
+                         qMin(CHUNK_SIZE, transcript.size() - i));
+        }
+        ns += timer.nsecsElapsed();
+        allocs += allocations - a;
+
+        delete proc;
+    }
+
+    report(out, mplayer ? "mplayer" : "mpv", lines * repeat,
+           qint64(transcript.size()) * repeat, ns, allocs);
+
+    QMapIterator<QString, int> i(counts);
+    while (i.hasNext()) {
+        i.next();
+        out << QString("    %1 %2").arg(i.key(), -30).arg(i.value()) << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    // Keep the log out of the measurements
+    Log4Qt::LogManager::rootLogger()->setLevel(Log4Qt::Level::OFF_INT);
+    Log4Qt::LogManager::qtLogger()->setLevel(Log4Qt::Level::OFF_INT);
+
+    QStringList files;
+    int force = 0;
+    int repeat = 1;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); i++) {
+        QString arg = args.at(i);
+        if (arg == "--mpv") {
+            force = 1;
+        } else if (arg == "--mplayer") {
+            force = 2;
+        } else if (arg == "--repeat" && i + 1 < args.count()) {
+            i++;
+            repeat = qMax(1, args.at(i).toInt());
+        } else {
+            files << arg;
+        }
+    }
+
+    if (files.isEmpty()) {
+        out << "Usage: parserbench [--mpv|--mplayer] [--repeat n]"
+               " transcript..." << endl;
+        return 1;
+    }
+
+    Settings::TPaths::setConfigPath(false);
+    Settings::pref = new Settings::TPreferences();
+
+    for (int i = 0; i < files.count(); i++) {
+        QFile file(files.at(i));
+        if (!file.open(QIODevice::ReadOnly)) {
+            out << "Failed to open " << file.fileName() << ": "
+                << file.errorString() << endl;
+            return 1;
+        }
+        QByteArray transcript = file.readAll();
+
+        // Transcripts are named after the player that recorded them
+        bool mplayer = force == 2
+            || (force == 0
+                && QFileInfo(file).fileName().startsWith("mplayer"));
+        Settings::pref->player_id = mplayer
+                                    ? Settings::TPreferences::ID_MPLAYER
+                                    : Settings::TPreferences::ID_MPV;
+
+        out << file.fileName() << ": " << transcript.size() << " bytes"
+            << endl;
+        int lines = benchFraming(out, transcript, repeat);
+        benchParser(out, transcript, lines, mplayer, repeat);
+    }
+
+#ifndef __GLIBC__
+    out << "Allocations are only counted when using glibc" << endl;
+#endif
+
+    delete Settings::pref;
+    Settings::pref = 0;
+    return 0;
+}
@@ -91,6 +91,7 @@ QString CLHelp::help(bool html) {
 
     QString options = QString("%1 [--help]"
                               " [--loglevel warn|info|debug|trace]"
+                              " [--trace-startup %3]"
 #ifdef Q_OS_WIN
                               " [--uninstall]"
 #endif
@@ -128,6 +129,11 @@ QString CLHelp::help(bool html) {
         " the console. Without --loglevel messages will not be logged to the"
         " console."), html);
 
+    s += formatHelp("--trace-startup", QObject::tr(
+        "Records the duration of the start-up phases until the first media"
+        " started playing and saves them in the Chrome trace format to the"
+        " given file. Open it with chrome://tracing or Perfetto."), html);
+
 #ifdef Q_OS_WIN
     s += formatHelp("--uninstall", QObject::tr(
         "Restores the old associations and cleans up the registry."), html);
@@ -126,11 +126,11 @@ TActionsEditor::TActionsEditor(QWidget* parent) :
 
     saveButton = new QPushButton(this);
     saveButton->setText(tr("Save"));
-    saveButton->setIcon(iconProvider.saveIcon);
+    saveButton->setIcon(iconProvider.saveIcon());
 
     loadButton = new QPushButton(this);
     loadButton->setText(tr("Load"));
-    loadButton->setIcon(iconProvider.openIcon);
+    loadButton->setIcon(iconProvider.openIcon());
 
     connect(saveButton, &QPushButton::clicked,
             this, &TActionsEditor::saveActionsTable);
@@ -425,7 +425,7 @@ bool TActionsEditor::updateConflictCell(int row,
                     conflict = true;
                     QTableWidgetItem* item = actionsTable->item(
                                 conflictRow, COL_CONFLICTS);
-                    item->setIcon(iconProvider.conflictItem);
+                    item->setIcon(iconProvider.conflictItem());
                 }
                 // Find next conflict
                 startRow = conflictRow + 1;
@@ -435,7 +435,7 @@ bool TActionsEditor::updateConflictCell(int row,
     }
 
     if (conflict) {
-        conflictItem->setIcon(iconProvider.conflictItem);
+        conflictItem->setIcon(iconProvider.conflictItem());
     } else {
         conflictItem->setIcon(QPixmap());
     }
@@ -3,6 +3,8 @@
 #include "settings/mediasettings.h"
 #include "images.h"
 
+#include <QElapsedTimer>
+
 
 namespace Gui {
 namespace Action {
@@ -12,7 +14,8 @@ TMenu::TMenu(QWidget* parent,
              const QString& name,
              const QString& text,
              const QString& icon) :
-    QMenu(parent) {
+    QMenu(parent),
+    populated(false) {
 
     menuAction()->setObjectName(name);
     menuAction()->setText(text);
@@ -21,6 +24,23 @@ TMenu::TMenu(QWidget* parent,
     if (iconName != "noicon") {
         menuAction()->setIcon(Images::icon(iconName));
     }
+
+    // Connected before descendants connect to aboutToShow, so populate()
+    // runs before their handlers
+    connect(this, &TMenu::aboutToShow, this, &TMenu::onAboutToShow);
+}
+
+void TMenu::onAboutToShow() {
+
+    if (!populated) {
+        populated = true;
+        QElapsedTimer timer;
+        timer.start();
+        populate();
+        WZTRACE(QString("Populated menu '%1' with %2 actions in %3 ms")
+                .arg(menuAction()->objectName()).arg(actions().count())
+                .arg(timer.elapsed()));
+    }
 }
 
 void TMenu::execSlot() {
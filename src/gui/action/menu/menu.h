@@ -2,6 +2,7 @@
 #define GUI_ACTION_MENU_MENU_H
 
 #include <QMenu>
+#include "wzdebug.h"
 
 
 namespace Gui {
@@ -10,6 +11,7 @@ namespace Menu {
 
 class TMenu : public QMenu {
     Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
 public:
     explicit TMenu(QWidget* parent,
                    const QString& name = "",
@@ -17,6 +19,18 @@ public:
                    const QString& icon = "");
 public slots:
     void execSlot();
+
+protected:
+    // Add the actions of the menu. Called just before the menu is shown for
+    // the first time, to not spend time on menus never opened while
+    // constructing the main window.
+    virtual void populate() {}
+
+private:
+    bool populated;
+
+private slots:
+    void onAboutToShow();
 };
 
 } // namespace Menu
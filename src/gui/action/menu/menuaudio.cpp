@@ -37,11 +37,19 @@ TAudioChannelGroup::TAudioChannelGroup(TMainWindow* mw)
 class TMenuAudioChannel : public TMenu {
 public:
     explicit TMenuAudioChannel(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuAudioChannel::TMenuAudioChannel(QWidget* parent, TMainWindow* mw)
     : TMenu(parent, "audio_channels_menu", tr("Audio channels"),
-            "audio_channels") {
+            "audio_channels"),
+    mw(mw) {
+}
+
+void TMenuAudioChannel::populate() {
 
     addActions(mw->findChild<TAudioChannelGroup*>("audio_channel_group")
                ->actions());
@@ -71,10 +79,18 @@ TStereoGroup::TStereoGroup(TMainWindow* mw)
 class TMenuStereo : public TMenu {
 public:
     explicit TMenuStereo(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuStereo::TMenuStereo(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "stereo_mode_menu", tr("Stereo mode")) {
+    : TMenu(parent, "stereo_mode_menu", tr("Stereo mode")),
+    mw(mw) {
+}
+
+void TMenuStereo::populate() {
 
     addActions(mw->findChild<TStereoGroup*>("stereo_group")->actions());
 }
@@ -42,7 +42,7 @@ TMenuFile::TMenuFile(QWidget* parent, TMainWindow* mw, TMenu* favMenu) :
     // Recents
     recentFilesMenu = new TMenu(this, "recent_menu", tr("Recent files"),
                                 "noicon");
-    recentFilesMenu->menuAction()->setIcon(iconProvider.recentIcon);
+    recentFilesMenu->menuAction()->setIcon(iconProvider.recentIcon());
     updateRecents();
     addMenu(recentFilesMenu);
     connect(pref, &TPreferences::recentsChanged,
@@ -28,10 +28,18 @@ TClosedCaptionsGroup::TClosedCaptionsGroup(TMainWindow* mw)
 class TMenuCC : public TMenu {
 public:
     explicit TMenuCC(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuCC::TMenuCC(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "closed_captions_menu", tr("Closed captions")) {
+    : TMenu(parent, "closed_captions_menu", tr("Closed captions")),
+    mw(mw) {
+}
+
+void TMenuCC::populate() {
 
     addActions(mw->findChild<TClosedCaptionsGroup*>()->actions());
 }
@@ -61,10 +69,18 @@ TSubFPSGroup::TSubFPSGroup(TMainWindow* mw)
 class TMenuSubFPS : public TMenu {
 public:
     explicit TMenuSubFPS(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuSubFPS::TMenuSubFPS(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "subfps_menu", tr("FPS external subs")) {
+    : TMenu(parent, "subfps_menu", tr("FPS external subs")),
+    mw(mw) {
+}
+
+void TMenuSubFPS::populate() {
 
     addActions(mw->findChild<TSubFPSGroup*>()->actions());
 }
@@ -98,21 +98,25 @@ void TAspectGroup::onPlayerStateChanged() {
 }
 
 TMenuAspect::TMenuAspect(QWidget* parent, TMainWindow* mw) :
-    TMenu(parent, "aspect_menu", tr("Aspect ratio")) {
+    TMenu(parent, "aspect_menu", tr("Aspect ratio")),
+    mw(mw) {
 
     TAspectGroup* group = mw->findChild<TAspectGroup*>();
-    addActions(group->actions());
-    insertSeparator(mw->requireAction("aspect_1_1"));
-    insertSeparator(mw->requireAction("aspect_none"));
-    addSeparator();
-    addAction(mw->requireAction("aspect_next"));
-
     connect(group, &TAspectGroup::setAspectToolTip,
             this, &TMenuAspect::setAspectToolTip);
     connect(this, &TMenuAspect::aboutToShow,
             group, &TAspectGroup::update);
 }
 
+void TMenuAspect::populate() {
+
+    addActions(mw->findChild<TAspectGroup*>()->actions());
+    insertSeparator(mw->requireAction("aspect_1_1"));
+    insertSeparator(mw->requireAction("aspect_none"));
+    addSeparator();
+    addAction(mw->requireAction("aspect_next"));
+}
+
 void TMenuAspect::setAspectToolTip(QString tip) {
 
     QString s = menuAction()->shortcut().toString();
@@ -145,11 +149,19 @@ TDeinterlaceGroup::TDeinterlaceGroup(TMainWindow* mw)
 class TMenuDeinterlace : public TMenu {
 public:
     explicit TMenuDeinterlace(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 
 TMenuDeinterlace::TMenuDeinterlace(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "deinterlace_menu", tr("Deinterlace"), "deinterlace") {
+    : TMenu(parent, "deinterlace_menu", tr("Deinterlace"), "deinterlace"),
+    mw(mw) {
+}
+
+void TMenuDeinterlace::populate() {
 
     TDeinterlaceGroup* group = mw->findChild<TDeinterlaceGroup*>(
                 "deinterlace_group");
@@ -172,20 +184,28 @@ TRotateGroup::TRotateGroup(TMainWindow* mw) :
 class TMenuTransform : public TMenu {
 public:
     explicit TMenuTransform(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 
 TMenuTransform::TMenuTransform(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "transform_menu", tr("Transform"), "transform") {
+    : TMenu(parent, "transform_menu", tr("Transform"), "transform"),
+    mw(mw) {
+
+    connect(this, &TMenuTransform::aboutToShow,
+            mw, &TMainWindow::updateTransformMenu);
+}
+
+void TMenuTransform::populate() {
 
     addAction(mw->requireAction("flip"));
     addAction(mw->requireAction("mirror"));
     addSeparator();
     TRotateGroup* group = mw->findChild<TRotateGroup*>("rotate_group");
     addActions(group->actions());
-
-    connect(this, &TMenuTransform::aboutToShow,
-            mw, &TMainWindow::updateTransformMenu);
 }
 
 
@@ -199,19 +219,19 @@ TZoomAndPanGroup::TZoomAndPanGroup(TMainWindow* mw)
     // Reset zoom
     TAction* a = new TAction(mw, "reset_zoom_pan", tr("Reset zoom and pan"),
                              "noicon", Qt::Key_5);
-    a->setIcon(iconProvider.zoomResetIcon);
+    a->setIcon(iconProvider.zoomResetIcon());
     connect(a, &TAction::triggered, player, &Player::TPlayer::resetZoomAndPan);
     addAction(a);
 
     // Zoom in
     a = new TAction(mw, "inc_zoom", tr("Zoom in"), "noicon", Qt::Key_9);
-    a->setIcon(iconProvider.zoomInIcon);
+    a->setIcon(iconProvider.zoomInIcon());
     connect(a, &TAction::triggered, player, &Player::TPlayer::incZoom);
     addAction(a);
 
     // Zoom out
     a = new TAction(mw, "dec_zoom", tr("Zoom out"), "noicon", Qt::Key_1);
-    a->setIcon(iconProvider.zoomOutIcon);
+    a->setIcon(iconProvider.zoomOutIcon());
     connect(a, &TAction::triggered, player, &Player::TPlayer::decZoom);
     addAction(a);
 
@@ -238,10 +258,18 @@ TZoomAndPanGroup::TZoomAndPanGroup(TMainWindow* mw)
 class TMenuZoomAndPan : public TMenu {
 public:
     explicit TMenuZoomAndPan(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuZoomAndPan::TMenuZoomAndPan(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "zoom_and_pan_menu", tr("Zoom and pan")) {
+    : TMenu(parent, "zoom_and_pan_menu", tr("Zoom and pan")),
+    mw(mw) {
+}
+
+void TMenuZoomAndPan::populate() {
 
     TZoomAndPanGroup* group = mw->findChild<TZoomAndPanGroup*>(
                 "zoom_and_pan_group");
@@ -39,6 +39,10 @@ class TMenuAspect : public TMenu {
     Q_OBJECT
 public:
     explicit TMenuAspect(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 private slots:
     void setAspectToolTip(QString tip);
 };
@@ -55,7 +55,11 @@ TColorSpaceGroup::TColorSpaceGroup(TMainWindow* mw) :
 }
 
 TMenuVideoColorSpace::TMenuVideoColorSpace(QWidget* parent, TMainWindow* mw) :
-    TMenu(parent, "colorspace_menu", tr("Color space")) {
+    TMenu(parent, "colorspace_menu", tr("Color space")),
+    mw(mw) {
+}
+
+void TMenuVideoColorSpace::populate() {
 
     TColorSpaceGroup* group = mw->findChild<TColorSpaceGroup*>("colorspace");
     addActions(group->actions());
@@ -21,6 +21,10 @@ class TMenuVideoColorSpace : public TMenu {
     Q_OBJECT
 public:
     TMenuVideoColorSpace(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 }; // class TMenuVideoColorSpace
 
 } // namespace Menu
@@ -77,7 +77,13 @@ void TFilterGroup::updateFilters() {
 
 
 TMenuVideoFilter::TMenuVideoFilter(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "videofilter_menu", tr("Video filters"), "video_filters") {
+    : TMenu(parent, "videofilter_menu", tr("Video filters"), "video_filters"),
+    mw(mw) {
+
+    connect(this, &TMenu::aboutToShow, mw, &TMainWindow::updateFilters);
+}
+
+void TMenuVideoFilter::populate() {
 
     QActionGroup* group = mw->findChild<TFilterGroup*>("filter_group");
     addActions(group->actions());
@@ -95,8 +101,6 @@ TMenuVideoFilter::TMenuVideoFilter(QWidget* parent, TMainWindow* mw)
     menu->addActions(group->actions());
     addMenu(menu);
     connect(menu, &TMenu::aboutToShow, mw, &TMainWindow::updateFilters);
-
-    connect(this, &TMenu::aboutToShow, mw, &TMainWindow::updateFilters);
 }
 
 } // namespace Menu
@@ -37,6 +37,10 @@ private:
 class TMenuVideoFilter : public TMenu {
 public:
     explicit TMenuVideoFilter(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 } // namespace Menu
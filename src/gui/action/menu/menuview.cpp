@@ -35,10 +35,18 @@ TOSDGroup::TOSDGroup(TMainWindow *mw) :
 class TMenuOSD : public TMenu {
 public:
     explicit TMenuOSD(QWidget* parent, TMainWindow* mw);
+protected:
+    virtual void populate() override;
+private:
+    TMainWindow* mw;
 };
 
 TMenuOSD::TMenuOSD(QWidget* parent, TMainWindow* mw)
-    : TMenu(parent, "osd_menu", tr("OSD"), "osd") {
+    : TMenu(parent, "osd_menu", tr("OSD"), "osd"),
+    mw(mw) {
+}
+
+void TMenuOSD::populate() {
 
     addAction(mw->requireAction("osd_next"));
 
@@ -99,7 +99,7 @@ void TWindowSizeGroup::update() {
 TMenuWindowSize::TMenuWindowSize(QWidget* parent, TMainWindow* mw) :
     TMenu(parent, "window_size_menu", tr("Window size"), "noicon") {
 
-    menuAction()->setIcon(iconProvider.windowSizeIcon);
+    menuAction()->setIcon(iconProvider.windowSizeIcon());
 
     TWindowSizeGroup* group = mw->findChild<TWindowSizeGroup*>();
     addActions(group->actions());
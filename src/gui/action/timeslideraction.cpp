@@ -5,10 +5,12 @@
 #include "gui/playerwindow.h"
 #include "settings/preferences.h"
 #include "player/player.h"
+#include "player/thumbnailindex.h"
 #include "wztime.h"
 #include "wztimer.h"
 
 #include <QApplication>
+#include <QLabel>
 #include <QToolTip>
 
 
@@ -23,8 +25,10 @@ TTimeSliderAction::TTimeSliderAction(TMainWindow* mw, Player::TPlayer* player) :
     posMS(0),
     durationMS(0),
     requestedPosMS(0),
+    dragging(false),
     previewPlayer(player->previewPlayer),
-    lastPreviewPosMS(NO_POS_MS) {
+    lastPreviewPosMS(NO_POS_MS),
+    thumbnails(player->thumbnails) {
 
     setObjectName("timeslider_action");
     setText(tr("Time slider"));
@@ -38,6 +42,10 @@ TTimeSliderAction::TTimeSliderAction(TMainWindow* mw, Player::TPlayer* player) :
             player, &Player::TPlayer::seekMS);
     connect(this, &TTimeSliderAction::percentageChanged,
             player, &Player::TPlayer::seekPercentage);
+    connect(this, &TTimeSliderAction::draggingPositionMSChanged,
+            player, &Player::TPlayer::seekKeyFrameMS);
+    connect(this, &TTimeSliderAction::draggingPercentageChanged,
+            player, &Player::TPlayer::seekKeyFramePercentage);
 
     connect(this, &TTimeSliderAction::wheelUp,
             mw, &TMainWindow::wheelUpSeeking);
@@ -55,6 +63,11 @@ TTimeSliderAction::TTimeSliderAction(TMainWindow* mw, Player::TPlayer* player) :
     previewTimer->setInterval(Settings::pref->seek_rate);
     connect(previewTimer, &TWZTimer::timeout,
             this, &TTimeSliderAction::onPreviewTimerTimeout);
+
+    // Shows indexed thumbnails at the same place as the preview player
+    thumbnailLabel = new QLabel(previewPlayer->playerWindow->parentWidget());
+    thumbnailLabel->setFrameShape(QFrame::Box);
+    thumbnailLabel->hide();
 }
 
 QWidget* TTimeSliderAction::createWidget(QWidget* parent) {
@@ -65,7 +78,7 @@ QWidget* TTimeSliderAction::createWidget(QWidget* parent) {
     connect(slider, &TTimeSlider::posMSChanged,
             this, &TTimeSliderAction::onPosMSChanged);
     connect(slider, &TTimeSlider::draggingPosMSChanged,
-            this, &TTimeSliderAction::onPosMSChanged);
+            this, &TTimeSliderAction::onDraggingPosMSChanged);
 
     connect(slider, &TTimeSlider::wheelUp,
             this, &TTimeSliderAction::wheelUp);
@@ -128,17 +141,38 @@ void TTimeSliderAction::setDurationMS(int ms) {
 void TTimeSliderAction::onUpdatePosTimerTimeout() {
 
     if (qAbs(requestedPosMS - posMS) > POS_RES_MS) {
-        if (Settings::pref->seek_relative) {
-            emit percentageChanged(double(requestedPosMS * 100) / durationMS);
+        double percentage = double(requestedPosMS * 100) / durationMS;
+        if (dragging) {
+            if (Settings::pref->seek_relative) {
+                emit draggingPercentageChanged(percentage);
+            } else {
+                emit draggingPositionMSChanged(requestedPosMS);
+            }
+        } else if (Settings::pref->seek_relative) {
+            emit percentageChanged(percentage);
         } else {
             emit positionMSChanged(requestedPosMS);
         }
     }
 }
 
-// Slider pos changed
+// Slider pos changed while dragging
+void TTimeSliderAction::onDraggingPosMSChanged(int ms) {
+
+    dragging = true;
+    requestedPosMS = ms;
+    if (durationMS <= 0) {
+        WZWARN(QString("Ignoring posChanged() while duration %1 <= 0")
+               .arg(durationMS));
+    } else if (!updatePosTimer->isActive()) {
+        updatePosTimer->start();
+    }
+}
+
+// Slider pos changed or slider released, seek the exact position
 void TTimeSliderAction::onPosMSChanged(int ms) {
 
+    dragging = false;
     requestedPosMS = ms;
     if (durationMS <= 0) {
         WZWARN(QString("Ignoring posChanged() while duration %1 <= 0")
@@ -148,52 +182,67 @@ void TTimeSliderAction::onPosMSChanged(int ms) {
     }
 }
 
-void TTimeSliderAction::preview() {
+// Move preview widget w next to the slider at global pos
+void TTimeSliderAction::movePreview(QWidget* w, QPoint pos) {
 
-    TPlayerWindow* playerWindow = previewPlayer->playerWindow;
-    QPoint pos = QCursor::pos();
-    int ms = previewSlider->getTimeMS(previewSlider->mapFromGlobal(pos));
-    if (qAbs(ms - lastPreviewPosMS) > POS_RES_MS) {
-        // 10 ms -> resolution 100 fps
-        lastPreviewPosMS = ms;
+    // Map geometry parent widget slider to global
+    QWidget* parentWidget = previewSlider->parentWidget();
+    QRect r = parentWidget->frameGeometry();
+    if (parentWidget->parentWidget()) {
+        r.moveTo(parentWidget->parentWidget()->mapToGlobal(r.topLeft()));
+    }
 
-        // Map geometry parent widget slider to global
-        QWidget* parentWidget = previewSlider->parentWidget();
-        QRect r = parentWidget->frameGeometry();
-        if (parentWidget->parentWidget()) {
-            r.moveTo(parentWidget->parentWidget()->mapToGlobal(r.topLeft()));
+    // Map to local parent of preview widget
+    parentWidget = w->parentWidget();
+    r.moveTo(parentWidget->mapFromGlobal(r.topLeft()));
+    pos = parentWidget->mapFromGlobal(pos);
+
+    // Set pos
+    const int d = 6;
+    if (previewSlider->orientation() == Qt::Horizontal) {
+        pos.rx() = pos.x() - w->width() / 2;
+        if (pos.y() > parentWidget->height() / 2) {
+            pos.ry() = r.top() - w->height() - d;
+        } else {
+            pos.ry() = r.top() + r.height() + d;
         }
-
-        // Map to local parent player window
-        parentWidget = playerWindow->parentWidget();
-        r.moveTo(parentWidget->mapFromGlobal(r.topLeft()));
-        pos = parentWidget->mapFromGlobal(pos);
-
-        // Set pos
-        const int d = 6;
-        if (previewSlider->orientation() == Qt::Horizontal) {
-            pos.rx() = pos.x() - playerWindow->width() / 2;
-            if (pos.y() > parentWidget->height() / 2) {
-                pos.ry() = r.top() - playerWindow->height() - d;
-            } else {
-                pos.ry() = r.top() + r.height() + d;
-            }
+    } else {
+        pos.ry() = pos.y() - w->height() / 2;
+        if (pos.x() > parentWidget->width() / 2) {
+            pos.rx() = r.x() - w->width() - d;
         } else {
-            pos.ry() = pos.y() - playerWindow->height() / 2;
-            if (pos.x() > parentWidget->width() / 2) {
-                pos.rx() = r.x() - playerWindow->width() - d;
-            } else {
-                pos.rx() = r.x() + r.width() + d;
-            }
+            pos.rx() = r.x() + r.width() + d;
         }
+    }
 
-        // Move player window
-        playerWindow->move(pos);
-        // Show player window
-        if (!playerWindow->isVisible()) {
-            playerWindow->setVisible(true);
-            playerWindow->raise();
+    w->move(pos);
+    if (!w->isVisible()) {
+        w->setVisible(true);
+        w->raise();
+    }
+}
+
+void TTimeSliderAction::preview() {
+
+    TPlayerWindow* playerWindow = previewPlayer->playerWindow;
+    QPoint pos = QCursor::pos();
+    int ms = previewSlider->getTimeMS(previewSlider->mapFromGlobal(pos));
+    if (thumbnails->isReady()) {
+        // Indexed thumbnail, no need to seek the preview player
+        if (playerWindow->isVisible()) {
+            playerWindow->hide();
+        }
+        if (qAbs(ms - lastPreviewPosMS) > POS_RES_MS
+            || !thumbnailLabel->isVisible()) {
+            lastPreviewPosMS = ms;
+            thumbnailLabel->setPixmap(thumbnails->thumbnail(ms));
+            thumbnailLabel->adjustSize();
+            movePreview(thumbnailLabel, pos);
         }
+    } else if (qAbs(ms - lastPreviewPosMS) > POS_RES_MS) {
+        // 10 ms -> resolution 100 fps
+        lastPreviewPosMS = ms;
+        movePreview(playerWindow, pos);
 
         // Seek requested time
         previewPlayer->pause();
@@ -206,12 +255,18 @@ void TTimeSliderAction::preview() {
     previewTimer->start();
 }
 
+void TTimeSliderAction::hidePreview() {
+
+    previewPlayer->playerWindow->hide();
+    thumbnailLabel->hide();
+}
+
 void TTimeSliderAction::onPreviewTimerTimeout() {
 
     if (previewSlider->underMouse() && !QApplication::mouseButtons()) {
         preview();
     } else {
-        previewPlayer->playerWindow->hide();
+        hidePreview();
     }
 }
 
@@ -219,7 +274,8 @@ void TTimeSliderAction::onToolTipEvent(TTimeSlider* slider,
                                        QPoint pos,
                                        int ms) {
 
-    if (previewPlayer->statePOP() && durationMS > 0) {
+    if (durationMS > 0
+        && (thumbnails->isReady() || previewPlayer->statePOP())) {
         previewSlider = slider;
         if (!previewTimer->isActive()) {
             previewTimer->start();
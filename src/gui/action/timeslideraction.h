@@ -6,9 +6,11 @@
 
 
 class TWZTimer;
+class QLabel;
 
 namespace Player {
 class TPlayer;
+class TThumbnailIndex;
 }
 
 namespace Gui {
@@ -28,6 +30,9 @@ public:
 signals:
     void positionMSChanged(int ms);
     void percentageChanged(double percentage);
+    // Key frame seeks while dragging
+    void draggingPositionMSChanged(int ms);
+    void draggingPercentageChanged(double percentage);
 
     void wheelUp();
     void wheelDown();
@@ -40,20 +45,26 @@ private:
     int posMS;
     int durationMS;
     int requestedPosMS;
+    bool dragging;
 
     Player::TPlayer* previewPlayer;
     TWZTimer* previewTimer;
     TTimeSlider* previewSlider;
     int lastPreviewPosMS;
+    Player::TThumbnailIndex* thumbnails;
+    QLabel* thumbnailLabel;
 
     void setPosMS(int ms);
+    void movePreview(QWidget* w, QPoint pos);
     void preview();
+    void hidePreview();
 
 private slots:
     void setPositionMS(int ms);
     void setDurationMS(int ms);
 
     void onPosMSChanged(int ms);
+    void onDraggingPosMSChanged(int ms);
     void onToolTipEvent(TTimeSlider* slider, QPoint pos, int ms);
 
     void onUpdatePosTimerTimeout();
@@ -93,5 +93,27 @@ TDeviceList TDeviceInfo::xvAdaptors() {
 
 #endif
 
+TDeviceInfoThread::TDeviceInfoThread(QObject* parent, TDeviceType type) :
+    QThread(parent),
+    deviceType(type) {
+}
+
+TDeviceInfoThread::~TDeviceInfoThread() {
+    wait();
+}
+
+void TDeviceInfoThread::run() {
+
+#ifndef Q_OS_WIN
+    if (deviceType == ALSA_DEVICES) {
+        devices = TDeviceInfo::alsaDevices();
+    } else {
+        devices = TDeviceInfo::xvAdaptors();
+    }
+#endif
+}
+
 } // namespace Gui
 
+#include "moc_deviceinfo.cpp"
+
@@ -22,6 +22,7 @@
 #include <QString>
 #include <QVariant>
 #include <QList>
+#include <QThread>
 
 namespace Gui {
 
@@ -57,6 +58,24 @@ public:
 
 };
 
+// Gets a device list in a separate thread, to not block the GUI while
+// waiting for aplay or xvinfo
+class TDeviceInfoThread : public QThread {
+    Q_OBJECT
+public:
+    enum TDeviceType { ALSA_DEVICES, XV_ADAPTORS };
+
+    explicit TDeviceInfoThread(QObject* parent, TDeviceType type);
+    virtual ~TDeviceInfoThread() override;
+
+    const TDeviceType deviceType;
+    // Valid when finished
+    TDeviceList devices;
+
+protected:
+    virtual void run() override;
+};
+
 } // namespace Gui
 
 #endif // GUI_DEVICEINFO_H
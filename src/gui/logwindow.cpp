@@ -60,7 +60,7 @@ TLogWindow::TLogWindow(QWidget* parent)
     pal.setColor(QPalette::WindowText, QColor(Qt::red));
     foundLabel->setPalette(pal);
 
-    saveButton->setIcon(iconProvider.saveIcon);
+    saveButton->setIcon(iconProvider.saveIcon());
     connect(saveButton, &QPushButton::clicked,
             this, &TLogWindow::onSaveButtonClicked);
 
@@ -74,6 +74,7 @@
 #include "version.h"
 #include "desktop.h"
 #include "iconprovider.h"
+#include "starttrace.h"
 
 #include <QMessageBox>
 #include <QDesktopWidget>
@@ -147,6 +148,9 @@ TMainWindow::TMainWindow() :
     connect(optimizeSizeTimer, &TWZTimer::timeout,
             this, &TMainWindow::optimizeSizeFactor);
 
+    // Get the player info in the background while building the GUI
+    Player::Info::TPlayerInfo::obj()->probe();
+
     createPlayerWindows();
     createPlayers();
     createLogDock();
@@ -237,6 +241,7 @@ void TMainWindow::createStatusBar() {
 }
 
 void TMainWindow::createPlayerWindows() {
+    WZSTARTTRACE("TMainWindow::createPlayerWindows");
 
     playerWindow = new TPlayerWindow(this, "player_window", false);
     setCentralWidget(playerWindow);
@@ -263,6 +268,7 @@ void TMainWindow::createPlayerWindows() {
 }
 
 void TMainWindow::createPlayers() {
+    WZSTARTTRACE("TMainWindow::createPlayers");
 
     Player::TPlayer* previewPlayer = new Player::TPlayer(this, "preview_player",
                                                          previewWindow, 0);
@@ -305,6 +311,7 @@ void TMainWindow::createPlayers() {
 }
 
 void TMainWindow::createLogDock() {
+    WZSTARTTRACE("TMainWindow::createLogDock");
 
     logDock = new TDockWidget(this, playerWindow, "log_dock", tr("Log"));
     logWindow = new TLogWindow(logDock);
@@ -313,6 +320,7 @@ void TMainWindow::createLogDock() {
 }
 
 void TMainWindow::createPlaylist() {
+    WZSTARTTRACE("TMainWindow::createPlaylist");
 
     // Setup meta type TPlaylistItem
     qRegisterMetaType<Playlist::TPlaylistItem>("Gui::Playlist::TPlaylistItem");
@@ -331,6 +339,7 @@ void TMainWindow::createPlaylist() {
 }
 
 void TMainWindow::createFavList() {
+    WZSTARTTRACE("TMainWindow::createFavList");
 
     favListDock = new TDockWidget(this, playerWindow, "favlist_dock",
                                   tr("Favorites"));
@@ -396,6 +405,7 @@ void TMainWindow::createAudioEqualizer() {
 }
 
 void TMainWindow::createActions() {
+    WZSTARTTRACE("TMainWindow::createActions");
 
     using namespace Action;
 
@@ -408,7 +418,7 @@ void TMainWindow::createActions() {
     // Open URL
     TAction* a = new TAction(this, "open_url", tr("Open URL..."), "noicon",
                              QKeySequence("Ctrl+U"));
-    a->setIcon(iconProvider.urlIcon);
+    a->setIcon(iconProvider.urlIcon());
     connect(a, &TAction::triggered, this, &TMainWindow::openURL);
 
     // Open file
@@ -469,12 +479,12 @@ void TMainWindow::createActions() {
     // Close
     // TMainWindowTray shows/hides close act
     closeAct = new TAction(this, "close", tr("Close"), "noicon");
-    closeAct->setIcon(iconProvider.closeIcon);
+    closeAct->setIcon(iconProvider.closeIcon());
     connect(closeAct, &TAction::triggered, this, &TMainWindow::closeWindow);
 
     quitAct = new Action::TAction(this, "quit", tr("Quit"), "noicon",
                                   QKeySequence("Ctrl+Q"));
-    quitAct->setIcon(iconProvider.quitIcon);
+    quitAct->setIcon(iconProvider.quitIcon());
     // TMainWindowTray connects quitAct
 
     // Play menu
@@ -598,14 +608,14 @@ void TMainWindow::createActions() {
     // Fullscreen
     fullscreenAct = new TAction(this, "fullscreen", tr("Fullscreen"), "noicon",
                                 Qt::Key_F);
-    fullscreenAct->setIcon(iconProvider.fullscreenIcon);
+    fullscreenAct->setIcon(iconProvider.fullscreenIcon());
     fullscreenAct->setCheckable(true);
     connect(fullscreenAct, &TAction::triggered,
             this, &TMainWindow::toggleFullscreen);
     // Exit fullscreen (not in menu)
     a = new TAction(this, "exit_fullscreen", tr("Exit fullscreen"), "noicon",
                     Qt::Key_Escape);
-    a->setIcon(iconProvider.fullscreenExitIcon);
+    a->setIcon(iconProvider.fullscreenExitIcon());
     connect(a, &TAction::triggered, this, &TMainWindow::exitFullscreen);
 
     // Aspect menu
@@ -621,7 +631,7 @@ void TMainWindow::createActions() {
 
     optimizeSizeAct = new TAction(this, "size_optimize", "", "noicon",
                                   QKeySequence("`"));
-    optimizeSizeAct->setIcon(iconProvider.optimizeSizeIcon);
+    optimizeSizeAct->setIcon(iconProvider.optimizeSizeIcon());
     connect(optimizeSizeAct, &TAction::triggered,
             this, &TMainWindow::optimizeSizeFactor);
     connect(playerWindow, &TPlayerWindow::videoSizeFactorChanged,
@@ -1232,6 +1242,7 @@ void TMainWindow::createActions() {
 } // createActions
 
 void TMainWindow::createMenus() {
+    WZSTARTTRACE("TMainWindow::createMenus");
 
     using namespace Action;
 
@@ -1370,6 +1381,7 @@ Action::Menu::TMenu* TMainWindow::createContextMenu(const QString& name,
 }
 
 void TMainWindow::createToolbars() {
+    WZSTARTTRACE("TMainWindow::createToolbars");
 
     menuBar()->setObjectName("menubar");
 
@@ -2489,10 +2501,10 @@ void TMainWindow::enablePlayPauseStop() {
 
     if (ps == Player::STATE_STOPPING) {
         playPauseAct->setTextAndTip(tr("Stopping player..."));
-        playPauseAct->setIcon(iconProvider.iconStopping);
+        playPauseAct->setIcon(iconProvider.iconStopping());
         playPauseAct->setEnabled(false);
         playPauseStopAct->setTextAndTip(tr("Stopping player..."));
-        playPauseStopAct->setIcon(iconProvider.iconStopping);
+        playPauseStopAct->setIcon(iconProvider.iconStopping());
         playPauseStopAct->setEnabled(false);
         //WZTRACE("Disabled in state stopping");
     } else if (ps == Player::STATE_PLAYING) {
@@ -2501,12 +2513,12 @@ void TMainWindow::enablePlayPauseStop() {
         playPauseStopAct->setTextAndTip(tr("Pause"));
         playPauseStopAct->setEnabled(true);
         if (playlist->isBusy() || favlist->isBusy()) {
-            playPauseAct->setIcon(iconProvider.iconLoading);
-            playPauseStopAct->setIcon(iconProvider.iconLoading);
+            playPauseAct->setIcon(iconProvider.iconLoading());
+            playPauseStopAct->setIcon(iconProvider.iconLoading());
             //WZTRACE("Enabled pause in state playing while busy");
         } else {
-            playPauseAct->setIcon(iconProvider.pauseIcon);
-            playPauseStopAct->setIcon(iconProvider.pauseIcon);
+            playPauseAct->setIcon(iconProvider.pauseIcon());
+            playPauseStopAct->setIcon(iconProvider.pauseIcon());
             //WZTRACE("Enabled pause in state playing");
         }
     } else if (ps == Player::STATE_PAUSED) {
@@ -2515,29 +2527,29 @@ void TMainWindow::enablePlayPauseStop() {
         playPauseStopAct->setTextAndTip(tr("Play"));
         playPauseStopAct->setEnabled(true);
         if (playlist->isBusy() || favlist->isBusy()) {
-            playPauseAct->setIcon(iconProvider.iconLoading);
-            playPauseStopAct->setIcon(iconProvider.iconLoading);
+            playPauseAct->setIcon(iconProvider.iconLoading());
+            playPauseStopAct->setIcon(iconProvider.iconLoading());
             //WZTRACE("Enabled play in state paused while busy");
         } else {
-            playPauseAct->setIcon(iconProvider.playIcon);
-            playPauseStopAct->setIcon(iconProvider.playIcon);
+            playPauseAct->setIcon(iconProvider.playIcon());
+            playPauseStopAct->setIcon(iconProvider.playIcon());
             //WZTRACE("Enabled play in state paused");
         }
     } else {
         QString s = player->stateToString().toLower();
         if (ps == Player::STATE_RESTARTING || ps == Player::STATE_LOADING) {
             playPauseAct->setTextAndTip(player->stateToString());
-            playPauseAct->setIcon(iconProvider.iconLoading);
+            playPauseAct->setIcon(iconProvider.iconLoading());
             playPauseAct->setEnabled(false);
             playPauseStopAct->setTextAndTip(tr("Stop %1").arg(s));
-            playPauseStopAct->setIcon(iconProvider.iconStopping);
+            playPauseStopAct->setIcon(iconProvider.iconStopping());
             playPauseStopAct->setEnabled(true);
             //WZTRACE("Enabled stop in state " + s);
         } else if (ps == Player::STATE_STOPPED) {
             playPauseAct->setTextAndTip(tr("Play"));
-            playPauseAct->setIcon(iconProvider.playIcon);
+            playPauseAct->setIcon(iconProvider.playIcon());
             playPauseStopAct->setTextAndTip(tr("Play"));
-            playPauseStopAct->setIcon(iconProvider.playIcon);
+            playPauseStopAct->setIcon(iconProvider.playIcon());
             bool e = !player->mdat.filename.isEmpty()
                     || playlist->hasPlayableItems();
             playPauseAct->setEnabled(e);
@@ -3089,8 +3101,8 @@ void TMainWindow::setFullscreen(bool b) {
 
     pref->fullscreen = b;
     fullscreenAct->setChecked(b);
-    fullscreenAct->setIcon(b ? iconProvider.fullscreenExitIcon
-                             : iconProvider.fullscreenIcon);
+    fullscreenAct->setIcon(b ? iconProvider.fullscreenExitIcon()
+                             : iconProvider.fullscreenIcon());
     emit fullscreenChanged();
 
     if (pref->fullscreen) {
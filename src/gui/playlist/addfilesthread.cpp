@@ -1,23 +1,38 @@
 #include "gui/playlist/addfilesthread.h"
 
 #include "gui/playlist/playlistitem.h"
+#include "gui/playlist/dirscanner.h"
 #include "settings/paths.h"
 #include "discname.h"
 #include "name.h"
 #include "extensions.h"
 #include "config.h"
+#include "starttrace.h"
 
 #include <QFileInfo>
 #include <QDir>
 #include <QUrl>
 #include <QRegExp>
-#include <QTextStream>
 #include <QTextCodec>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
 
 
 namespace Gui {
 namespace Playlist {
 
+// Maximum number of items and time to collect before publishing them
+const int BATCH_ITEMS = 1000;
+const int BATCH_MS = 100;
+
+// Number of playlist entries stat'ed ahead in parallel by openM3u(), in
+// tasks of STAT_TASK_ENTRIES entries, for playlists with at least
+// STAT_MIN_ENTRIES entries
+const int STAT_BATCH = 1000;
+const int STAT_TASK_ENTRIES = 50;
+const int STAT_MIN_ENTRIES = 100;
+
 class TFileLock {
 public:
     bool locked;
@@ -89,7 +104,12 @@ TAddFilesThread::TAddFilesThread(QObject *parent,
     stopRequested(false),
     recurse(recurseSubDirs),
     addImages(images),
-    isFavList(favList) {
+    isFavList(favList),
+    blacklistPatterns(nameBlacklist),
+    scanner(0),
+    entriesItemCount(0),
+    pendingItemCount(0),
+    flushed(false) {
 
     setObjectName(parent->objectName() + "_thread");
 
@@ -131,11 +151,154 @@ TAddFilesThread::TAddFilesThread(QObject *parent,
     WZDOBJ << "Searching for:" << nameFilterList;
 }
 
+void TAddFilesThread::setRefresh(const QString& dir,
+                                 const QSet<QString>& knownNames) {
+
+    refreshDir = dir;
+    refreshKnownNames = knownNames;
+}
+
+QString TAddFilesThread::nameKey(const QString& name) {
+
+    if (caseSensitiveFileNames == Qt::CaseInsensitive) {
+        return name.toLower();
+    }
+    return name;
+}
+
 TAddFilesThread::~TAddFilesThread() {
+
     delete root;
+    foreach(const TEntry& entry, entries + pendingEntries) {
+        delete entry.item;
+    }
+}
+
+QList<TAddFilesThread::TEntry> TAddFilesThread::takeEntries(int& itemCount) {
+
+    QMutexLocker locker(&entriesMutex);
+    QList<TEntry> result = entries;
+    entries.clear();
+    itemCount = entriesItemCount;
+    entriesItemCount = 0;
+    return result;
+}
+
+void TAddFilesThread::flush(bool force) {
+
+    if (pendingEntries.isEmpty()) {
+        return;
+    }
+    // Publish the first items without delay
+    if (!force && flushed && pendingItemCount < BATCH_ITEMS
+            && flushTimer.elapsed() < BATCH_MS) {
+        return;
+    }
+
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&entriesMutex);
+        wasEmpty = entries.isEmpty();
+        entries.append(pendingEntries);
+        entriesItemCount += pendingItemCount;
+    }
+    pendingEntries.clear();
+    pendingItemCount = 0;
+    flushed = true;
+    flushTimer.start();
+
+    // Only signal when the previous entries were taken
+    if (wasEmpty) {
+        emit entriesReady();
+    }
+}
+
+int TAddFilesThread::itemCount(TPlaylistItem* item) const {
+    return item->childCount() + publishedChildCount.value(item, 0);
+}
+
+int TAddFilesThread::countItems(TPlaylistItem* item) {
+
+    int count = 1;
+    for(int i = 0; i < item->childCount(); i++) {
+        count += countItems(item->plChild(i));
+    }
+    return count;
+}
+
+// Publish a copy of folder and of the folders containing it
+void TAddFilesThread::publishFolder(TPlaylistItem* folder) {
+
+    if (publishedFolders.contains(folder)) {
+        return;
+    }
+
+    TPlaylistItem* parent = folder->plParent();
+    if (parent) {
+        publishFolder(parent);
+        // Publish the completed items in front of folder
+        publish(parent, parent->childCount() - parent->indexOfChild(folder));
+    }
+
+    TEntry entry;
+    entry.type = TEntry::NEW_FOLDER;
+    entry.parent = parent;
+    entry.key = folder;
+    entry.item = new TPlaylistItem(*folder);
+    pendingEntries.append(entry);
+    pendingItemCount++;
+    publishedFolders.insert(folder);
+}
+
+// Publish the children of parent, except the last keep children
+void TAddFilesThread::publish(TPlaylistItem* parent, int keep) {
+
+    int count = parent->childCount() - keep;
+    if (count <= 0) {
+        return;
+    }
+
+    publishFolder(parent);
+    for(int i = 0; i < count; i++) {
+        TPlaylistItem* item = parent->plTakeChild(0);
+        publishedChildCount[parent]++;
+        if (parent->isWZPlaylist()) {
+            publishedFilenames[parent].append(item->filename());
+        }
+
+        TEntry entry;
+        entry.parent = parent;
+        entry.key = item;
+        entry.item = item;
+        if (publishedFolders.contains(item)) {
+            entry.type = TEntry::FINISH_FOLDER;
+            forgetFolder(item);
+            pendingItemCount += countItems(item) - 1;
+        } else {
+            entry.type = TEntry::ADD_ITEM;
+            pendingItemCount += countItems(item);
+        }
+        pendingEntries.append(entry);
+    }
+
+    flush(false);
+}
+
+void TAddFilesThread::forgetFolder(TPlaylistItem* folder) {
+
+    publishedFolders.remove(folder);
+    publishedChildCount.remove(folder);
+    publishedFilenames.remove(folder);
+    for(int i = 0; i < folder->childCount(); i++) {
+        TPlaylistItem* child = folder->plChild(i);
+        if (publishedFolders.contains(child)) {
+            forgetFolder(child);
+        }
+    }
 }
 
 void TAddFilesThread::run() {
+    WZSTARTTRACE("TAddFilesThread::run");
 
     playlistPath = QDir::toNativeSeparators(QDir::current().path());
     WZDOBJ << "Running in directory" << playlistPath;
@@ -143,7 +306,15 @@ void TAddFilesThread::run() {
     root = new TPlaylistItem(0, playlistPath, "", 0);
     root->setFlags(ROOT_FLAGS);
 
-    addFiles();
+    scanner = new TDirScanner(dirFilter, nameFilterList, getSortFlags(),
+                              blacklistPatterns, recurse, stopRequested);
+    if (refreshDir.isEmpty()) {
+        addFiles();
+    } else {
+        refreshFolder();
+    }
+    delete scanner;
+    scanner = 0;
 
     if (abortRequested) {
         delete root;
@@ -151,6 +322,7 @@ void TAddFilesThread::run() {
     } else {
         // TPlaylist uses empty filename to determine whether to save playlist
         root->setFilename("");
+        flush(true);
     }
 
     WZINFOOBJ(QString("Run done. Stopped %1, aborted %2")
@@ -247,14 +419,19 @@ void TAddFilesThread::addNewItems(TPlaylistItem* playlistItem) {
 
     emit displayMessage(playlistPath, 0);
 
-    // Collect relative file names loaded from playlist
+    // Collect relative file names loaded from playlist, including the ones
+    // already published
+    QStringList filenames = publishedFilenames.value(playlistItem);
+    for(int c = 0; c < playlistItem->childCount(); c++) {
+        filenames.append(playlistItem->plChild(c)->filename());
+    }
+
     QStringList files;
     QString path = playlistPath;
     if (!path.endsWith(QDir::separator())) {
         path += QDir::separator();
     }
-    for(int c = 0; c < playlistItem->childCount(); c++) {
-        QString fn = playlistItem->plChild(c)->filename();
+    foreach(QString fn, filenames) {
         if (fn.startsWith(path)) {
             // Remove path creating relative file name
             fn = fn.mid(path.length());
@@ -316,6 +493,7 @@ void TAddFilesThread::addNewItems(TPlaylistItem* playlistItem) {
         }
         if (newItem) {
             newItem->setModified();
+            publish(playlistItem, 0);
         }
     }
 
@@ -328,64 +506,219 @@ void TAddFilesThread::addNewItems(TPlaylistItem* playlistItem) {
     }
 }
 
+// Stats playlist entries to get them into the cache of the file system,
+// so the stats of addItem() do not have to wait for a network share
+class TStatTask : public QRunnable {
+public:
+    TStatTask(const QString& aPath, const QStringList& aFilenames) :
+        path(aPath),
+        filenames(aFilenames) {
+    }
+
+    virtual void run() override {
+
+        for(int i = 0; i < filenames.count(); i++) {
+            QString filename = filenames.at(i);
+            if (filename.startsWith("file:")) {
+                filename = QUrl(filename).toLocalFile();
+            } else if (filename.contains("://")) {
+                continue;
+            }
+            QFileInfo fi(path, filename);
+            if (fi.exists()) {
+                fi.isSymLink();
+            }
+        }
+    }
+
+private:
+    QString path;
+    QStringList filenames;
+};
+
+// Scan for "#EXTINF:" duration "," name, with the duration as int or since
+// version 3 as decimal
+static bool parseExtInf(const QStringRef& line, int& durationMS,
+                        QString& name) {
+
+    static const QString tag("#EXTINF:");
+    if (!line.startsWith(tag)) {
+        return false;
+    }
+
+    int i = tag.length();
+    int n = line.length();
+    while (i < n && line.at(i).isSpace()) {
+        i++;
+    }
+    int start = i;
+    while (i < n && line.at(i).isDigit()) {
+        i++;
+    }
+    if (i == start) {
+        return false;
+    }
+    if (i < n && line.at(i) == '.') {
+        i++;
+        while (i < n && line.at(i).isDigit()) {
+            i++;
+        }
+    }
+    int end = i;
+    while (i < n && line.at(i).isSpace()) {
+        i++;
+    }
+    if (i >= n || line.at(i) != ',') {
+        return false;
+    }
+
+    durationMS = qRound(line.mid(start, end - start).toDouble() * 1000);
+    name = line.mid(i + 1).toString().simplified();
+    return true;
+}
+
+// Split the playlist into its items and blacklisted files. Name and duration
+// of #EXTINF lines go to the item following them.
+void TAddFilesThread::parseM3u(const QString& text,
+                               QVector<TM3uEntry>& m3uEntries) {
+
+    static const QString blacklistTag("#WZP-blacklist:");
+
+    QString name;
+    int durationMS = 0;
+    int pos = 0;
+    while (pos < text.length()) {
+        int end = text.indexOf('\n', pos);
+        if (end < 0) {
+            end = text.length();
+        }
+        QStringRef line = text.midRef(pos, end - pos).trimmed();
+        pos = end + 1;
+
+        // Ignore empty lines
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (parseExtInf(line, durationMS, name)) {
+            continue;
+        }
+
+        TM3uEntry entry;
+        if (line.at(0) != '#') {
+            entry.filename = line.toString();
+            entry.name = name;
+            entry.durationMS = durationMS;
+            entry.blacklisted = false;
+            name = "";
+            durationMS = 0;
+        } else if (line.startsWith(blacklistTag)) {
+            entry.filename = line.mid(blacklistTag.length()).toString();
+            entry.durationMS = 0;
+            entry.blacklisted = true;
+        } else {
+            continue;
+        }
+        m3uEntries.append(entry);
+    }
+}
+
+// Queue the stats for the items in m3uEntries from index start
+static int startStats(QThreadPool& pool,
+                      const QString& path,
+                      const QVector<TAddFilesThread::TM3uEntry>& m3uEntries,
+                      int start) {
+
+    int end = qMin(start + STAT_BATCH, m3uEntries.count());
+    QStringList filenames;
+    for(int i = start; i < end; i++) {
+        const TAddFilesThread::TM3uEntry& entry = m3uEntries.at(i);
+        if (!entry.blacklisted) {
+            filenames.append(entry.filename);
+            if (filenames.count() >= STAT_TASK_ENTRIES) {
+                pool.start(new TStatTask(path, filenames));
+                filenames.clear();
+            }
+        }
+    }
+    if (!filenames.isEmpty()) {
+        pool.start(new TStatTask(path, filenames));
+    }
+    return end;
+}
+
 bool TAddFilesThread::openM3u(TPlaylistItem* playlistItem,
                               const QString& fileName) {
 
+    // Read the file in one go
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly)) {
         return false;
     }
+    QByteArray data = file.readAll();
+    file.close();
 
-    QTextStream stream(&file);
+    // Like QTextStream, let a BOM override the codec
+    QTextCodec* codec;
     if (playlistItem->extension() == "m3u") {
-        stream.setCodec(QTextCodec::codecForLocale());
+        codec = QTextCodec::codecForLocale();
     } else {
-        // Set the C locale to get a decimal . when reading version 3 durations.
-        stream.setLocale(QLocale::c());
-        stream.setCodec("UTF-8");
+        codec = QTextCodec::codecForName("UTF-8");
     }
+    codec = QTextCodec::codecForUtfText(data, codec);
 
-    QString name;
-    int durationMS = 0;
-    bool edited;
-    static QRegExp rx("^#EXTINF:\\s*(\\d+(\\.\\d*)?)\\s*,\\s*(.*)");
+    QVector<TM3uEntry> m3uEntries;
+    {
+        QString text = codec->toUnicode(data);
+        data.clear();
+        parseM3u(text, m3uEntries);
+    }
 
     QString path = playlistPath;
     if (!path.endsWith(QDir::separator())) {
         path += QDir::separator();
     }
 
-    while (!stream.atEnd()) {
+    // Stat the next batch of entries in parallel, while adding the current
+    // batch. The results are identical, addItem() still does the work.
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount() * 2));
+    bool prefetch = m3uEntries.count() >= STAT_MIN_ENTRIES;
+    int statted = prefetch
+            ? startStats(pool, playlistPath, m3uEntries, 0)
+            : m3uEntries.count();
+
+    for(int i = 0; i < m3uEntries.count(); i++) {
         if (stopRequested) {
             break;
         }
-        QString line = stream.readLine().trimmed();
-        // Ignore empty lines
-        if (line.isEmpty()) {
-            continue;
+        if (prefetch && i % STAT_BATCH == 0) {
+            pool.waitForDone();
+            if (statted < m3uEntries.count()) {
+                statted = startStats(pool, playlistPath, m3uEntries, statted);
+            }
         }
-        if (rx.indexIn(line) >= 0) {
-            // Get name and duration as int or since version 3 as decimal
-            durationMS = qRound(rx.cap(1).toDouble() * 1000);
-            name = rx.cap(3).simplified();
-        } else if (!line.startsWith("#")) {
-            // Add playlist item
-            edited = !name.isEmpty() && name != TName::nameForURL(line);
-            addItem(playlistItem, line, name, durationMS, edited, true);
-            // Reset name and duration
-            name = "";
-            durationMS = 0;
-        } else if (line.startsWith("#WZP-blacklist:")) {
+
+        const TM3uEntry& entry = m3uEntries.at(i);
+        if (entry.blacklisted) {
             // Add blacklist item
-            QString fn = line.mid(15);
+            QString fn = entry.filename;
             if (fn.startsWith(path)) {
                 fn = fn.mid(path.length());
             }
             playlistItem->blacklist(fn);
+        } else {
+            // Add playlist item
+            bool edited = !entry.name.isEmpty()
+                    && entry.name != TName::nameForURL(entry.filename);
+            addItem(playlistItem, entry.filename, entry.name,
+                    entry.durationMS, edited, true);
+            // Keep the last item, createPath() might add to it
+            publish(playlistItem, 1);
         }
     }
 
-    file.close();
+    pool.clear();
+    pool.waitForDone();
 
     if (!stopRequested && playlistItem->isWZPlaylist()) {
         addNewItems(playlistItem);
@@ -431,7 +764,7 @@ TPlaylistItem* TAddFilesThread::openPlaylist(TPlaylistItem *parent,
         protectName);
 
     if (openM3u(playlistItem, sourceFileName)) {
-        if (playlistItem->childCount()) {
+        if (itemCount(playlistItem)) {
             latestDir = playlistPath;
         } else {
             WZINFOOBJ("Found no playable items in '" + sourceFileName + "'");
@@ -475,6 +808,37 @@ TPlaylistItem* TAddFilesThread::addFile(TPlaylistItem* parent,
     return new TPlaylistItem(parent, fi.absoluteFilePath(), name, 0);
 }
 
+// Same as addFile(), but with the file info from the directory listing
+TPlaylistItem* TAddFilesThread::addListedFile(TPlaylistItem* parent,
+                                              const QString& filename,
+                                              const TDirEntry& entry) {
+
+    QFileInfo fi(filename);
+    QString name = fi.completeBaseName();
+    QFileInfo target(entry.target);
+
+    if (extensions.playlists().contains(entry.isSymLink
+                                        ? target.suffix().toLower()
+                                        : fi.suffix().toLower())) {
+        return openPlaylist(parent, fi, name, false);
+    }
+
+    if (entry.isSymLink) {
+        if (fi.suffix().toLower() == "lnk") {
+            return new TPlaylistItem(parent, target.absoluteFilePath(), name, 0);
+        }
+
+        if (extensions.isMultiMedia(target)) {
+            return new TPlaylistItem(parent, filename, name, true,
+                                     entry.target);
+        }
+
+        return 0;
+    }
+
+    return new TPlaylistItem(parent, filename, name, false, QString());
+}
+
 QDir::SortFlags TAddFilesThread::getSortFlags() {
     return QDir::NoSort;
 }
@@ -503,16 +867,16 @@ TPlaylistItem* TAddFilesThread::addDirectory(TPlaylistItem* parent,
         name = directory.dirName();
     }
 
-    if (directory.exists(TConfig::WZPLAYLIST)) {
+    // Get the entries listed by the scanner
+    TDirEntryList entries;
+    qint64 modified;
+    if (!scanner->take(fi.absoluteFilePath(), entries, modified)) {
         fi.setFile(directory.path(), TConfig::WZPLAYLIST);
         return openPlaylist(parent, fi, name, protectName);
     }
 
-    directory.setFilter(dirFilter);
-    directory.setNameFilters(nameFilterList);
-    directory.setSorting(getSortFlags());
-
     QString path = QDir::toNativeSeparators(directory.path());
+    listedDirs.insert(path, modified);
 
     TPlaylistItem* dirItem = new TPlaylistItem(parent, path, name, 0,
                                                protectName);
@@ -521,29 +885,35 @@ TPlaylistItem* TAddFilesThread::addDirectory(TPlaylistItem* parent,
         path += QDir::separator();
     }
 
-    foreach(QFileInfo f, directory.entryInfoList()) {
+    foreach(const TDirEntry& entry, entries) {
         // Stop collecting files when stop requested
         if (stopRequested) {
             break;
         }
 
         // Check against blacklist
-        if (nameBlackListed(path + f.fileName())) {
+        QString filename = path + entry.name;
+        if (nameBlackListed(filename)) {
             continue;
         }
 
-        if (f.isDir()) {
+        TPlaylistItem* item = 0;
+        if (entry.isDir) {
             if (recurse) {
-                addDirectory(dirItem, f, f.fileName(), false);
+                QFileInfo f(filename);
+                item = addDirectory(dirItem, f, entry.name, false);
             } else {
-                WZTRACEOBJ("Skipping directory '" + f.fileName() + "'");
+                WZTRACEOBJ("Skipping directory '" + entry.name + "'");
             }
         } else {
-            addFile(dirItem, f);
+            item = addListedFile(dirItem, filename, entry);
+        }
+        if (item) {
+            publish(dirItem, 0);
         }
     }
 
-    if (dirItem->childCount()) {
+    if (itemCount(dirItem)) {
         latestDir = directory.path();
     } else if (isFavList && parent->baseName() == "Favorites") {
         // Keep empty folders inside favorites directory
@@ -680,6 +1050,54 @@ void TAddFilesThread::addFiles() {
                 0 /* duartion */,
                 false, /* protect name */
                 false /* use blacklist */);
+        // Keep the last item, createPath() might add to it
+        publish(root, 1);
+    }
+}
+
+void TAddFilesThread::refreshFolder() {
+    WZDEBUGOBJ("'" + refreshDir + "'");
+
+    // A removed directory or a directory turned into a wzplaylist is left to
+    // the refresh of its parent
+    TDirEntryList entries;
+    qint64 modified;
+    if (!QFileInfo(refreshDir).isDir()
+            || !scanner->list(refreshDir, entries, modified)) {
+        return;
+    }
+    listedDirs.insert(refreshDir, modified);
+
+    QString path = refreshDir;
+    if (!path.endsWith(QDir::separator())) {
+        path += QDir::separator();
+    }
+
+    QSet<QString> onDisk;
+    foreach(const TDirEntry& entry, entries) {
+        if (stopRequested) {
+            return;
+        }
+
+        QString key = nameKey(entry.name);
+        onDisk.insert(key);
+        if (refreshKnownNames.contains(key) || (entry.isDir && !recurse)) {
+            continue;
+        }
+        QString filename = path + entry.name;
+        if (nameBlackListed(filename)) {
+            continue;
+        }
+
+        WZINFOOBJ("Adding new file '" + filename + "'");
+        addItem(root, filename, "", 0, false, false);
+        publish(root, 1);
+    }
+
+    foreach(const QString& key, refreshKnownNames) {
+        if (!onDisk.contains(key)) {
+            removedNames.append(key);
+        }
     }
 }
 
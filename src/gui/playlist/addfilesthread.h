@@ -5,6 +5,12 @@
 #include <QStringList>
 #include <QString>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
 
 #include "wzdebug.h"
 
@@ -15,6 +21,8 @@ namespace Gui {
 namespace Playlist {
 
 class TPlaylistItem;
+class TDirScanner;
+struct TDirEntry;
 
 
 class TAddFilesThread : public QThread {
@@ -33,19 +41,58 @@ public:
                              bool favList);
     virtual ~TAddFilesThread() override;
 
+    // Items are published while the thread is running. A completed item is
+    // moved out of the tree of the thread and published with ADD_ITEM. A
+    // folder still being filled is published with NEW_FOLDER as a copy
+    // without children, to receive the items published into it. When the
+    // folder is completed, FINISH_FOLDER passes the folder itself, with the
+    // items not published yet and its final state. The folder of the entries
+    // is identified by its address in the tree of the thread.
+    struct TEntry {
+        enum TType { NEW_FOLDER, ADD_ITEM, FINISH_FOLDER };
+        TType type;
+        TPlaylistItem* parent;
+        TPlaylistItem* key;
+        TPlaylistItem* item;
+    };
+
     virtual void run();
     void abort() { abortRequested = true; stopRequested = true; }
     void stop() { stopRequested = true; }
 
+    // Take the entries published since the last call, passing ownership of
+    // the items. itemCount returns the number of items in them.
+    QList<TEntry> takeEntries(int& itemCount);
+
+    // Item or blacklisted file of a m3u playlist
+    struct TM3uEntry {
+        QString filename;
+        QString name;
+        int durationMS;
+        bool blacklisted;
+    };
+
+    // Instead of adding files, add the entries of directory dir with a
+    // name not in knownNames and return the known names no longer in dir in
+    // removedNames. Names are compared by nameKey().
+    void setRefresh(const QString& dir, const QSet<QString>& knownNames);
+    static QString nameKey(const QString& name);
+
     // Inputs
     const QStringList& files;
 
     // Outputs
     TPlaylistItem* root;
     QString latestDir;
+    QStringList removedNames;
+    // Directories listed, with their modification time from before listing
+    // them, including the directories without playable items
+    QHash<QString, qint64> listedDirs;
 
 signals:
     void displayMessage(const QString&, int);
+    // Emitted when entries become available for takeEntries()
+    void entriesReady();
 
 private:
     bool abortRequested;
@@ -54,7 +101,27 @@ private:
     bool addImages;
     bool isFavList;
 
+    QStringList blacklistPatterns;
+    TDirScanner* scanner;
     QString playlistPath;
+    QString refreshDir;
+    QSet<QString> refreshKnownNames;
+
+    // Published entries waiting to be taken
+    QMutex entriesMutex;
+    QList<TEntry> entries;
+    int entriesItemCount;
+    // Entries collected for the next batch
+    QList<TEntry> pendingEntries;
+    int pendingItemCount;
+    bool flushed;
+    QElapsedTimer flushTimer;
+    // Folders published with NEW_FOLDER and not finished yet
+    QSet<TPlaylistItem*> publishedFolders;
+    // Number of children moved out of a folder
+    QHash<TPlaylistItem*, int> publishedChildCount;
+    // Filenames of children moved out of a wzplaylist
+    QHash<TPlaylistItem*, QStringList> publishedFilenames;
 
     QStringList lockedFiles;
     QStringList nameFilterList;
@@ -62,9 +129,19 @@ private:
 
     bool nameBlackListed(const QString& name);
 
+    int itemCount(TPlaylistItem* item) const;
+    static int countItems(TPlaylistItem* item);
+    void publishFolder(TPlaylistItem* folder);
+    void publish(TPlaylistItem* parent, int keep);
+    void forgetFolder(TPlaylistItem* folder);
+    void flush(bool force);
+
     static QDir::SortFlags getSortFlags();
 
     TPlaylistItem* addFile(TPlaylistItem* parent, const QFileInfo& fi);
+    TPlaylistItem* addListedFile(TPlaylistItem* parent,
+                                 const QString& filename,
+                                 const TDirEntry& entry);
 
     TPlaylistItem* addDirectory(TPlaylistItem* parent,
                                 QFileInfo& fi,
@@ -79,6 +156,8 @@ private:
 
     void addNewItems(TPlaylistItem* playlistItem);
 
+    static void parseM3u(const QString& text,
+                         QVector<TM3uEntry>& m3uEntries);
     bool openM3u(TPlaylistItem* playlistItem, const QString& fileName);
     TPlaylistItem* openPlaylist(TPlaylistItem* parent,
                                 const QFileInfo& fi,
@@ -93,6 +172,7 @@ private:
                            bool useBlackList);
 
     void addFiles();
+    void refreshFolder();
 };
 
 } // namespace Playlist
@@ -0,0 +1,522 @@
+#include "gui/playlist/dirscanner.h"
+#include "settings/paths.h"
+#include "wzdebug.h"
+#include "config.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThread>
+
+#include <algorithm>
+
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, Gui::Playlist::TDirScanner)
+
+namespace Gui {
+namespace Playlist {
+
+const quint32 CACHE_MAGIC = 0x575a4449; // WZDI
+const qint32 CACHE_VERSION = 2;
+// Above this number of directories, drop the least recently used
+// directories when saving the cache
+const int MAX_CACHED_DIRS = 100000;
+// Do not cache directories modified less than this number of ms before they
+// were listed. A change in the same clock tick would go unnoticed.
+const qint64 MIN_CACHE_AGE = 2000;
+// Resolution of the last used time of a directory in ms
+const qint64 LAST_USED_RESOLUTION = 24 * 60 * 60 * 1000;
+// Number of changed directories needed before a finished scanner rewrites
+// the cache. Fewer changes, like those of a refreshed folder, are written
+// by TDirScanner::saveCache().
+const int MIN_SAVE_CHANGES = 100;
+
+// Directory listings shared by the scanners of the process, per filter key
+class TDirCache {
+public:
+    TDirCache() : loaded(false), changes(0) {}
+
+    static TDirCache& instance();
+
+    bool find(const QString& key, const QString& dir, qint64 dirModified,
+              bool& hasPlaylist, TDirEntryList& entries);
+    void store(const QString& key, const QString& dir, qint64 dirModified,
+               bool hasPlaylist, const TDirEntryList& entries);
+    // Write the cache if it has changes. Unless force is set, only write it
+    // when there are at least MIN_SAVE_CHANGES changes.
+    void save(bool force);
+
+private:
+    struct TSnapshot {
+        TSnapshot() : modified(0), lastUsed(0), hasPlaylist(false) {}
+        qint64 modified;
+        qint64 lastUsed;
+        bool hasPlaylist;
+        TDirEntryList entries;
+    };
+
+    typedef QHash<QString, TSnapshot> TSnapshots;
+
+    // Guards the members, saveMutex serializes writing the file
+    QMutex mutex;
+    QMutex saveMutex;
+    QHash<QString, TSnapshots> snapshots;
+    bool loaded;
+    // Number of directories added, changed, removed or used since the last
+    // save
+    int changes;
+
+    void load();
+    void prune();
+};
+
+TDirCache& TDirCache::instance() {
+
+    static TDirCache cache;
+    return cache;
+}
+
+bool TDirCache::find(const QString& key,
+                     const QString& dir,
+                     qint64 dirModified,
+                     bool& hasPlaylist,
+                     TDirEntryList& entries) {
+
+    QMutexLocker locker(&mutex);
+    if (!loaded) {
+        load();
+    }
+
+    TSnapshots& set = snapshots[key];
+    TSnapshots::iterator i = set.find(dir);
+    if (i == set.end() || i->modified != dirModified) {
+        return false;
+    }
+    // Only rewrite the cache for a new last used time once a day
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - i->lastUsed > LAST_USED_RESOLUTION) {
+        i->lastUsed = now;
+        changes++;
+    }
+    hasPlaylist = i->hasPlaylist;
+    entries = i->entries;
+    return true;
+}
+
+void TDirCache::store(const QString& key,
+                      const QString& dir,
+                      qint64 dirModified,
+                      bool hasPlaylist,
+                      const TDirEntryList& entries) {
+
+    QMutexLocker locker(&mutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - dirModified < MIN_CACHE_AGE) {
+        if (snapshots[key].remove(dir)) {
+            changes++;
+        }
+        return;
+    }
+
+    TSnapshots& set = snapshots[key];
+    TSnapshots::iterator i = set.find(dir);
+    if (i != set.end() && i->modified == dirModified) {
+        // Same modification time, same listing
+        if (now - i->lastUsed > LAST_USED_RESOLUTION) {
+            i->lastUsed = now;
+            changes++;
+        }
+        return;
+    }
+
+    TSnapshot& snapshot = set[dir];
+    snapshot.modified = dirModified;
+    snapshot.lastUsed = now;
+    snapshot.hasPlaylist = hasPlaylist;
+    snapshot.entries = entries;
+    changes++;
+}
+
+// Requires mutex to be locked
+void TDirCache::load() {
+
+    loaded = true;
+    QFile file(Settings::TPaths::dirCacheFileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        WZWARN("Ignoring directory cache '" + file.fileName()
+               + "' with unknown format");
+        return;
+    }
+
+    int total = 0;
+    qint32 setCount;
+    in >> setCount;
+    for(int s = 0; s < setCount && in.status() == QDataStream::Ok; s++) {
+        QString key;
+        qint32 count;
+        in >> key >> count;
+        TSnapshots& set = snapshots[key];
+        set.reserve(count);
+        for(int i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+            QString dir;
+            TSnapshot snapshot;
+            qint32 entryCount;
+            in >> dir >> snapshot.modified >> snapshot.lastUsed
+               >> snapshot.hasPlaylist >> entryCount;
+            for(int e = 0; e < entryCount && in.status() == QDataStream::Ok;
+                e++) {
+                TDirEntry entry;
+                in >> entry.name >> entry.isDir >> entry.isSymLink;
+                if (entry.isSymLink) {
+                    in >> entry.target;
+                }
+                snapshot.entries.append(entry);
+            }
+            set.insert(dir, snapshot);
+        }
+        total += set.count();
+    }
+
+    if (in.status() == QDataStream::Ok) {
+        WZDEBUG(QString("Loaded %1 directories from '%2'")
+                .arg(total).arg(file.fileName()));
+    } else {
+        WZWARN("Failed to read directory cache '" + file.fileName() + "'");
+        snapshots.clear();
+    }
+}
+
+// Keep the cache from growing without bounds by dropping the least recently
+// used directories. Requires mutex to be locked.
+void TDirCache::prune() {
+
+    QVector<qint64> used;
+    QHash<QString, TSnapshots>::const_iterator s = snapshots.constBegin();
+    while (s != snapshots.constEnd()) {
+        TSnapshots::const_iterator i = s->constBegin();
+        while (i != s->constEnd()) {
+            used.append(i->lastUsed);
+            ++i;
+        }
+        ++s;
+    }
+    if (used.count() <= MAX_CACHED_DIRS) {
+        return;
+    }
+
+    // Drop the directories used before the MAX_CACHED_DIRS most recent ones
+    std::nth_element(used.begin(), used.end() - MAX_CACHED_DIRS, used.end());
+    qint64 oldest = *(used.end() - MAX_CACHED_DIRS);
+    int dropped = 0;
+    QHash<QString, TSnapshots>::iterator set = snapshots.begin();
+    while (set != snapshots.end()) {
+        TSnapshots::iterator i = set->begin();
+        while (i != set->end()) {
+            if (i->lastUsed < oldest) {
+                i = set->erase(i);
+                dropped++;
+            } else {
+                ++i;
+            }
+        }
+        if (set->isEmpty()) {
+            set = snapshots.erase(set);
+        } else {
+            ++set;
+        }
+    }
+    WZDEBUG(QString("Dropped %1 least recently used directories")
+            .arg(dropped));
+}
+
+void TDirCache::save(bool force) {
+
+    // Write a copy, to not block the scanners while writing
+    QMutexLocker saveLocker(&saveMutex);
+    QHash<QString, TSnapshots> copy;
+    {
+        QMutexLocker locker(&mutex);
+        if (changes == 0 || (!force && changes < MIN_SAVE_CHANGES)) {
+            return;
+        }
+        changes = 0;
+        prune();
+        copy = snapshots;
+    }
+
+    QString filename = Settings::TPaths::dirCacheFileName();
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        WZWARN("Failed to open directory cache '" + filename + "'. "
+               + file.errorString());
+        return;
+    }
+
+    int total = 0;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << CACHE_MAGIC << CACHE_VERSION << static_cast<qint32>(copy.count());
+    QHash<QString, TSnapshots>::const_iterator s = copy.constBegin();
+    while (s != copy.constEnd()) {
+        out << s.key() << static_cast<qint32>(s->count());
+        TSnapshots::const_iterator i = s->constBegin();
+        while (i != s->constEnd()) {
+            out << i.key() << i->modified << i->lastUsed << i->hasPlaylist
+                << static_cast<qint32>(i->entries.count());
+            for(int e = 0; e < i->entries.count(); e++) {
+                const TDirEntry& entry = i->entries.at(e);
+                out << entry.name << entry.isDir << entry.isSymLink;
+                if (entry.isSymLink) {
+                    out << entry.target;
+                }
+            }
+            ++i;
+        }
+        total += s->count();
+        ++s;
+    }
+
+    if (file.commit()) {
+        WZDEBUG(QString("Saved %1 directories to '%2'")
+                .arg(total).arg(filename));
+    } else {
+        WZWARN("Failed to save directory cache '" + filename + "'. "
+               + file.errorString());
+    }
+}
+
+class TDirScanTask : public QRunnable {
+public:
+    TDirScanTask(TDirScanner* aScanner, const QString& aDir) :
+        scanner(aScanner),
+        dir(aDir) {
+    }
+
+    virtual void run() override {
+        scanner->runTask(dir);
+    }
+
+private:
+    TDirScanner* scanner;
+    QString dir;
+};
+
+
+TDirScanner::TDirScanner(QDir::Filters aFilter,
+                         const QStringList& aNameFilters,
+                         QDir::SortFlags aSort,
+                         const QStringList& aNameBlacklist,
+                         bool aRecurse,
+                         const bool& aStopRequested) :
+    filter(aFilter),
+    nameFilters(aNameFilters),
+    sort(aSort),
+    recurse(aRecurse),
+    stopRequested(aStopRequested),
+    stopping(false),
+    listed_by_pool(0),
+    listed_by_caller(0),
+    listed_from_cache(0) {
+
+    // Listings made with different filters cannot be used
+    cacheKey = nameFilters.join("|")
+            + "|" + QString::number(static_cast<int>(filter))
+            + "|" + QString::number(static_cast<int>(sort));
+
+    // Listing a directory mostly waits for the file system, in particular
+    // on network shares, so use more threads than there are cores
+    pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount() * 2));
+
+    // Own copies of the expressions, QRegExp is not thread safe
+    QRegExp rx("", Qt::CaseInsensitive);
+    for(int i = aNameBlacklist.count() - 1; i >= 0; i--) {
+        const QString& name = aNameBlacklist.at(i);
+        if (!name.isEmpty() && !name.startsWith("#")) {
+            rx.setPattern(name);
+            if (rx.isValid()) {
+                nameBlacklist.append(rx);
+            }
+        }
+    }
+}
+
+TDirScanner::~TDirScanner() {
+
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+    }
+    pool.clear();
+    pool.waitForDone();
+    WZDEBUG(QString("Listed %1 directories in the pool and %2 by the caller,"
+                    " %3 from cache")
+            .arg(listed_by_pool).arg(listed_by_caller)
+            .arg(listed_from_cache));
+    TDirCache::instance().save(false);
+}
+
+void TDirScanner::saveCache() {
+    TDirCache::instance().save(true);
+}
+
+bool TDirScanner::nameBlackListed(const QString& name) {
+
+    for(int i = nameBlacklist.size() - 1; i >= 0; i--) {
+        if (nameBlacklist[i].indexIn(name) >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TDirScanner::list(const QString& dir,
+                       TDirEntryList& entries,
+                       qint64& modified) {
+
+    // Get the modification time before listing, so changes made while
+    // listing invalidate the snapshot
+    QDateTime lastModified = QFileInfo(dir).lastModified();
+    modified = lastModified.isValid()
+            ? lastModified.toMSecsSinceEpoch() : -1;
+    bool hasPlaylist;
+    if (modified >= 0 && TDirCache::instance().find(cacheKey, dir, modified,
+                                                    hasPlaylist, entries)) {
+        QMutexLocker locker(&mutex);
+        listed_from_cache++;
+        return !hasPlaylist;
+    }
+
+    QDir directory(dir);
+    hasPlaylist = directory.exists(TConfig::WZPLAYLIST);
+    if (!hasPlaylist) {
+        directory.setFilter(filter);
+        directory.setNameFilters(nameFilters);
+        directory.setSorting(sort);
+        QFileInfoList found = directory.entryInfoList();
+
+        // Fetch the file info TAddFilesThread needs while still in the pool
+        entries.reserve(found.count());
+        for(int i = 0; i < found.count(); i++) {
+            const QFileInfo& fi = found.at(i);
+            TDirEntry entry;
+            entry.name = fi.fileName();
+            entry.isDir = fi.isDir();
+            entry.isSymLink = fi.isSymLink();
+            if (entry.isSymLink) {
+                entry.target = fi.symLinkTarget();
+            }
+            entries.append(entry);
+        }
+    }
+
+    if (modified >= 0) {
+        TDirCache::instance().store(cacheKey, dir, modified, hasPlaylist,
+                                    entries);
+    }
+    return !hasPlaylist;
+}
+
+// Requires mutex to be locked
+void TDirScanner::store(const QString& dir,
+                        qint64 modified,
+                        bool hasPlaylist,
+                        const TDirEntryList& entries) {
+
+    TDir& d = dirs[dir];
+    d.state = DONE;
+    d.modified = modified;
+    d.hasPlaylist = hasPlaylist;
+    d.entries = entries;
+    int depth = d.depth + 1;
+    listed.wakeAll();
+
+    if (!recurse || hasPlaylist || stopping || stopRequested) {
+        return;
+    }
+
+    // Queue the subdirectories. Deeper directories get a higher priority,
+    // so the pool runs ahead of the depth first walk of TAddFilesThread.
+    // Symbolic links are left to TAddFilesThread, to not follow cycles.
+    QDir directory(dir);
+    for(int i = 0; i < entries.count(); i++) {
+        const TDirEntry& entry = entries.at(i);
+        if (entry.isDir && !entry.isSymLink) {
+            QString sub = directory.absoluteFilePath(entry.name);
+            if (!dirs.contains(sub)
+                && !nameBlackListed(QDir::toNativeSeparators(sub))) {
+                dirs[sub].depth = depth;
+                pool.start(new TDirScanTask(this, sub), depth);
+            }
+        }
+    }
+}
+
+void TDirScanner::runTask(const QString& dir) {
+
+    {
+        QMutexLocker locker(&mutex);
+        QHash<QString, TDir>::iterator i = dirs.find(dir);
+        // Skip directories taken over by the caller
+        if (stopping || stopRequested || i == dirs.end()
+            || i->state != QUEUED) {
+            return;
+        }
+        i->state = LISTING;
+        listed_by_pool++;
+    }
+
+    TDirEntryList entries;
+    qint64 modified;
+    bool hasPlaylist = !list(dir, entries, modified);
+
+    QMutexLocker locker(&mutex);
+    store(dir, modified, hasPlaylist, entries);
+}
+
+bool TDirScanner::take(const QString& dir,
+                       TDirEntryList& entries,
+                       qint64& modified) {
+
+    QMutexLocker locker(&mutex);
+    QHash<QString, TDir>::iterator i = dirs.find(dir);
+    if (i == dirs.end() || i->state == QUEUED) {
+        // Not queued or not started yet. List it here instead of waiting.
+        if (i == dirs.end()) {
+            i = dirs.insert(dir, TDir());
+        }
+        i->state = LISTING;
+        listed_by_caller++;
+        locker.unlock();
+
+        TDirEntryList found;
+        qint64 foundModified;
+        bool hasPlaylist = !list(dir, found, foundModified);
+
+        locker.relock();
+        store(dir, foundModified, hasPlaylist, found);
+    } else {
+        while (dirs.value(dir).state != DONE) {
+            listed.wait(&mutex);
+        }
+    }
+
+    TDir d = dirs.take(dir);
+    entries = d.entries;
+    modified = d.modified;
+    return !d.hasPlaylist;
+}
+
+} // namespace Playlist
+} // namespace Gui
@@ -0,0 +1,111 @@
+#ifndef GUI_PLAYLIST_DIRSCANNER_H
+#define GUI_PLAYLIST_DIRSCANNER_H
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QRegExp>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+
+namespace Gui {
+namespace Playlist {
+
+// Entry of a directory listing, with the file info TAddFilesThread needs
+struct TDirEntry {
+    TDirEntry() : isDir(false), isSymLink(false) {}
+    QString name;
+    bool isDir;
+    bool isSymLink;
+    QString target;
+};
+
+typedef QList<TDirEntry> TDirEntryList;
+
+// Lists directories for TAddFilesThread. After a directory is listed, its
+// subdirectories are queued to a thread pool, so the directories ahead of
+// TAddFilesThread are listed in parallel. TAddFilesThread still walks the
+// tree in the same order, taking the listings with take(), so the resulting
+// tree does not depend on the order in which the pool finishes. A directory
+// still waiting in the queue when it is taken is listed by the caller.
+//
+// Listings are kept in a cache shared by all scanners of the process,
+// together with the modification time of the directory. As long as the
+// modification time does not change, the listing is taken from the cache,
+// costing a single stat per directory. Listings made with different filters
+// are kept apart. The cache is saved to a file by saveCache() and when a
+// finished scanner changed enough directories. The least recently used
+// directories are dropped when it grows too big.
+class TDirScanner {
+public:
+    TDirScanner(QDir::Filters aFilter,
+                const QStringList& aNameFilters,
+                QDir::SortFlags aSort,
+                const QStringList& aNameBlacklist,
+                bool aRecurse,
+                const bool& aStopRequested);
+    virtual ~TDirScanner();
+
+    // Get the listing of dir, where dir is the absolute file path of the
+    // directory. Returns false if the directory contains a wzplaylist.
+    // modified returns the modification time of the directory from before
+    // it was listed, -1 if unknown.
+    bool take(const QString& dir, TDirEntryList& entries, qint64& modified);
+    // Like take(), but only lists dir, without queuing its subdirectories
+    bool list(const QString& dir, TDirEntryList& entries, qint64& modified);
+
+    // Save the changes to the cache not saved yet
+    static void saveCache();
+
+    int listedByPool() const { return listed_by_pool; }
+    int listedByCaller() const { return listed_by_caller; }
+    int listedFromCache() const { return listed_from_cache; }
+
+private:
+    enum TState { QUEUED, LISTING, DONE };
+
+    struct TDir {
+        TDir() : state(QUEUED), depth(0), modified(-1), hasPlaylist(false) {}
+        TState state;
+        int depth;
+        qint64 modified;
+        bool hasPlaylist;
+        TDirEntryList entries;
+    };
+
+    friend class TDirScanTask;
+
+    const QDir::Filters filter;
+    const QStringList nameFilters;
+    const QDir::SortFlags sort;
+    QVector<QRegExp> nameBlacklist;
+    const bool recurse;
+    const bool& stopRequested;
+
+    QThreadPool pool;
+    QMutex mutex;
+    QWaitCondition listed;
+    QHash<QString, TDir> dirs;
+    bool stopping;
+    int listed_by_pool;
+    int listed_by_caller;
+
+    // Identifies the filters in the cache
+    QString cacheKey;
+    int listed_from_cache;
+
+    bool nameBlackListed(const QString& name);
+    void store(const QString& dir, qint64 modified, bool hasPlaylist,
+               const TDirEntryList& entries);
+    void runTask(const QString& dir);
+};
+
+} // namespace Playlist
+} // namespace Gui
+
+#endif // GUI_PLAYLIST_DIRSCANNER_H
@@ -0,0 +1,479 @@
+#include "gui/playlist/durationprober.h"
+#include "settings/preferences.h"
+#include "settings/paths.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegExp>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+
+
+namespace Gui {
+namespace Playlist {
+
+// Probes running at the same time when the player is idle
+const int MAX_PROCS = 2;
+// Queued files checked against the cache per task
+const int MAX_CACHE_CHECKS = 200;
+// Give up on files taking longer to probe
+const int PROBE_TIMEOUT = 20000;
+// Delay before writing the cache after a change
+const int SAVE_DELAY = 10000;
+// Above this number of durations, drop the least recently used durations
+// when saving the cache
+const int MAX_CACHED_DURATIONS = 100000;
+// Resolution of the last used time of a duration in ms
+const qint64 LAST_USED_RESOLUTION = 24 * 60 * 60 * 1000;
+
+const quint32 CACHE_MAGIC = 0x575a4455; // WZDU
+const qint32 CACHE_VERSION = 2;
+
+class TCacheCheckTask : public QRunnable {
+public:
+    TCacheCheckTask(TDurationProber* aProber, const QStringList& aFilenames) :
+        prober(aProber),
+        filenames(aFilenames) {
+    }
+
+    virtual void run() override {
+        prober->checkCache(filenames);
+    }
+
+private:
+    TDurationProber* prober;
+    QStringList filenames;
+};
+
+TDurationProber::TDurationProber(QObject* parent) :
+    QObject(parent),
+    maxProcs(MAX_PROCS),
+    checking(false),
+    discardChecked(false),
+    cacheLoaded(false),
+    cacheModified(false) {
+
+    setObjectName("duration_prober");
+    pool.setMaxThreadCount(1);
+
+    nextTimer = new QTimer(this);
+    nextTimer->setSingleShot(true);
+    nextTimer->setInterval(0);
+    connect(nextTimer, &QTimer::timeout,
+            this, &TDurationProber::startNext);
+
+    saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(SAVE_DELAY);
+    connect(saveTimer, &QTimer::timeout,
+            this, &TDurationProber::saveCache);
+}
+
+TDurationProber::~TDurationProber() {
+
+    pool.waitForDone();
+    while (!procs.isEmpty()) {
+        stopProc(procs.first());
+    }
+    saveCache();
+}
+
+// Identify the file by its path, size and modification time, so a changed
+// file is probed again
+QString TDurationProber::fileKey(const QFileInfo& fi) {
+
+    return fi.absoluteFilePath()
+            + "|" + QString::number(fi.size())
+            + "|" + QString::number(fi.lastModified().toMSecsSinceEpoch());
+}
+
+void TDurationProber::probe(const QString& filename) {
+
+    if (!queued.contains(filename)) {
+        queued.insert(filename);
+        queue.append(filename);
+        nextTimer->start();
+    }
+}
+
+// A filename can be in both queues. queued tells whether it still needs to
+// be probed.
+void TDurationProber::probeFirst(const QStringList& filenames) {
+
+    // Move the filenames not taken yet to the back. Checked files waiting
+    // for a process are checked again after the new filenames.
+    queue.append(firstQueue);
+    for(int i = toProbe.count() - 1; i >= 0; i--) {
+        const QString& filename = toProbe.at(i).filename;
+        queue.prepend(filename);
+        queued.insert(filename);
+    }
+    toProbe.clear();
+    firstQueue = filenames;
+    for(int i = 0; i < filenames.count(); i++) {
+        queued.insert(filenames.at(i));
+    }
+    nextTimer->start();
+}
+
+void TDurationProber::clear() {
+
+    queue.clear();
+    firstQueue.clear();
+    queued.clear();
+    toProbe.clear();
+    discardChecked = checking;
+}
+
+void TDurationProber::setMaxProcs(int max) {
+
+    if (max != maxProcs) {
+        WZDOBJ << "Running at most" << max << "probes";
+        maxProcs = max;
+
+        // Stop the probes above the maximum and probe their files first
+        // when resumed
+        while (procs.count() > maxProcs) {
+            QProcess* proc = procs.last();
+            TCheckedFile file;
+            file.filename = proc->property("filename").toString();
+            file.key = proc->property("key").toString();
+            file.ms = -1;
+            WZTOBJ << "Postponing probe of" << file.filename;
+            stopProc(proc);
+            toProbe.prepend(file);
+        }
+        nextTimer->start();
+    }
+}
+
+void TDurationProber::startNext() {
+
+    while (procs.count() < maxProcs && !toProbe.isEmpty()) {
+        TCheckedFile file = toProbe.takeFirst();
+        startProc(file.filename, file.key);
+    }
+
+    // Only check the next batch when running out of checked files and not
+    // paused
+    if (checking || toProbe.count() >= maxProcs) {
+        return;
+    }
+
+    QStringList filenames;
+    while (filenames.count() < MAX_CACHE_CHECKS
+           && !(firstQueue.isEmpty() && queue.isEmpty())) {
+        QString filename = firstQueue.isEmpty()
+                ? queue.takeFirst()
+                : firstQueue.takeFirst();
+        // Skip files already taken from the other queue
+        if (queued.remove(filename)) {
+            filenames.append(filename);
+        }
+    }
+    if (!filenames.isEmpty()) {
+        checking = true;
+        pool.start(new TCacheCheckTask(this, filenames));
+    }
+}
+
+// Runs in the pool
+void TDurationProber::checkCache(const QStringList& filenames) {
+
+    QList<TCheckedFile> files;
+    for(int i = 0; i < filenames.count(); i++) {
+        QFileInfo fi(filenames.at(i));
+        if (fi.isFile()) {
+            TCheckedFile file;
+            file.filename = filenames.at(i);
+            file.key = fileKey(fi);
+            file.ms = -1;
+            files.append(file);
+        }
+    }
+
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (!cacheLoaded) {
+            loadCache();
+        }
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for(int i = 0; i < files.count(); i++) {
+            TCheckedFile& file = files[i];
+            QHash<QString, TCachedDuration>::iterator it = cache.find(file.key);
+            if (it != cache.end()) {
+                file.ms = it->ms;
+                // Only rewrite the cache for a new last used time once a day
+                if (now - it->lastUsed > LAST_USED_RESOLUTION) {
+                    it->lastUsed = now;
+                    cacheModified = true;
+                }
+            }
+        }
+        checked = files;
+    }
+
+    QMetaObject::invokeMethod(this, "onCacheChecked", Qt::QueuedConnection);
+}
+
+void TDurationProber::onCacheChecked() {
+
+    QList<TCheckedFile> files;
+    bool modified;
+    {
+        QMutexLocker locker(&cacheMutex);
+        files = checked;
+        checked.clear();
+        modified = cacheModified;
+    }
+    checking = false;
+    if (modified && !saveTimer->isActive()) {
+        saveTimer->start();
+    }
+
+    if (discardChecked) {
+        discardChecked = false;
+    } else {
+        for(int i = 0; i < files.count(); i++) {
+            const TCheckedFile& file = files.at(i);
+            if (file.ms < 0) {
+                toProbe.append(file);
+            } else if (file.ms > 0) {
+                emit durationProbed(file.filename, file.ms);
+            }
+        }
+    }
+    startNext();
+}
+
+void TDurationProber::startProc(const QString& filename, const QString& key) {
+
+    using namespace Settings;
+    QStringList args;
+    if (pref->isMPV()) {
+        args << "--no-config" << "--quiet" << "--frames=0"
+             << "--vo=null" << "--ao=null" << "--no-sub"
+             << "--term-playing-msg=WZDURATION=${=duration}"
+             << "--" << filename;
+    } else {
+        args << "-noconfig" << "all" << "-quiet" << "-identify"
+             << "-frames" << "0" << "-vo" << "null" << "-ao" << "null"
+             << "-nosub" << "--" << filename;
+    }
+
+    QProcess* proc = new QProcess(this);
+    proc->setProperty("filename", filename);
+    proc->setProperty("key", key);
+    proc->setProcessChannelMode(QProcess::MergedChannels);
+    connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>
+                (&QProcess::finished),
+            this, &TDurationProber::onProcFinished);
+
+    QTimer* timeoutTimer = new QTimer(proc);
+    timeoutTimer->setSingleShot(true);
+    connect(timeoutTimer, &QTimer::timeout,
+            this, &TDurationProber::onProcTimeout);
+    timeoutTimer->start(PROBE_TIMEOUT);
+
+    WZTOBJ << "Probing" << filename;
+    procs.append(proc);
+    proc->start(pref->player_bin, args);
+}
+
+void TDurationProber::stopProc(QProcess* proc) {
+
+    procs.removeOne(proc);
+    proc->disconnect(this);
+    if (proc->state() != QProcess::NotRunning) {
+        proc->kill();
+        proc->waitForFinished(1000);
+    }
+    proc->deleteLater();
+}
+
+int TDurationProber::parseDuration(const QByteArray& output) {
+
+    static QRegExp rx("^(?:WZDURATION|ID_LENGTH)=([0-9.]+)\\s*$");
+
+    QList<QByteArray> lines = output.split('\n');
+    for(int i = lines.count() - 1; i >= 0; i--) {
+        if (rx.indexIn(QString::fromLocal8Bit(lines.at(i))) >= 0) {
+            return qRound(rx.cap(1).toDouble() * 1000);
+        }
+    }
+    return 0;
+}
+
+void TDurationProber::onProcFinished(int exitCode, QProcess::ExitStatus) {
+
+    QProcess* proc = qobject_cast<QProcess*>(sender());
+    if (!proc) {
+        return;
+    }
+
+    QString filename = proc->property("filename").toString();
+    int ms = parseDuration(proc->readAll());
+    WZTOBJ << "Probed" << filename << "exit code" << exitCode
+           << "duration" << ms << "ms";
+
+    // Also cache failures, to not probe unplayable files again
+    {
+        QMutexLocker locker(&cacheMutex);
+        TCachedDuration& cached = cache[proc->property("key").toString()];
+        cached.ms = ms;
+        cached.lastUsed = QDateTime::currentMSecsSinceEpoch();
+        cacheModified = true;
+    }
+    saveTimer->start();
+
+    stopProc(proc);
+    if (ms > 0) {
+        emit durationProbed(filename, ms);
+    }
+    nextTimer->start();
+}
+
+void TDurationProber::onProcTimeout() {
+
+    QTimer* timer = qobject_cast<QTimer*>(sender());
+    QProcess* proc = timer ? qobject_cast<QProcess*>(timer->parent()) : 0;
+    if (proc) {
+        // Do not cache the timeout, a slow mount can be fast next time
+        WZWARNOBJ("Probing '" + proc->property("filename").toString()
+                  + "' takes too long, giving up");
+        stopProc(proc);
+        nextTimer->start();
+    }
+}
+
+// Called with cacheMutex locked
+void TDurationProber::loadCache() {
+
+    cacheLoaded = true;
+    QFile file(Settings::TPaths::durationCacheFileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        WZWARNOBJ("Ignoring duration cache '" + file.fileName()
+                  + "' with unknown format");
+        return;
+    }
+    QHash<QString, TCachedDuration> loaded;
+    qint32 count;
+    in >> count;
+    loaded.reserve(count);
+    for(int i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString key;
+        TCachedDuration cached;
+        in >> key >> cached.ms >> cached.lastUsed;
+        loaded.insert(key, cached);
+    }
+    if (in.status() == QDataStream::Ok) {
+        // Keep results of probes finished before the cache was loaded
+        QHash<QString, TCachedDuration>::const_iterator i = cache.constBegin();
+        while (i != cache.constEnd()) {
+            loaded.insert(i.key(), i.value());
+            ++i;
+        }
+        cache = loaded;
+        WZDOBJ << "Loaded" << cache.count() << "durations from"
+               << file.fileName();
+    } else {
+        WZWARNOBJ("Failed to read duration cache '" + file.fileName() + "'");
+    }
+}
+
+// Keep the cache from growing without bounds by dropping the least recently
+// used durations. Called with cacheMutex locked.
+void TDurationProber::pruneCache() {
+
+    if (cache.count() <= MAX_CACHED_DURATIONS) {
+        return;
+    }
+
+    QVector<qint64> used;
+    used.reserve(cache.count());
+    QHash<QString, TCachedDuration>::const_iterator c = cache.constBegin();
+    while (c != cache.constEnd()) {
+        used.append(c->lastUsed);
+        ++c;
+    }
+
+    // Drop the durations used before the MAX_CACHED_DURATIONS most recent
+    std::nth_element(used.begin(), used.end() - MAX_CACHED_DURATIONS,
+                     used.end());
+    qint64 oldest = *(used.end() - MAX_CACHED_DURATIONS);
+    int dropped = 0;
+    QHash<QString, TCachedDuration>::iterator i = cache.begin();
+    while (i != cache.end()) {
+        if (i->lastUsed < oldest) {
+            i = cache.erase(i);
+            dropped++;
+        } else {
+            ++i;
+        }
+    }
+    WZDOBJ << "Dropped" << dropped << "least recently used durations";
+}
+
+void TDurationProber::saveCache() {
+
+    saveTimer->stop();
+
+    // Write a copy, to not block the cache checks while writing
+    QHash<QString, TCachedDuration> copy;
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (!cacheModified) {
+            return;
+        }
+        cacheModified = false;
+        pruneCache();
+        copy = cache;
+    }
+
+    QString filename = Settings::TPaths::durationCacheFileName();
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        WZWARNOBJ("Failed to open duration cache '" + filename + "'. "
+                  + file.errorString());
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << CACHE_MAGIC << CACHE_VERSION << static_cast<qint32>(copy.count());
+    QHash<QString, TCachedDuration>::const_iterator i = copy.constBegin();
+    while (i != copy.constEnd()) {
+        out << i.key() << i->ms << i->lastUsed;
+        ++i;
+    }
+
+    if (file.commit()) {
+        WZDOBJ << "Saved" << copy.count() << "durations to" << filename;
+    } else {
+        WZWARNOBJ("Failed to save duration cache '" + filename + "'. "
+                  + file.errorString());
+    }
+}
+
+} // namespace Playlist
+} // namespace Gui
+
+#include "moc_durationprober.cpp"
@@ -0,0 +1,110 @@
+#ifndef GUI_PLAYLIST_DURATIONPROBER_H
+#define GUI_PLAYLIST_DURATIONPROBER_H
+
+#include "wzdebug.h"
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QProcess>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+
+class QFileInfo;
+class QTimer;
+
+
+namespace Gui {
+namespace Playlist {
+
+// Gets the duration of files in the background by running the player
+// without audio and video output. Durations are cached in a file in the data
+// directory, keyed by the path, size and modification time of the file.
+// The least recently used durations are dropped when the cache grows too
+// large. The number of player processes running at the same time is limited
+// by setMaxProcs(), so probing can be paused while the player has a file
+// open. Queued files are stat'ed and looked up in the cache in batches by a
+// task in a thread pool, only when the files checked by the previous batch
+// are running out.
+class TDurationProber : public QObject {
+    Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
+public:
+    explicit TDurationProber(QObject* parent);
+    virtual ~TDurationProber() override;
+
+    // Queue filename for probing
+    void probe(const QString& filename);
+    // Probe filenames before the queued files, replacing the filenames
+    // passed by the previous call, like the items visible before scrolling
+    void probeFirst(const QStringList& filenames);
+    // Forget the queued files. Running probes and cache checks finish.
+    void clear();
+    // Maximum number of probes running at the same time, 0 pauses probing.
+    // Probes above the maximum are stopped and probed again later.
+    void setMaxProcs(int max);
+
+signals:
+    void durationProbed(const QString& filename, int ms);
+
+private:
+    friend class TCacheCheckTask;
+
+    // File with the key it has in the cache
+    struct TCheckedFile {
+        QString filename;
+        QString key;
+        // Cached duration or -1 when not in the cache
+        int ms;
+    };
+
+    QStringList queue;
+    QStringList firstQueue;
+    QSet<QString> queued;
+    int maxProcs;
+    QList<QProcess*> procs;
+    QTimer* nextTimer;
+
+    // Checked files not in the cache, waiting for a process
+    QList<TCheckedFile> toProbe;
+    QThreadPool pool;
+    bool checking;
+    bool discardChecked;
+    // Results of the running check, guarded by cacheMutex
+    QList<TCheckedFile> checked;
+
+    struct TCachedDuration {
+        TCachedDuration() : ms(0), lastUsed(0) {}
+        int ms;
+        qint64 lastUsed;
+    };
+
+    // Guards cache, cacheLoaded, cacheModified and checked, used by the pool
+    QMutex cacheMutex;
+    QHash<QString, TCachedDuration> cache;
+    bool cacheLoaded;
+    bool cacheModified;
+    QTimer* saveTimer;
+
+    static QString fileKey(const QFileInfo& fi);
+    void loadCache();
+    void pruneCache();
+    void checkCache(const QStringList& filenames);
+    void startProc(const QString& filename, const QString& key);
+    void stopProc(QProcess* proc);
+    static int parseDuration(const QByteArray& output);
+
+private slots:
+    void startNext();
+    void onCacheChecked();
+    void onProcFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcTimeout();
+    void saveCache();
+};
+
+} // namespace Playlist
+} // namespace Gui
+
+#endif // GUI_PLAYLIST_DURATIONPROBER_H
@@ -40,7 +40,7 @@ TFavList::TFavList(TDockWidget *parent, TPlaylist* playlst) :
     // Load favorites action
     loadFavoritesAction = new Action::TAction(this, "fav_load",
                                               tr("Load favorites"), "noicon");
-    loadFavoritesAction->setIcon(iconProvider.openIcon);
+    loadFavoritesAction->setIcon(iconProvider.openIcon());
     connect(loadFavoritesAction, &Action::TAction::triggered,
             this, &TFavList::loadFavorites);
     // Load favorites when loading of media done
@@ -314,7 +314,7 @@ void TFavList::markCurrentFavAction(QAction* action) {
         currentFavAction = action;
         if (currentFavAction) {
             currentFavIcon = action->icon();
-            currentFavAction->setIcon(iconProvider.iconPlaying);
+            currentFavAction->setIcon(iconProvider.iconPlaying());
         }
     }
 }
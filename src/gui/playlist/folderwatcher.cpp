@@ -0,0 +1,295 @@
+#include "gui/playlist/folderwatcher.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QRunnable>
+#include <QTimer>
+
+
+namespace Gui {
+namespace Playlist {
+
+// Report changes when no new changes arrived for CHANGED_DELAY ms, but do
+// not postpone them for more than MAX_CHANGED_DELAY ms
+const int CHANGED_DELAY = 1000;
+const int MAX_CHANGED_DELAY = 5000;
+// Number of directories polled every POLL_INTERVAL ms
+const int POLL_BATCH = 100;
+const int POLL_INTERVAL = 2000;
+
+// Compares the modification time of the directories with the time they
+// had when they were listed or last polled. Reports the changed directories
+// with their new modification time. A poll is always reported, so the next
+// poll can start.
+class TVerifyTask : public QRunnable {
+public:
+    TVerifyTask(TFolderWatcher* aWatcher,
+                const QHash<QString, qint64>& aDirs,
+                bool aPoll) :
+        watcher(aWatcher),
+        dirs(aDirs),
+        poll(aPoll) {
+    }
+
+    virtual void run() override {
+
+        QVariantHash changed;
+        QHash<QString, qint64>::const_iterator i = dirs.constBegin();
+        while (i != dirs.constEnd()) {
+            qint64 m = TFolderWatcher::modified(i.key());
+            if (m != i.value()) {
+                changed.insert(i.key(), m);
+            }
+            ++i;
+        }
+        if (poll || !changed.isEmpty()) {
+            QMetaObject::invokeMethod(watcher, "onVerified",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QVariantHash, changed),
+                                      Q_ARG(bool, poll));
+        }
+    }
+
+private:
+    TFolderWatcher* watcher;
+    QHash<QString, qint64> dirs;
+    bool poll;
+};
+
+TFolderWatcher::TFolderWatcher(QObject* parent) :
+    QObject(parent),
+    pollIndex(0),
+    polling(false) {
+
+    setObjectName("folder_watcher");
+
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::directoryChanged,
+            this, &TFolderWatcher::onDirectoryChanged);
+
+    changedTimer = new QTimer(this);
+    changedTimer->setSingleShot(true);
+    changedTimer->setInterval(CHANGED_DELAY);
+    connect(changedTimer, &QTimer::timeout,
+            this, &TFolderWatcher::onChangedTimeout);
+
+    pollTimer = new QTimer(this);
+    pollTimer->setInterval(POLL_INTERVAL);
+    connect(pollTimer, &QTimer::timeout,
+            this, &TFolderWatcher::poll);
+
+    pool.setMaxThreadCount(1);
+}
+
+TFolderWatcher::~TFolderWatcher() {
+    pool.waitForDone();
+}
+
+qint64 TFolderWatcher::modified(const QString& dir) {
+
+    QDateTime lastModified = QFileInfo(dir).lastModified();
+    return lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : -1;
+}
+
+void TFolderWatcher::setFolders(const QHash<QString, qint64>& dirs) {
+
+    bool pollChanged = false;
+    QStringList removed;
+    foreach(const QString& dir, folders) {
+        if (!dirs.contains(dir)) {
+            changed.remove(dir);
+            if (polled.remove(dir)) {
+                pollChanged = true;
+            } else {
+                removed.append(dir);
+            }
+        }
+    }
+    if (!removed.isEmpty()) {
+        watcher->removePaths(removed);
+    }
+
+    QHash<QString, qint64> added;
+    QHash<QString, qint64>::const_iterator i = dirs.constBegin();
+    while (i != dirs.constEnd()) {
+        if (!folders.contains(i.key())) {
+            added.insert(i.key(), i.value());
+        }
+        ++i;
+    }
+    folders = dirs.keys().toSet();
+
+    if (pollChanged) {
+        updatePollQueue();
+    }
+    watch(added);
+}
+
+void TFolderWatcher::addFolders(const QHash<QString, qint64>& dirs) {
+
+    QHash<QString, qint64> added;
+    QHash<QString, qint64>::const_iterator i = dirs.constBegin();
+    while (i != dirs.constEnd()) {
+        if (!folders.contains(i.key())) {
+            folders.insert(i.key());
+            added.insert(i.key(), i.value());
+        }
+        ++i;
+    }
+    watch(added);
+}
+
+// Add the new directories in dirs to watcher or to the polled directories
+void TFolderWatcher::watch(const QHash<QString, qint64>& dirs) {
+
+    if (dirs.isEmpty()) {
+        return;
+    }
+
+    QStringList failed = watcher->addPaths(dirs.keys());
+    if (!failed.isEmpty()) {
+        WZWARNOBJ(QString("Failed to watch %1 directories, polling them"
+                          " instead").arg(failed.count()));
+        // Polling compares against the time of listing
+        for(int i = 0; i < failed.count(); i++) {
+            polled.insert(failed.at(i), dirs.value(failed.at(i)));
+        }
+        updatePollQueue();
+    }
+
+    // Check the watched directories for changes made before watching them
+    if (failed.count() < dirs.count()) {
+        QHash<QString, qint64> watched = dirs;
+        for(int i = 0; i < failed.count(); i++) {
+            watched.remove(failed.at(i));
+        }
+        pool.start(new TVerifyTask(this, watched, false));
+    }
+
+    WZDOBJ << "Watching" << folders.count() - polled.count()
+           << "directories, polling" << polled.count();
+}
+
+void TFolderWatcher::updatePollQueue() {
+
+    pollQueue = polled.keys();
+    pollIndex = 0;
+    if (pollQueue.isEmpty()) {
+        pollTimer->stop();
+    } else if (!pollTimer->isActive()) {
+        pollTimer->start();
+    }
+}
+
+void TFolderWatcher::clear() {
+
+    QStringList watched = watcher->directories();
+    if (!watched.isEmpty()) {
+        watcher->removePaths(watched);
+    }
+    folders.clear();
+    polled.clear();
+    pollQueue.clear();
+    pollIndex = 0;
+    pollTimer->stop();
+    changed.clear();
+    changedTimer->stop();
+}
+
+void TFolderWatcher::onDirectoryChanged(const QString& dir) {
+
+    if (!folders.contains(dir)) {
+        return;
+    }
+    if (changed.isEmpty()) {
+        firstChange.start();
+    }
+    changed.insert(dir);
+
+    // Restart the timer while changes keep coming in, up to a limit
+    if (!changedTimer->isActive()
+            || firstChange.elapsed() < MAX_CHANGED_DELAY) {
+        changedTimer->start();
+    }
+}
+
+void TFolderWatcher::onVerified(const QVariantHash& dirs, bool poll) {
+
+    if (poll) {
+        polling = false;
+    }
+
+    QVariantHash::const_iterator i = dirs.constBegin();
+    while (i != dirs.constEnd()) {
+        // Polled directories are compared against the last polled time.
+        // Ignore polled directories removed while polling.
+        QHash<QString, qint64>::iterator it = polled.find(i.key());
+        if (it != polled.end()) {
+            it.value() = i.value().toLongLong();
+        }
+        if (!poll || it != polled.end()) {
+            WZDOBJ << (poll ? "Polled change of" : "Changed before watching")
+                   << i.key();
+            onDirectoryChanged(i.key());
+        }
+        ++i;
+    }
+}
+
+void TFolderWatcher::onChangedTimeout() {
+
+    QStringList dirs = changed.toList();
+    changed.clear();
+
+    // QFileSystemWatcher stops watching removed directories. Forget them,
+    // so setFolders() watches them again when they reappear.
+    bool pollChanged = false;
+    for(int i = 0; i < dirs.count(); i++) {
+        const QString& dir = dirs.at(i);
+        if (!QFileInfo(dir).isDir()) {
+            folders.remove(dir);
+            if (polled.remove(dir)) {
+                pollChanged = true;
+            }
+        }
+    }
+    if (pollChanged) {
+        updatePollQueue();
+    }
+
+    WZDOBJ << "Changed" << dirs;
+    emit foldersChanged(dirs);
+}
+
+// Stat'ing directories on a slow network share can take a while, so poll
+// the next batch in the pool. Skip the poll while the previous batch is
+// still running.
+void TFolderWatcher::poll() {
+
+    if (polling) {
+        return;
+    }
+
+    QHash<QString, qint64> batch;
+    int count = qMin(POLL_BATCH, pollQueue.count());
+    for(int i = 0; i < count; i++) {
+        if (pollIndex >= pollQueue.count()) {
+            pollIndex = 0;
+        }
+        const QString& dir = pollQueue.at(pollIndex++);
+        QHash<QString, qint64>::const_iterator it = polled.constFind(dir);
+        if (it != polled.constEnd()) {
+            batch.insert(dir, it.value());
+        }
+    }
+    if (!batch.isEmpty()) {
+        polling = true;
+        pool.start(new TVerifyTask(this, batch, true));
+    }
+}
+
+} // namespace Playlist
+} // namespace Gui
+
+#include "moc_folderwatcher.cpp"
@@ -0,0 +1,81 @@
+#ifndef GUI_PLAYLIST_FOLDERWATCHER_H
+#define GUI_PLAYLIST_FOLDERWATCHER_H
+
+#include "wzdebug.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariant>
+
+class QFileSystemWatcher;
+class QTimer;
+
+
+namespace Gui {
+namespace Playlist {
+
+// Watches the directories of the playlist for changes. Changes are collected
+// until no new changes arrived for a short while, so copying a lot of files
+// into a directory is reported by a few foldersChanged() signals. When the
+// system runs out of watches, the remaining directories are polled in
+// batches by a task in a thread pool, comparing their modification time.
+//
+// The directories are passed with their modification time from before they
+// were listed. After adding the watches, a task in a thread pool compares
+// it with the current modification time, so changes made between listing
+// and watching a directory are reported too.
+class TFolderWatcher : public QObject {
+    Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
+public:
+    explicit TFolderWatcher(QObject* parent);
+    virtual ~TFolderWatcher() override;
+
+    // Watch the directories in dirs and stop watching all others
+    void setFolders(const QHash<QString, qint64>& dirs);
+    // Watch the directories in dirs too
+    void addFolders(const QHash<QString, qint64>& dirs);
+    void clear();
+
+signals:
+    void foldersChanged(const QStringList& dirs);
+
+private:
+    friend class TVerifyTask;
+
+    QFileSystemWatcher* watcher;
+    QSet<QString> folders;
+
+    // Directories not accepted by watcher with their modification time
+    QHash<QString, qint64> polled;
+    QStringList pollQueue;
+    int pollIndex;
+    QTimer* pollTimer;
+    // A poll is running in pool
+    bool polling;
+
+    QSet<QString> changed;
+    QElapsedTimer firstChange;
+    QTimer* changedTimer;
+
+    QThreadPool pool;
+
+    static qint64 modified(const QString& dir);
+    void watch(const QHash<QString, qint64>& dirs);
+    void updatePollQueue();
+
+private slots:
+    void onDirectoryChanged(const QString& dir);
+    void onVerified(const QVariantHash& dirs, bool poll);
+    void onChangedTimeout();
+    void poll();
+};
+
+} // namespace Playlist
+} // namespace Gui
+
+#endif // GUI_PLAYLIST_FOLDERWATCHER_H
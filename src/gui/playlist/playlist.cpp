@@ -19,6 +19,8 @@
 #include "gui/playlist/playlist.h"
 #include "gui/playlist/playlistwidget.h"
 #include "gui/playlist/playlistitem.h"
+#include "gui/playlist/durationprober.h"
+#include "gui/playlist/folderwatcher.h"
 #include "gui/mainwindow.h"
 #include "gui/action/action.h"
 #include "gui/action/editabletoolbar.h"
@@ -30,10 +32,14 @@
 #include "extensions.h"
 #include "iconprovider.h"
 #include "name.h"
+#include "starttrace.h"
 
+#include <QDir>
 #include <QToolBar>
 #include <QMimeData>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QTimer>
 
 
 namespace Gui {
@@ -82,10 +88,167 @@ TPlaylist::TPlaylist(TDockWidget* parent) :
     connect(playlistWidget, &TPlaylistWidget::latestDirChanged,
             this, &TPlaylist::onLatestDirChanged);
 
-    // Random seed
-    QTime t;
-    t.start();
-    qsrand(t.hour() * 3600 + t.minute() * 60 + t.second());
+    // Fill in the length column in the background, visible items first
+    durationProber = new TDurationProber(this);
+    connect(durationProber, &TDurationProber::durationProbed,
+            this, &TPlaylist::onDurationProbed);
+    probeVisibleTimer = new QTimer(this);
+    probeVisibleTimer->setSingleShot(true);
+    probeVisibleTimer->setInterval(200);
+    connect(probeVisibleTimer, &QTimer::timeout,
+            this, &TPlaylist::probeVisibleItems);
+    connect(playlistWidget, &TPlaylistWidget::addedItems,
+            this, &TPlaylist::onAddedItems);
+    connect(playlistWidget, &TPlaylistWidget::refreshedItems,
+            this, &TPlaylist::onAddedItems);
+    connect(playlistWidget->verticalScrollBar(), &QScrollBar::valueChanged,
+            probeVisibleTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(playlistWidget, &TPlaylistWidget::itemExpanded,
+            probeVisibleTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+    // Keep playlists opened from a directory in sync with the disk
+    folderWatcher = new TFolderWatcher(this);
+    connect(folderWatcher, &TFolderWatcher::foldersChanged,
+            this, &TPlaylist::onFoldersChanged);
+    connect(playlistWidget, &TPlaylistWidget::refreshAborted,
+            this, &TPlaylist::onRefreshAborted);
+    connect(playlistWidget, &TPlaylistWidget::busyChanged,
+            this, &TPlaylist::refreshChangedFolders, Qt::QueuedConnection);
+}
+
+static bool needsDuration(TPlaylistItem* item) {
+    return !item->isFolder() && !item->isUrl() && item->durationMS() <= 0;
+}
+
+// Directory items, excluding playlists
+static bool isDirectory(TPlaylistItem* item) {
+    return item->isFolder() && !item->isPlaylist() && !item->isUrl()
+            && !item->filename().isEmpty();
+}
+
+// Queue item and its children for probing
+void TPlaylist::probeAddedItem(TPlaylistItem* item) {
+
+    if (needsDuration(item)) {
+        durationProber->probe(item->filename());
+    }
+    for(int i = 0; i < item->childCount(); i++) {
+        probeAddedItem(item->plChild(i));
+    }
+}
+
+void TPlaylist::onAddedItems(const QList<QTreeWidgetItem*>& items,
+                             const QHash<QString, qint64>& dirs) {
+
+    // The files still queued belong to the replaced playlist
+    bool replaced = items.count() == 1
+            && items.at(0) == playlistWidget->root();
+    if (replaced) {
+        durationProber->clear();
+    }
+
+    for(int i = 0; i < items.count(); i++) {
+        probeAddedItem(static_cast<TPlaylistItem*>(items.at(i)));
+    }
+    probeVisibleTimer->start();
+
+    // Only watch playlists opened from a directory
+    if (!Settings::pref->autoRefreshPlaylist
+            || !isDirectory(playlistWidget->root())) {
+        folderWatcher->clear();
+    } else if (replaced) {
+        folderWatcher->setFolders(dirs);
+    } else {
+        folderWatcher->addFolders(dirs);
+    }
+}
+
+void TPlaylist::onFoldersChanged(const QStringList& dirs) {
+
+    for(int i = 0; i < dirs.count(); i++) {
+        if (!changedFolders.contains(dirs.at(i))) {
+            changedFolders.append(dirs.at(i));
+        }
+    }
+    refreshChangedFolders();
+}
+
+void TPlaylist::onRefreshAborted(const QString& dir) {
+
+    if (!changedFolders.contains(dir)) {
+        changedFolders.prepend(dir);
+    }
+}
+
+// Find the directory item of dir. For a directory not in the playlist, like
+// a directory without playable items, find the directory containing it.
+TPlaylistItem* TPlaylist::findChangedFolder(QString dir) {
+
+    QString rootDir = playlistWidget->root()->filename();
+    while (true) {
+        TPlaylistItem* folder = playlistWidget->findFilename(dir);
+        if (folder) {
+            return isDirectory(folder) ? folder : 0;
+        }
+        QString parent = QDir::toNativeSeparators(QFileInfo(dir).path());
+        if (parent == dir || parent.length() < rootDir.length()) {
+            return 0;
+        }
+        dir = parent;
+    }
+}
+
+// Apply the changes on disk to the folders in changedFolders, one folder at
+// a time. The add files thread of the playlist widget lists the folder.
+void TPlaylist::refreshChangedFolders() {
+
+    if (!Settings::pref->autoRefreshPlaylist) {
+        changedFolders.clear();
+        return;
+    }
+
+    while (!changedFolders.isEmpty() && !playlistWidget->isBusy()) {
+        TPlaylistItem* folder = findChangedFolder(changedFolders.takeFirst());
+        if (folder == 0) {
+            continue;
+        }
+        if (folder == playlistWidget->root() && folder->childCount() == 0) {
+            // Adding to an empty root replaces the root
+            changedFolders.clear();
+            refresh();
+            return;
+        }
+        playlistWidget->refreshFolder(folder);
+    }
+}
+
+// Probe the next item to play and the visible items first
+void TPlaylist::probeVisibleItems() {
+
+    QStringList files;
+    TPlaylistItem* next = playlistWidget->getNextPlaylistItem();
+    if (next && needsDuration(next)) {
+        files.append(next->filename());
+    }
+
+    int bottom = playlistWidget->viewport()->height();
+    QTreeWidgetItem* w = playlistWidget->itemAt(0, 0);
+    while (w && playlistWidget->visualItemRect(w).top() < bottom) {
+        TPlaylistItem* item = static_cast<TPlaylistItem*>(w);
+        if (needsDuration(item)) {
+            files.append(item->filename());
+        }
+        w = playlistWidget->itemBelow(w);
+    }
+    durationProber->probeFirst(files);
+}
+
+void TPlaylist::onDurationProbed(const QString& filename, int ms) {
+
+    TPlaylistItem* item = playlistWidget->findFilename(filename);
+    if (item && item->durationMS() <= 0) {
+        item->setDurationMSEmit(ms);
+    }
 }
 
 void TPlaylist::onNothingToPlay(QString msg) {
@@ -244,6 +407,10 @@ QString TPlaylist::getPlayingTitle(bool addModified,
 
 void TPlaylist::onStateChanged(Player::TState state) {
 
+    // Keep probing durations out of the way of the player, only probe
+    // while it has no file open
+    durationProber->setMaxProcs(state == Player::STATE_STOPPED ? 2 : 0);
+
     TPlaylistItem* item = playlistWidget->playingItem;
     if (!item) {
         WZTRACE("No playing item");
@@ -326,6 +493,8 @@ void TPlaylist::clear(bool clearFilename) {
 
     dvdTitle = "";
     dvdSerial = "";
+    folderWatcher->clear();
+    changedFolders.clear();
     TPList::clear(clearFilename);
 }
 
@@ -376,7 +545,28 @@ void TPlaylist::onNewFileStartedPlaying() {
     // enableActions().
     // playlistWidget->setPlayingItem(playingItem, PSTATE_PLAYING);
 
-    return;
+    prefetchNextItem();
+}
+
+// Tell the player which item playNext() will select at the end of the
+// playing item
+void TPlaylist::prefetchNextItem() {
+
+    // The random pick of shuffle is not known in advance
+    if (shuffleAct->isChecked()) {
+        return;
+    }
+
+    TPlaylistItem* item = playlistWidget->getNextPlaylistItem();
+    if (item == 0 && repeatAct->isChecked()) {
+        item = playlistWidget->firstPlaylistItem();
+    }
+    while (item && item->isFolder()) {
+        item = playlistWidget->getNextPlaylistItem(item);
+    }
+    if (item && item != playlistWidget->playingItem) {
+        player->setNextMedia(item->filename());
+    }
 }
 
 bool TPlaylist::onNewDiscStartedPlaying() {
@@ -746,6 +936,7 @@ void TPlaylist::saveSettings() {
 }
 
 void TPlaylist::loadSettings() {
+    WZSTARTTRACE("TPlaylist::loadSettings");
 
     TPList::loadSettings();
     Settings::pref->beginGroup(objectName());
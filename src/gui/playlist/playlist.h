@@ -22,8 +22,12 @@
 #include "player/state.h"
 #include "wzdebug.h"
 
+#include <QHash>
+
 
 class TDiscName;
+class QTimer;
+class QTreeWidgetItem;
 
 namespace Gui {
 
@@ -37,6 +41,8 @@ class TAction;
 namespace Playlist {
 
 class TPlaylistItem;
+class TDurationProber;
+class TFolderWatcher;
 
 
 class TPlaylist : public TPList {
@@ -82,6 +88,13 @@ private:
     QString dvdTitle;
     QString dvdSerial;
 
+    TDurationProber* durationProber;
+    QTimer* probeVisibleTimer;
+
+    TFolderWatcher* folderWatcher;
+    // Changed folders waiting for the playlist widget to be no longer busy
+    QStringList changedFolders;
+
     void createToolbar();
 
     bool haveUnplayedItems() const;
@@ -90,6 +103,9 @@ private:
 
     void onNewFileStartedPlaying();
     bool onNewDiscStartedPlaying();
+    void prefetchNextItem();
+    void probeAddedItem(TPlaylistItem* item);
+    TPlaylistItem* findChangedFolder(QString dir);
 
 private slots:
     void onRepeatToggled(bool toggled);
@@ -104,6 +120,15 @@ private slots:
 
     void onNothingToPlay(QString msg);
     void onLatestDirChanged(QString dir);
+
+    void onAddedItems(const QList<QTreeWidgetItem*>& items,
+                      const QHash<QString, qint64>& dirs);
+    void probeVisibleItems();
+    void onDurationProbed(const QString& filename, int ms);
+
+    void onFoldersChanged(const QStringList& dirs);
+    void onRefreshAborted(const QString& dir);
+    void refreshChangedFolders();
 };
 
 } // namespace Playlist
@@ -15,6 +15,8 @@
 #include <QMessageBox>
 #include <QTimer>
 #include <QStack>
+#include <QMutex>
+#include <QSet>
 
 
 namespace Gui {
@@ -45,6 +47,8 @@ TPlaylistItem::TPlaylistItem() :
     QTreeWidgetItem(USER_TYPE),
     mDurationMS(0),
     mOrder(1),
+    mPlayedTime(0),
+    mState(PSTATE_STOPPED),
     mFolder(true),
     mPlaylist(false),
     mWZPlaylist(false),
@@ -52,20 +56,12 @@ TPlaylistItem::TPlaylistItem() :
     mURL(false),
     mEditURL(false),
     mDisc(false),
-    mState(PSTATE_STOPPED),
     mPlayed(false),
     mEdited(false),
-    mModified(false),
-    mPlayedTime(0) {
+    mModified(false) {
 
     setFlags(ROOT_FLAGS);
-    setTextAlignment(COL_NAME, TEXT_ALIGN_NAME);
-    setTextAlignment(COL_EXT, TEXT_ALIGN_TYPE);
-    setTextAlignment(COL_LENGTH, TEXT_ALIGN_TIME);
-    setTextAlignment(COL_ORDER, TEXT_ALIGN_ORDER);
-
-    itemIcon = iconProvider.folderIcon;
-    setIcon(COL_NAME, itemIcon);
+    itemIcon = iconProvider.folderIcon();
 }
 
 // Copy constructor
@@ -77,36 +73,29 @@ TPlaylistItem::TPlaylistItem(const TPlaylistItem& item) :
     mFilename(item.filename()),
     mBaseName(item.baseName()),
     mExt(item.extension()),
+    mTarget(item.target()),
     mDurationMS(item.durationMS()),
     mOrder(item.order()),
+    mPlayedTime(item.playedTime()),
+    mState(item.state()),
 
     mFolder(item.isFolder()),
     mPlaylist(item.isPlaylist()),
     mWZPlaylist(item.isWZPlaylist()),
     mSymLink(item.isSymLink()),
-    mTarget(item.target()),
     mURL(item.isUrl()),
     mEditURL(item.editURL()),
     mDisc(item.isDisc()),
 
-    mState(item.state()),
     mPlayed(item.played()),
     mEdited(item.edited()),
     mModified(item.modified()),
-    mPlayedTime(item.playedTime()),
     mBlacklist(item.getBlacklist()),
 
     itemIcon(item.itemIcon) {
 
     // Setup base QTreeWidgetItem
     setFlags(item.flags());
-
-    setTextAlignment(COL_NAME, TEXT_ALIGN_NAME);
-    setTextAlignment(COL_EXT, TEXT_ALIGN_TYPE);
-    setTextAlignment(COL_LENGTH, TEXT_ALIGN_TIME);
-    setTextAlignment(COL_ORDER, TEXT_ALIGN_ORDER);
-
-    setIcon(COL_NAME, itemIcon);
 }
 
 TPlaylistItem::TPlaylistItem(QTreeWidgetItem* parent,
@@ -114,26 +103,27 @@ TPlaylistItem::TPlaylistItem(QTreeWidgetItem* parent,
                              const QString& name,
                              int durationMS,
                              bool protectName) :
-    QTreeWidgetItem(parent, USER_TYPE),
+    QTreeWidgetItem(USER_TYPE),
     mFilename(QDir::toNativeSeparators(filename)),
     mBaseName(name),
     mDurationMS(durationMS),
-    mEditURL(false),
+    mPlayedTime(0),
     mState(PSTATE_STOPPED),
+    mEditURL(false),
     mPlayed(false),
     mEdited(protectName),
-    mModified(false),
-    mPlayedTime(0) {
+    mModified(false) {
 
     if (parent) {
-        mOrder = parent->childCount();
+        mOrder = parent->childCount() + 1;
     } else {
         mOrder = 1;
     }
     if (mBaseName.isEmpty()) {
         mBaseName = TName::nameForURL(mFilename);
     }
-    setFileInfo();
+    // The icon depends on the parent, see isLink()
+    setFileInfo(false);
 
     Qt::ItemFlags flags = Qt::ItemIsSelectable
                           | Qt::ItemIsEnabled
@@ -144,15 +134,87 @@ TPlaylistItem::TPlaylistItem(QTreeWidgetItem* parent,
     }
     setFlags(flags);
 
-    setTextAlignment(COL_NAME, TEXT_ALIGN_NAME);
-    setTextAlignment(COL_EXT, TEXT_ALIGN_TYPE);
-    setTextAlignment(COL_LENGTH, TEXT_ALIGN_TIME);
-    setTextAlignment(COL_ORDER, TEXT_ALIGN_ORDER);
+    // Add to parent when complete, TPlaylistWidget::rowsInserted() uses it
+    if (parent) {
+        parent->addChild(this);
+        setItemIcon();
+        if (treeWidget()) {
+            setSizeHintName();
+        }
+    } else {
+        setItemIcon();
+    }
+}
 
-    setIcon(COL_NAME, itemIcon);
+TPlaylistItem::TPlaylistItem(QTreeWidgetItem* parent,
+                             const QString& filename,
+                             const QString& name,
+                             bool symLink,
+                             const QString& target) :
+    QTreeWidgetItem(USER_TYPE),
+    mFilename(QDir::toNativeSeparators(filename)),
+    mBaseName(name),
+    mTarget(target),
+    mDurationMS(0),
+    mPlayedTime(0),
+    mState(PSTATE_STOPPED),
+    mFolder(false),
+    mPlaylist(false),
+    mWZPlaylist(false),
+    mSymLink(symLink),
+    mURL(false),
+    mEditURL(false),
+    mDisc(false),
+    mPlayed(false),
+    mEdited(false),
+    mModified(false) {
 
-    if (treeWidget()) {
-        setSizeHintName();
+    if (parent) {
+        mOrder = parent->childCount() + 1;
+    } else {
+        mOrder = 1;
+    }
+    if (mBaseName.isEmpty()) {
+        mBaseName = TName::nameForURL(mFilename);
+    }
+
+    // Only string operations, like setFileInfo() for an existing file
+    QFileInfo fi(mSymLink ? mTarget : mFilename);
+    mExt = internExtension(fi.suffix().toLower());
+    if (!mExt.isEmpty() && mBaseName.endsWith(mExt, Qt::CaseInsensitive)) {
+        mBaseName = mBaseName.left(mBaseName.length() - mExt.length() - 1);
+    }
+
+    // The file is in the directory of its parent, so it is not a link
+    // in the sense of isLink()
+    itemIcon = iconProvider.fileIcon();
+    if (mSymLink) {
+        itemIcon = iconProvider.getIconSymLinked(itemIcon);
+    }
+
+    setFlags(Qt::ItemIsSelectable
+             | Qt::ItemIsEnabled
+             | Qt::ItemIsDragEnabled
+             | Qt::ItemIsEditable);
+
+    if (parent) {
+        parent->addChild(this);
+        if (treeWidget()) {
+            setSizeHintName();
+        }
+    }
+}
+
+TPlaylistItem::~TPlaylistItem() {
+
+    // Leave the tree while still complete. TPlaylistWidget reads the
+    // removed items in rowsAboutToBeRemoved().
+    QTreeWidgetItem* p = parent();
+    if (p) {
+        p->removeChild(this);
+    } else if (treeWidget()) {
+        treeWidget()->takeTopLevelItem(
+                    treeWidget()->indexOfTopLevelItem(this));
     }
 }
 
@@ -196,30 +258,30 @@ TPlaylistItem *TPlaylistItem::clone() const {
 void TPlaylistItem::setItemIcon() {
 
     if (mFolder) {
-        itemIcon = iconProvider.folderIcon;
+        itemIcon = iconProvider.folderIcon();
     } else if (mURL) {
         if (mDisc) {
             TDiscName disc(mFilename);
             switch (disc.disc()) {
                 case TDiscName::DVD:
                 case TDiscName::DVDNAV:
-                    itemIcon = iconProvider.dvdIcon;
+                    itemIcon = iconProvider.dvdIcon();
                     break;
                 case TDiscName::VCD:
-                    itemIcon = iconProvider.videoCDIcon;
+                    itemIcon = iconProvider.videoCDIcon();
                     break;
                 case TDiscName::CDDA:
-                    itemIcon = iconProvider.audioCDIcon;
+                    itemIcon = iconProvider.audioCDIcon();
                     break;
                 case TDiscName::BLURAY:
-                    itemIcon = iconProvider.brIcon;
+                    itemIcon = iconProvider.brIcon();
                     break;
             }
         } else {
-            itemIcon = iconProvider.urlIcon;
+            itemIcon = iconProvider.urlIcon();
         }
     } else {
-        itemIcon = iconProvider.fileIcon;
+        itemIcon = iconProvider.fileIcon();
     }
 
     if (mSymLink) {
@@ -236,7 +298,7 @@ void TPlaylistItem::setItemIcon() {
 }
 
 // Update fields depending on file name
-void TPlaylistItem::setFileInfo() {
+void TPlaylistItem::setFileInfo(bool updateIcon) {
 
     mURL = false;
     mDisc = false;
@@ -264,7 +326,7 @@ void TPlaylistItem::setFileInfo() {
             mPlaylist = false;
             mWZPlaylist = false;
         } else {
-            mExt = fi.suffix().toLower();
+            mExt = internExtension(fi.suffix().toLower());
             // Remove extension from base name
             if (!mExt.isEmpty()
                     && mBaseName.endsWith(mExt, Qt::CaseInsensitive)) {
@@ -305,7 +367,9 @@ void TPlaylistItem::setFileInfo() {
         }
     }
 
-    setItemIcon();
+    if (updateIcon) {
+        setItemIcon();
+    }
 }
 
 QString TPlaylistItem::stateString(TPlaylistItemState state) {
@@ -319,6 +383,24 @@ QString TPlaylistItem::stateString(TPlaylistItemState state) {
     return "failed";
 }
 
+// Share the few different extensions between all items. Items are also
+// created by TAddFilesThread, hence the mutex.
+QString TPlaylistItem::internExtension(const QString& ext) {
+
+    static QMutex mutex;
+    static QSet<QString> interned;
+
+    if (ext.isEmpty()) {
+        return ext;
+    }
+    QMutexLocker locker(&mutex);
+    QSet<QString>::const_iterator i = interned.constFind(ext);
+    if (i == interned.constEnd()) {
+        i = interned.insert(ext);
+    }
+    return *i;
+}
+
 QString TPlaylistItem::stateString() const {
     return stateString(mState);
 }
@@ -330,7 +412,9 @@ QString TPlaylistItem::tr(const char* s) {
 void TPlaylistItem::renameDir(const QString& dir, const QString& newDir) {
 
     if (mFilename.startsWith(dir)) {
+        QString old = mFilename;
         mFilename = newDir + mFilename.mid(dir.length());
+        filenameChanged(old);
     }
 
     for(int i = 0; i < childCount(); i++) {
@@ -575,6 +659,18 @@ QVariant TPlaylistItem::data(int column, int role) const {
                 return QVariant(mExt);
             }
         }
+    } else if (role == Qt::DecorationRole) {
+        if (column == COL_NAME) {
+            return QVariant(stateIcon());
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        // Not stored in the item, to not allocate data for every column
+        switch (column) {
+            case COL_NAME: return QVariant(TEXT_ALIGN_NAME);
+            case COL_EXT: return QVariant(TEXT_ALIGN_TYPE);
+            case COL_LENGTH: return QVariant(TEXT_ALIGN_TIME);
+            case COL_ORDER: return QVariant(TEXT_ALIGN_ORDER);
+        }
     }
     return QTreeWidgetItem::data(column, role);
 }
@@ -582,13 +678,16 @@ QVariant TPlaylistItem::data(int column, int role) const {
 void TPlaylistItem::setFilename(const QString& fileName,
                                 const QString& baseName) {
 
+    QString old = mFilename;
     mFilename = QDir::toNativeSeparators(fileName);
     mBaseName = baseName;
     setFileInfo();
+    filenameChanged(old);
 }
 
 void TPlaylistItem::setFilename(const QString& fileName) {
 
+    QString old = mFilename;
     mFilename = QDir::toNativeSeparators(fileName);
     if (mFilename.isEmpty()) {
         mBaseName = "";
@@ -596,6 +695,18 @@ void TPlaylistItem::setFilename(const QString& fileName) {
         mBaseName = TName::nameForURL(mFilename);
     }
     setFileInfo();
+    filenameChanged(old);
+}
+
+// Keep the filename index of the tree up to date
+void TPlaylistItem::filenameChanged(const QString& oldFilename) {
+
+    if (mFilename != oldFilename) {
+        TPlaylistWidget* tree = plTreeWidget();
+        if (tree) {
+            tree->updateFilenameIndex(this, oldFilename);
+        }
+    }
 }
 
 void TPlaylistItem::setName(const QString& baseName,
@@ -603,32 +714,24 @@ void TPlaylistItem::setName(const QString& baseName,
                             bool protectName) {
 
     mBaseName = baseName;
-    mExt = ext.toLower();
+    mExt = internExtension(ext.toLower());
     mEdited = protectName;
     setItemIcon();
-    setStateIcon();
+    emitDataChanged();
     setSizeHintName();
 }
 
-void TPlaylistItem::setStateIcon() {
+QIcon TPlaylistItem::stateIcon() const {
 
     switch (mState) {
-        case PSTATE_STOPPED:
+        case PSTATE_LOADING: return iconProvider.iconLoading();
+        case PSTATE_PLAYING: return iconProvider.iconPlaying();
+        case PSTATE_FAILED: return iconProvider.iconFailed();
+        default:
             if (mPlayed) {
-                setIcon(COL_NAME, iconProvider.iconPlayed);
-            } else {
-                setIcon(COL_NAME, itemIcon);
+                return iconProvider.iconPlayed();
             }
-            break;
-        case PSTATE_LOADING:
-            setIcon(COL_NAME, iconProvider.iconLoading);
-            break;
-        case PSTATE_PLAYING:
-            setIcon(COL_NAME, iconProvider.iconPlaying);
-            break;
-        case PSTATE_FAILED:
-            setIcon(COL_NAME, iconProvider.iconFailed);
-            break;
+            return itemIcon;
     }
 }
 
@@ -642,18 +745,30 @@ void TPlaylistItem::setState(TPlaylistItemState state) {
             .arg(stateString(mState)).arg(stateString(state)).arg(mBaseName));
 
     mState = state;
-    setStateIcon();
+    emitDataChanged();
+    updateUnplayedIndex();
 }
 
 void TPlaylistItem::setPlayed(bool played) {
 
     mPlayed = played;
     if (mState == PSTATE_STOPPED) {
-        if (mPlayed) {
-            setIcon(COL_NAME, iconProvider.iconPlayed);
-        } else {
-            setIcon(COL_NAME, itemIcon);
-        }
+        emitDataChanged();
+    }
+    updateUnplayedIndex();
+}
+
+void TPlaylistItem::setFolder(bool folder) {
+
+    mFolder = folder;
+    updateUnplayedIndex();
+}
+
+void TPlaylistItem::updateUnplayedIndex() {
+
+    TPlaylistWidget* tree = plTreeWidget();
+    if (tree) {
+        tree->updateUnplayedIndex(this);
     }
 }
 
@@ -777,7 +892,7 @@ TPlaylistWidget* TPlaylistItem::plTreeWidget() const {
 void TPlaylistItem::updateIcon() {
 
     setItemIcon();
-    setStateIcon();
+    emitDataChanged();
 }
 
 void TPlaylistItem::blacklist(const QString& filename) {
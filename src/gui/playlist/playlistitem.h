@@ -45,6 +45,15 @@ public:
                   const QString& name,
                   int durationMS,
                   bool protectName = false);
+    // Create an item for a media file found by listing a directory, using
+    // the file type from the listing instead of asking the file system again.
+    // Parent is the item of the listed directory.
+    TPlaylistItem(QTreeWidgetItem* parent,
+                  const QString& filename,
+                  const QString& name,
+                  bool symLink,
+                  const QString& target);
+    virtual ~TPlaylistItem() override;
 
     virtual QVariant data(int column, int role) const override;
     virtual void setData(int column, int role, const QVariant &value) override;
@@ -95,7 +104,7 @@ public:
     void setOrder(int order) { mOrder = order; }
 
     bool isFolder() const { return mFolder; }
-    void setFolder(bool folder) { mFolder = folder; }
+    void setFolder(bool folder);
     bool isPlaylist() const { return mPlaylist; }
     bool isWZPlaylist() const { return mWZPlaylist; }
     bool isSymLink() const { return mSymLink; }
@@ -148,48 +157,56 @@ private:
     static QString stateString(TPlaylistItemState state);
     static QString tr(const char* s);
 
+    // Playlists can hold a lot of items, keep them small. Flags are packed
+    // into bit fields, extensions are shared between items by
+    // internExtension() and the icon and text alignment are returned by
+    // data() instead of being stored by QTreeWidgetItem for every column.
     QString mFilename;
     QString mBaseName;
     QString mExt;
+    QString mTarget;
     int mDurationMS;
     int mOrder;
+    int mPlayedTime;
+    TPlaylistItemState mState;
 
     // Anything that can contain something else, like a directory, a playlist,
     // a disc, the root node.
-    bool mFolder;
+    bool mFolder : 1;
 
     // A local file or link to a local file with the extensio m3u8 or m3u
-    bool mPlaylist;
+    bool mPlaylist : 1;
 
     // A playlist with the name wzplayer.m3u8
-    bool mWZPlaylist;
+    bool mWZPlaylist : 1;
 
-    bool mSymLink;
-    QString mTarget;
+    bool mSymLink : 1;
 
-    bool mURL;
-    bool mEditURL;
+    bool mURL : 1;
+    bool mEditURL : 1;
 
-    bool mDisc; // Disc according to TDiscName
+    bool mDisc : 1; // Disc according to TDiscName
+
+    bool mPlayed : 1;
+    bool mEdited : 1;
+    bool mModified : 1;
 
-    TPlaylistItemState mState;
-    bool mPlayed;
-    bool mEdited;
-    bool mModified;
-    int mPlayedTime;
     QStringList mBlacklist;
 
     QIcon itemIcon;
-    void setStateIcon();
+    QIcon stateIcon() const;
+    static QString internExtension(const QString& ext);
 
     QSize getSizeHintName(int level) const;
 
     void renameDir(const QString& dir, const QString& newDir);
+    void filenameChanged(const QString& oldFilename);
+    void updateUnplayedIndex();
     bool renameFile(const QString& newName);
     bool rename(QString newName);
 
     void setItemIcon();
-    void setFileInfo();
+    void setFileInfo(bool updateIcon = true);
 };
 
 QDataStream& operator<<(QDataStream& out, const TPlaylistItem& item);
@@ -1,6 +1,7 @@
 ﻿#include "gui/playlist/playlistwidget.h"
 
 #include "gui/playlist/addfilesthread.h"
+#include "gui/playlist/dirscanner.h"
 #include "gui/playlist/playlistitem.h"
 #include "gui/mainwindow.h"
 #include "gui/msg.h"
@@ -12,6 +13,7 @@
 #include "iconprovider.h"
 #include "extensions.h"
 #include "wztimer.h"
+#include "starttrace.h"
 #include "wzdebug.h"
 
 #include <QHeaderView>
@@ -44,6 +46,15 @@ TPlaylistWidget::TPlaylistWidget(QWidget* parent,
     sortOrder(Qt::AscendingOrder),
     addFilesThread(0),
     addFilesRestartThread(false),
+    addFilesQuiet(false),
+    addFilesStreaming(false),
+    addFilesInsert(false),
+    addFilesParent(0),
+    addFilesIndex(0),
+    addFilesSortSection(-1),
+    addFilesSingleFolder(false),
+    addFilesKeepOrder(false),
+    addFilesItemCount(0),
     isFavList(favList),
     sortSectionSaved(-1),
     sortOrderSaved(Qt::AscendingOrder),
@@ -145,6 +156,7 @@ TPlaylistWidget::~TPlaylistWidget() {
     // Prevent onThreadFinished handling results
     addFilesThread = 0;
     abortFileCopier();
+    TDirScanner::saveCache();
 }
 
 void TPlaylistWidget::abort() {
@@ -168,6 +180,406 @@ void TPlaylistWidget::abortAddFilesThread() {
         addFilesRestartThread = false;
         addFilesThread->abort();
         addFilesThread = 0;
+        addFilesResetStream();
+    }
+}
+
+void TPlaylistWidget::addFilesResetStream() {
+
+    if (addFilesStreaming && addFilesInsert) {
+        setSort(addFilesSortSection, sortOrder);
+    }
+    addFilesStreaming = false;
+    addFilesInsert = false;
+    addFilesParent = 0;
+    addFilesIndex = 0;
+    addFilesInserted.clear();
+    addFilesSingleFolder = false;
+    addFilesFolders.clear();
+    addFilesKeepOrder = false;
+}
+
+bool TPlaylistWidget::addFilesProgress(int& items,
+                                       int& itemsPerSecond) const {
+
+    if (addFilesThread == 0 || addFilesQuiet || addFilesItemCount == 0) {
+        return false;
+    }
+    items = addFilesItemCount;
+    qint64 ms = addFilesTimer.elapsed();
+    itemsPerSecond = ms > 0 ? qRound(double(items) * 1000 / ms) : items;
+    return true;
+}
+
+// Undo the items published by an aborted thread
+void TPlaylistWidget::addFilesRollback() {
+
+    if (!addFilesStreaming) {
+        return;
+    }
+
+    if (!addFilesInsert) {
+        // The items replaced the playlist, nothing to go back to
+        WZINFOOBJ("Add files aborted, marking playlist incomplete");
+        root()->setModified();
+        return;
+    }
+
+    WZINFOOBJ(QString("Add files aborted, removing %1 items")
+              .arg(addFilesInserted.count()));
+    for(int i = addFilesInserted.count() - 1; i >= 0; i--) {
+        TPlaylistItem* item =
+                static_cast<TPlaylistItem*>(addFilesInserted.at(i));
+        // Keep the playing item and the folders containing it
+        TPlaylistItem* playing = playingItem;
+        while (playing && playing != item) {
+            playing = playing->plParent();
+        }
+        if (playing == 0) {
+            delete item;
+        }
+    }
+    addFilesInserted.clear();
+}
+
+void TPlaylistWidget::onAddFilesEntriesReady() {
+
+    // Ignore entries of an aborted thread
+    if (addFilesThread && !addFilesRestartThread) {
+        addFilesEntries();
+    }
+}
+
+void TPlaylistWidget::addFilesEntries() {
+
+    int itemCount;
+    QList<TAddFilesThread::TEntry> entries =
+            addFilesThread->takeEntries(itemCount);
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    // Collect consecutive items for the same folder
+    TPlaylistItem* groupParent = 0;
+    QList<QTreeWidgetItem*> group;
+
+    for(int i = 0; i < entries.count(); i++) {
+        const TAddFilesThread::TEntry& entry = entries.at(i);
+        if (entry.type == TAddFilesThread::TEntry::NEW_FOLDER
+                && entry.parent == 0) {
+            addFilesStartStream(entry.key, entry.item);
+            continue;
+        }
+
+        TPlaylistItem* parent = addFilesFolders.value(entry.parent);
+        if (entry.type == TAddFilesThread::TEntry::NEW_FOLDER
+                && parent == 0 && addFilesSingleFolder) {
+            // The single folder added becomes the new root
+            addFilesAppend(groupParent, group);
+            int currentSortSection = sortSection;
+            disableSort();
+            setNewRoot(entry.item, currentSortSection);
+            addFilesFolders[entry.parent] = entry.item;
+            addFilesFolders[entry.key] = entry.item;
+            continue;
+        }
+        if (parent == 0) {
+            parent = root();
+        }
+
+        if (entry.type == TAddFilesThread::TEntry::FINISH_FOLDER) {
+            TPlaylistItem* folder = addFilesFolders.take(entry.key);
+            if (folder) {
+                addFilesAppend(groupParent, group);
+                addFilesFinishFolder(folder, entry.item, true);
+                delete entry.item;
+                continue;
+            }
+        } else if (entry.type == TAddFilesThread::TEntry::NEW_FOLDER) {
+            addFilesFolders[entry.key] = entry.item;
+        }
+
+        if (parent != groupParent) {
+            addFilesAppend(groupParent, group);
+            groupParent = parent;
+        }
+        group.append(entry.item);
+    }
+    addFilesAppend(groupParent, group);
+
+    addFilesItemCount += itemCount;
+    int items, itemsPerSecond;
+    if (addFilesProgress(items, itemsPerSecond)) {
+        WZDEBUGOBJ(QString("Added %1 items, %2 items per second")
+                   .arg(items).arg(itemsPerSecond));
+        emit addFilesProgressChanged();
+    }
+
+    startWordWrap();
+    addFilesCheckStartPlay();
+}
+
+void TPlaylistWidget::addFilesStartStream(TPlaylistItem* threadRoot,
+                                          TPlaylistItem* copy) {
+
+    addFilesStreaming = true;
+
+    // Validate target is still valid
+    TPlaylistItem* parent;
+    int idx;
+    getAddParent(copy, validateItem(addFilesTarget), addFilesTargetIndex,
+                 parent, idx);
+
+    if (parent == 0 || (parent == root() && parent->childCount() == 0)) {
+        // Drop into empty root
+        addFilesInsert = false;
+        if (addFileList.count() == 1) {
+            // Like add() removes the single folder in root, the first folder
+            // published into the root of the thread becomes the new root
+            WZTRACEOBJ("Waiting for single folder in root");
+            addFilesSingleFolder = true;
+            delete copy;
+        } else {
+            int currentSortSection = sortSection;
+            disableSort();
+            setNewRoot(copy, currentSortSection);
+            addFilesFolders[threadRoot] = copy;
+        }
+    } else {
+        WZTRACEOBJ(QString("Streaming items into '%1'")
+                   .arg(parent->filename()));
+        addFilesInsert = true;
+        addFilesParent = parent;
+        addFilesIndex = idx;
+        addFilesFolders[threadRoot] = parent;
+        if (!addFilesQuiet) {
+            clearSelection();
+        }
+        delete copy;
+
+        // Keep the items in the order they are inserted until the end
+        addFilesSortSection = sortSection;
+        disableSort();
+    }
+}
+
+void TPlaylistWidget::addFilesAppend(TPlaylistItem* parent,
+                                     QList<QTreeWidgetItem*>& items) {
+
+    if (items.isEmpty()) {
+        return;
+    }
+
+    if (addFilesInsert && parent == addFilesParent) {
+        parent->insertChildren(addFilesIndex, items);
+        if (addFilesInserted.isEmpty() && !addFilesQuiet) {
+            setCurrentItem(items.at(0));
+        }
+
+        // Select drop and update size hint name column
+        int level = parent->getLevel() + 1;
+        for(int i = 0; i < items.count(); i++) {
+            TPlaylistItem* item = static_cast<TPlaylistItem*>(items.at(i));
+            if (!addFilesQuiet) {
+                item->setSelected(true);
+            }
+            item->setSizeHintName(level);
+        }
+        addFilesIndex += items.count();
+        addFilesInserted.append(items);
+    } else {
+        // Number the items after the items already published
+        int order = parent->childCount();
+        for(int i = 0; i < items.count(); i++) {
+            static_cast<TPlaylistItem*>(items.at(i))->setOrder(++order);
+        }
+        addFilesKeepOrder = true;
+        parent->addChildren(items);
+        addFilesKeepOrder = false;
+
+        if (parent == root() && currentItem() == 0) {
+            setCurrentItem(items.at(0));
+        }
+    }
+    items.clear();
+}
+
+// Move the children of item, the finished folder from the thread, into its
+// copy folder in the tree and sync the state of the copy with item
+void TPlaylistWidget::addFilesFinishFolder(TPlaylistItem* folder,
+                                           TPlaylistItem* item,
+                                           bool sync) {
+
+    if (sync) {
+        if (folder->filename() != item->filename()) {
+            folder->setFilename(item->filename());
+        }
+        folder->setBlacklist(item->getBlacklist());
+        if (item->modified() && !folder->modified()) {
+            folder->setModified(true, false, false);
+        }
+        folder->updateIcon();
+    }
+
+    QList<QTreeWidgetItem*> items;
+    while (item->childCount()) {
+        TPlaylistItem* child = item->plTakeChild(0);
+        TPlaylistItem* childFolder = addFilesFolders.take(child);
+        if (childFolder) {
+            addFilesAppend(folder, items);
+            addFilesFinishFolder(childFolder, child, true);
+            delete child;
+        } else {
+            items.append(child);
+        }
+    }
+    addFilesAppend(folder, items);
+}
+
+void TPlaylistWidget::addFilesFinishStream(TPlaylistItem* threadRoot,
+                                           QList<QTreeWidgetItem*>& added) {
+
+    // Move the items not published yet. The root of the tree is only a copy
+    // of the root of the thread when it replaced the root.
+    TPlaylistItem* folder = addFilesFolders.take(threadRoot);
+    bool sync = folder && !addFilesInsert && !addFilesSingleFolder;
+    if (folder == 0) {
+        folder = root();
+    }
+    addFilesFinishFolder(folder, threadRoot, sync);
+    delete threadRoot;
+
+    WZINFOOBJ(QString("Added %1 items in %2 ms")
+              .arg(addFilesItemCount).arg(addFilesTimer.elapsed()));
+
+    if (addFilesInsert) {
+        added = addFilesInserted;
+    } else {
+        added.append(root());
+    }
+
+    if (addFilesInsert && addFilesQuiet) {
+        // The folder now matches the disk again
+        addFilesResetStream();
+    } else if (addFilesInsert) {
+        for(int i = 0; i < addFilesInserted.count(); i++) {
+            static_cast<TPlaylistItem*>(addFilesInserted.at(i))
+                    ->setModified(true, true, false);
+        }
+        TPlaylistItem* parent = addFilesParent;
+        addFilesResetStream();
+        WZTRACEOBJ("Setting parent modified");
+        parent->setModified();
+    } else {
+        addFilesResetStream();
+        WZINFOOBJ("emit rootFilenameChanged(\"" + root()->filename() + "\")");
+        emit rootFilenameChanged(root()->filename());
+    }
+}
+
+// Name of child in the directory path, for a wzplaylist the name of the
+// directory containing it. Empty when child does not reside in path itself.
+QString TPlaylistWidget::refreshName(const QString& path,
+                                     TPlaylistItem* child) {
+
+    QString filename = child->filename();
+    if (child->isUrl() || !filename.startsWith(path)) {
+        return "";
+    }
+
+    QString name = filename.mid(path.length());
+    int sep = name.indexOf(QDir::separator());
+    if (sep >= 0) {
+        if (!child->isWZPlaylist()
+                || name.indexOf(QDir::separator(), sep + 1) >= 0) {
+            return "";
+        }
+        name = name.left(sep);
+    }
+    return name;
+}
+
+// Finish the thread started by refreshFolder(). Only the folder refreshed
+// and the inserted items are touched.
+void TPlaylistWidget::addFilesFinishRefresh(
+        TPlaylistItem* threadRoot,
+        const QStringList& removedNames,
+        const QHash<QString, qint64>& dirs) {
+
+    addFileList.clear();
+    TPlaylistItem* folder = validateItem(addFilesTarget);
+    QList<QTreeWidgetItem*> added;
+
+    if (addFilesStreaming) {
+        addFilesFinishStream(threadRoot, added);
+    } else {
+        if (folder && threadRoot->childCount()) {
+            int currentSortSection = sortSection;
+            disableSort();
+            int level = folder->getLevel() + 1;
+            while (threadRoot->childCount()) {
+                TPlaylistItem* child = threadRoot->plTakeChild(0);
+                child->setSizeHintName(level);
+                added.append(child);
+            }
+            folder->addChildren(added);
+            setSort(currentSortSection, sortOrder);
+        }
+        delete threadRoot;
+    }
+
+    // Remove the items no longer on disk, except the playing item and the
+    // folders containing it
+    if (folder && !removedNames.isEmpty()) {
+        QSet<QString> removed = removedNames.toSet();
+        QString path = folder->filename();
+        if (!path.endsWith(QDir::separator())) {
+            path += QDir::separator();
+        }
+        for(int i = folder->childCount() - 1; i >= 0; i--) {
+            TPlaylistItem* child = folder->plChild(i);
+            QString name = refreshName(path, child);
+            if (name.isEmpty()
+                    || !removed.contains(TAddFilesThread::nameKey(name))) {
+                continue;
+            }
+            TPlaylistItem* playing = playingItem;
+            while (playing && playing != child) {
+                playing = playing->plParent();
+            }
+            if (playing == 0) {
+                WZINFOOBJ("Removing '" + child->filename()
+                          + "', it no longer exists");
+                delete child;
+            }
+        }
+    }
+
+    WZDEBUGOBJ(QString("Refreshed '%1', added %2 items, removed %3")
+               .arg(addFilesRefreshDir).arg(added.count())
+               .arg(removedNames.count()));
+    emit busyChanged();
+    emit refreshedItems(added, dirs);
+}
+
+// Start playing as soon as the item to play is published
+void TPlaylistWidget::addFilesCheckStartPlay() {
+
+    // Nothing published yet when waiting for the single folder in root
+    if (!addFilesStartPlay || addFilesFolders.isEmpty()) {
+        return;
+    }
+    if (addFilesFileToPlay.isEmpty()) {
+        if (firstPlaylistItem()) {
+            addFilesStartPlay = false;
+            emit startPlay();
+        }
+    } else {
+        TPlaylistItem* item = findFilename(addFilesFileToPlay);
+        if (item) {
+            addFilesStartPlay = false;
+            emit playItem(item);
+        }
     }
 }
 
@@ -183,9 +595,15 @@ void TPlaylistWidget::onAddFilesThreadFinished() {
     // Get items from thread
     TPlaylistItem* root = addFilesThread->root;
     addFilesThread->root = 0;
-    if (!addFilesThread->latestDir.isEmpty()) {
+    if (root) {
+        // Get the entries published after the last entriesReady()
+        addFilesEntries();
+    }
+    if (!addFilesThread->latestDir.isEmpty() && !addFilesQuiet) {
         emit latestDirChanged(addFilesThread->latestDir);
     }
+    QStringList removedNames = addFilesThread->removedNames;
+    QHash<QString, qint64> dirs = addFilesThread->listedDirs;
 
     // Clean up
     delete addFilesThread;
@@ -193,6 +611,8 @@ void TPlaylistWidget::onAddFilesThreadFinished() {
 
     if (root == 0) {
         // Thread aborted
+        addFilesRollback();
+        addFilesResetStream();
         if (addFilesRestartThread) {
             WZDEBUGOBJ("Thread aborted, starting new request");
             addFilesStartThread();
@@ -204,11 +624,24 @@ void TPlaylistWidget::onAddFilesThreadFinished() {
         return;
     }
 
+    if (addFilesQuiet) {
+        addFilesFinishRefresh(root, removedNames, dirs);
+        return;
+    }
+
+    if (!isFavList) {
+        TStartTrace::end("Playlist restore");
+    }
+
     QString msg = addFileList.count() == 1 ? addFileList.at(0) : "";
     addFileList.clear();
 
-    // Found nothing to play?
-    if (root->childCount() == 0) {
+    QList<QTreeWidgetItem*> added;
+    if (addFilesStreaming) {
+        // Move the remaining items of root into the tree
+        addFilesFinishStream(root, added);
+    } else if (root->childCount() == 0) {
+        // Found nothing to play
         delete root;
         if (msg.isEmpty()) {
             msg = tr("Found nothing to play.");
@@ -219,18 +652,19 @@ void TPlaylistWidget::onAddFilesThreadFinished() {
         emit nothingToPlay(msg);
         emit busyChanged();
         return;
-    }
-
-    // add() returns a newly created root when all items are replaced
-    // or 0 when the new items are inserted into the existing root.
-    root = add(root, addFilesTarget, addFilesTargetIndex);
-    if (root) {
-        WZINFOOBJ("emit rootFilenameChanged(\"" + root->filename() + "\")");
-        emit rootFilenameChanged(root->filename());
+    } else {
+        // add() returns a newly created root when all items are replaced
+        // or 0 when the new items are inserted into the existing root.
+        root = add(root, addFilesTarget, addFilesTargetIndex, added);
+        if (root) {
+            WZINFOOBJ("emit rootFilenameChanged(\"" + root->filename()
+                      + "\")");
+            emit rootFilenameChanged(root->filename());
+        }
     }
 
     emit busyChanged();
-    emit addedItems();
+    emit addedItems(added, dirs);
 
     if (addFilesStartPlay) {
         if (!addFilesFileToPlay.isEmpty()) {
@@ -255,6 +689,8 @@ void TPlaylistWidget::addFilesStartThread() {
     } else {
         WZDEBUGOBJ("Starting add files thread");
         addFilesRestartThread = false;
+        addFilesItemCount = 0;
+        addFilesTimer.start();
 
         // Allow single image
         bool addImages = Settings::pref->addImages
@@ -271,10 +707,16 @@ void TPlaylistWidget::addFilesStartThread() {
                                              addImages,
                                              isFavList);
 
+        connect(addFilesThread, &TAddFilesThread::entriesReady,
+                this, &TPlaylistWidget::onAddFilesEntriesReady);
         connect(addFilesThread, &TAddFilesThread::finished,
                 this, &TPlaylistWidget::onAddFilesThreadFinished);
         connect(addFilesThread, &TAddFilesThread::displayMessage,
                 msgSlot, &TMsgSlot::msg);
+        if (addFilesQuiet) {
+            addFilesThread->setRefresh(addFilesRefreshDir,
+                                       addFilesRefreshNames);
+        }
 
         addFilesThread->start();
         emit busyChanged();
@@ -288,6 +730,12 @@ void TPlaylistWidget::addFiles(const QStringList& files,
                                const QString& fileToPlay) {
     WZDOBJ << files << "startPlay" << startPlay;
 
+    // Have the refresh done again after the files are added
+    if (addFilesThread && addFilesQuiet) {
+        WZDOBJ << "Aborting refresh of" << addFilesRefreshDir;
+        emit refreshAborted(addFilesRefreshDir);
+    }
+    addFilesQuiet = false;
     addFileList = files;
     addFilesTarget = target;
     addFilesTargetIndex = targetIndex;
@@ -297,6 +745,37 @@ void TPlaylistWidget::addFiles(const QStringList& files,
     addFilesStartThread();
 }
 
+void TPlaylistWidget::refreshFolder(TPlaylistItem* folder) {
+    WZDOBJ << folder->filename();
+
+    // Collect the names in the folder, including the blacklisted ones
+    QString path = folder->filename();
+    if (!path.endsWith(QDir::separator())) {
+        path += QDir::separator();
+    }
+    addFilesRefreshNames.clear();
+    for(int i = 0; i < folder->childCount(); i++) {
+        QString name = refreshName(path, folder->plChild(i));
+        if (!name.isEmpty()) {
+            addFilesRefreshNames.insert(TAddFilesThread::nameKey(name));
+        }
+    }
+    const QStringList& blacklist = folder->getBlacklist();
+    for(int i = 0; i < blacklist.count(); i++) {
+        addFilesRefreshNames.insert(TAddFilesThread::nameKey(blacklist.at(i)));
+    }
+
+    addFilesQuiet = true;
+    addFilesRefreshDir = folder->filename();
+    addFileList.clear();
+    addFilesTarget = folder;
+    addFilesTargetIndex = -1;
+    addFilesStartPlay = false;
+    addFilesFileToPlay = "";
+
+    addFilesStartThread();
+}
+
 void TPlaylistWidget::abortFileCopier() {
 
     if (copyDialog) {
@@ -316,6 +795,9 @@ void TPlaylistWidget::clr() {
 
     abort();
     clear();
+    filenameIndex.clear();
+    unplayedItems.clear();
+    unplayedPos.clear();
 
     // Create a TPlaylistItem root
     addTopLevelItem(new TPlaylistItem());
@@ -429,23 +911,114 @@ TPlaylistItem* TPlaylistWidget::findFilename(const QString &filename) {
         return 0;
     }
 
-    QString search1 = QDir::toNativeSeparators(filename);
-    QString search2;
-    if (QFileInfo(filename).isDir()) {
-        search2 = search1 + QDir::separator() + TConfig::WZPLAYLIST;
+    QString search = QDir::toNativeSeparators(filename);
+    TPlaylistItem* item = findIndexedFilename(search);
+    if (item == 0 && QFileInfo(filename).isDir()) {
+        item = findIndexedFilename(search + QDir::separator()
+                                   + TConfig::WZPLAYLIST);
+    }
+    return item;
+}
+
+QString TPlaylistWidget::filenameKey(const QString& filename) {
+
+    if (caseSensitiveFileNames == Qt::CaseSensitive) {
+        return filename;
+    }
+    return filename.toLower();
+}
+
+TPlaylistItem* TPlaylistWidget::findIndexedFilename(const QString& filename) {
+
+    QList<TPlaylistItem*> items = filenameIndex.values(filenameKey(filename));
+    if (items.count() <= 1) {
+        return items.value(0);
     }
 
+    // Same file added more than once, return the first one in the tree
     QTreeWidgetItemIterator it(this);
     while (*it) {
         TPlaylistItem* i = static_cast<TPlaylistItem*>(*it);
-        QString fn = i->filename();
-        if (fn == search1 || (!search2.isEmpty() && fn == search2)) {
+        if (items.contains(i)) {
             return i;
         }
         ++it;
     }
+    return items.at(0);
+}
 
-    return 0;
+void TPlaylistWidget::addToIndexes(TPlaylistItem* item) {
+
+    if (!item->filename().isEmpty()) {
+        filenameIndex.insert(filenameKey(item->filename()), item);
+    }
+    if (isUnplayed(item)) {
+        addUnplayed(item);
+    }
+    for(int i = 0; i < item->childCount(); i++) {
+        addToIndexes(item->plChild(i));
+    }
+}
+
+void TPlaylistWidget::removeFromIndexes(TPlaylistItem* item) {
+
+    if (!item->filename().isEmpty()) {
+        filenameIndex.remove(filenameKey(item->filename()), item);
+    }
+    removeUnplayed(item);
+    for(int i = 0; i < item->childCount(); i++) {
+        removeFromIndexes(item->plChild(i));
+    }
+}
+
+void TPlaylistWidget::updateFilenameIndex(TPlaylistItem* item,
+                                          const QString& oldFilename) {
+
+    if (!oldFilename.isEmpty()) {
+        filenameIndex.remove(filenameKey(oldFilename), item);
+    }
+    if (!item->filename().isEmpty()) {
+        filenameIndex.insert(filenameKey(item->filename()), item);
+    }
+    // setFilename() can change isFolder()
+    updateUnplayedIndex(item);
+}
+
+bool TPlaylistWidget::isUnplayed(TPlaylistItem* item) {
+    return !item->isFolder()
+            && !item->played()
+            && item->state() != PSTATE_FAILED;
+}
+
+void TPlaylistWidget::addUnplayed(TPlaylistItem* item) {
+
+    if (!unplayedPos.contains(item)) {
+        unplayedPos.insert(item, unplayedItems.count());
+        unplayedItems.append(item);
+    }
+}
+
+void TPlaylistWidget::removeUnplayed(TPlaylistItem* item) {
+
+    QHash<TPlaylistItem*, int>::iterator it = unplayedPos.find(item);
+    if (it != unplayedPos.end()) {
+        int pos = it.value();
+        unplayedPos.erase(it);
+        TPlaylistItem* last = unplayedItems.takeLast();
+        if (last != item) {
+            unplayedItems[pos] = last;
+            unplayedPos[last] = pos;
+        }
+    }
+}
+
+void TPlaylistWidget::updateUnplayedIndex(TPlaylistItem* item) {
+
+    if (isUnplayed(item)) {
+        addUnplayed(item);
+    } else {
+        removeUnplayed(item);
+    }
 }
 
 void TPlaylistWidget::setPlayingItem(TPlaylistItem* item,
@@ -1164,6 +1737,11 @@ void TPlaylistWidget::dropEvent(QDropEvent* event) {
                 QMessageBox::information(copyDialog, tr("Information"),
                     tr("A copy or move action is still in progress. You can"
                        " retry after it has finished."));
+            } else if (addFilesStreaming) {
+                // The folders receiving the added items must stay put
+                QMessageBox::information(this, tr("Information"),
+                    tr("Still adding files to the playlist. You can retry"
+                       " after it has finished."));
             } else {
                 TPlaylistItem* target = static_cast<TPlaylistItem*>(
                             index.internalPointer());
@@ -1266,11 +1844,18 @@ void TPlaylistWidget::rowsAboutToBeRemoved(const QModelIndex &parent,
     QTreeWidget::rowsAboutToBeRemoved(parent, start, end);
 
     if (!parent.isValid()) {
+        for(int i = start; i <= end; i++) {
+            removeFromIndexes(
+                        static_cast<TPlaylistItem*>(topLevelItem(i)));
+        }
         return;
     }
 
     TPlaylistItem* parentItem = static_cast<TPlaylistItem*>(
                 parent.internalPointer());
+    for(int i = start; i <= end; i++) {
+        removeFromIndexes(parentItem->plChild(i));
+    }
 
     if (sortSection == TPlaylistItem::COL_ORDER) {
         int d = end - start + 1;
@@ -1305,11 +1890,20 @@ void TPlaylistWidget::rowsInserted(const QModelIndex &parent,
     QTreeWidget::rowsInserted(parent, start, end);
 
     if (!parent.isValid()) {
+        for(int i = start; i <= end; i++) {
+            addToIndexes(static_cast<TPlaylistItem*>(topLevelItem(i)));
+        }
         return;
     }
 
     TPlaylistItem* parentItem = static_cast<TPlaylistItem*>(
                 parent.internalPointer());
+    for(int i = start; i <= end; i++) {
+        addToIndexes(parentItem->plChild(i));
+    }
+    if (addFilesKeepOrder) {
+        return;
+    }
 
     if (sortSection == TPlaylistItem::COL_ORDER) {
         if (sortOrder == Qt::AscendingOrder) {
@@ -1630,16 +2224,12 @@ TPlaylistItem* TPlaylistWidget::validateItem(TPlaylistItem* item) const {
     return 0;
 }
 
-TPlaylistItem* TPlaylistWidget::add(TPlaylistItem* item,
-                                    TPlaylistItem* target,
-                                    int index) {
-
-    // Validate target is still valid
-    target = validateItem(target);
+void TPlaylistWidget::getAddParent(TPlaylistItem* item,
+                                   TPlaylistItem* target,
+                                   int index,
+                                   TPlaylistItem*& parent,
+                                   int& idx) {
 
-    // Get parent to insert into and index into parent
-    TPlaylistItem* parent;
-    int idx;
     if (target) {
         if (target->isFolder()) {
             parent = target;
@@ -1676,6 +2266,88 @@ TPlaylistItem* TPlaylistWidget::add(TPlaylistItem* item,
         parent = root();
         idx = parent->childCount();
     }
+}
+
+void TPlaylistWidget::setNewRoot(TPlaylistItem* item, int currentSortSection) {
+    WZTRACEOBJ(QString("New root '%1'").arg(item->filename()));
+
+    // Invalidate playing_item
+    if (playingItem) {
+        playingItem = 0;
+        emit playingItemChanged(playingItem);
+        emit playingItemUpdated(playingItem);
+    }
+
+    // Delete old root
+    setRootIndex(QModelIndex());
+    delete takeTopLevelItem(0);
+    clearSelection();
+
+    // Set new item as root
+    item->setFlags(ROOT_FLAGS);
+    addTopLevelItem(item);
+    setRootIndex(model()->index(0, 0));
+
+    // Sort
+    if (item->isWZPlaylist() || !item->isPlaylist()) {
+        if (currentSortSection < 0) {
+            // Sort not set yet. Playlist only,
+            // favList has its sortOrder set in constructor
+            sortSection = TPlaylistItem::COL_NAME;
+            sortOrder = Qt::AscendingOrder;
+            sortSectionSaved = -1;
+        } else if (sortSectionSaved >= 0) {
+            // Current sort is from non-wzplaylist playlist,
+            // restore saved sort
+            sortSection = sortSectionSaved;
+            sortOrder = sortOrderSaved;
+            sortSectionSaved = -1;
+        } else {
+            // Keep current sort
+            sortSection = currentSortSection;
+        }
+    } else if (sortSectionSaved >= 0) {
+        // Keep current sort
+        sortSection = currentSortSection;
+    } else {
+        // Save sort for when switching back to wzplaylist
+        if (currentSortSection >= 0) {
+            sortSectionSaved = currentSortSection;
+            sortOrderSaved = sortOrder;
+        } else {
+            sortSectionSaved = TPlaylistItem::COL_NAME;
+            sortOrderSaved = Qt::AscendingOrder;
+        }
+        sortSection = TPlaylistItem::COL_ORDER;
+        sortOrder = Qt::AscendingOrder;
+    }
+    setSort(sortSection, sortOrder);
+
+    if (item->childCount()) {
+        setCurrentItem(item->child(0));
+        startWordWrap();
+    }
+
+    if (item->modified()) {
+        WZTRACEOBJ("New root is modified");
+        emit modifiedChanged();
+    } else {
+        WZTRACEOBJ("New root is not modified");
+    }
+}
+
+TPlaylistItem* TPlaylistWidget::add(TPlaylistItem* item,
+                                    TPlaylistItem* target,
+                                    int index,
+                                    QList<QTreeWidgetItem*>& added) {
+
+    // Validate target is still valid
+    target = validateItem(target);
+
+    // Get parent to insert into and index into parent
+    TPlaylistItem* parent;
+    int idx;
+    getAddParent(item, target, index, parent, idx);
 
     WZTOBJ << "target" << (target ? target->filename() : QString())
            << "index" << index << "idx" << idx;
@@ -1695,71 +2367,8 @@ TPlaylistItem* TPlaylistWidget::add(TPlaylistItem* item,
             delete old;
         }
 
-        WZTRACEOBJ(QString("New root '%1'").arg(item->filename()));
-
-        // Invalidate playing_item
-        if (playingItem) {
-            playingItem = 0;
-            emit playingItemChanged(playingItem);
-            emit playingItemUpdated(playingItem);
-        }
-
-        // Delete old root
-        setRootIndex(QModelIndex());
-        delete takeTopLevelItem(0);
-        clearSelection();
-
-        // Set new item as root
-        item->setFlags(ROOT_FLAGS);
-        addTopLevelItem(item);
-        setRootIndex(model()->index(0, 0));
-
-        // Sort
-        if (item->isWZPlaylist() || !item->isPlaylist()) {
-            if (currentSortSection < 0) {
-                // Sort not set yet. Playlist only,
-                // favList has its sortOrder set in constructor
-                sortSection = TPlaylistItem::COL_NAME;
-                sortOrder = Qt::AscendingOrder;
-                sortSectionSaved = -1;
-            } else if (sortSectionSaved >= 0) {
-                // Current sort is from non-wzplaylist playlist,
-                // restore saved sort
-                sortSection = sortSectionSaved;
-                sortOrder = sortOrderSaved;
-                sortSectionSaved = -1;
-            } else {
-                // Keep current sort
-                sortSection = currentSortSection;
-            }
-        } else if (sortSectionSaved >= 0) {
-            // Keep current sort
-            sortSection = currentSortSection;
-        } else {
-            // Save sort for when switching back to wzplaylist
-            if (currentSortSection >= 0) {
-                sortSectionSaved = currentSortSection;
-                sortOrderSaved = sortOrder;
-            } else {
-                sortSectionSaved = TPlaylistItem::COL_NAME;
-                sortOrderSaved = Qt::AscendingOrder;
-            }
-            sortSection = TPlaylistItem::COL_ORDER;
-            sortOrder = Qt::AscendingOrder;
-        }
-        setSort(sortSection, sortOrder);
-
-        if (item->childCount()) {
-            setCurrentItem(item->child(0));
-            startWordWrap();
-        }
-
-        if (item->modified()) {
-            WZTRACEOBJ("New root is modified");
-            emit modifiedChanged();
-        } else {
-            WZTRACEOBJ("New root is not modified");
-        }
+        setNewRoot(item, currentSortSection);
+        added.append(item);
     } else {
         WZTRACEOBJ(QString("Dropping %1 items into '%2'")
                    .arg(item->childCount()).arg(parent->filename()));
@@ -1777,6 +2386,8 @@ TPlaylistItem* TPlaylistWidget::add(TPlaylistItem* item,
         // Notify TPlaylist::onThreadFinished() root is still alive
         item = 0;
 
+        added = children;
+
         // Insert children
         if (children.count()) {
             parent->insertChildren(idx, children);
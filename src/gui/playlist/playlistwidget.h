@@ -4,6 +4,10 @@
 #include "gui/playlist/playlistitem.h"
 #include <QTreeWidget>
 #include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QElapsedTimer>
 
 
 class QSettings;
@@ -41,6 +45,11 @@ public:
                   int targetIndex = -1,
                   bool startPlay = false,
                   const QString& fileToPlay = "");
+    // Sync the directory item folder with the disk. The add files thread
+    // lists the directory, the items no longer on disk are removed and the
+    // new files are added. Unlike addFiles() the new items are not selected
+    // or marked modified and finding nothing is not reported.
+    void refreshFolder(TPlaylistItem* folder);
     void abort();
 
     TPlaylistItem* playingItem;
@@ -67,6 +76,15 @@ public:
 
     QString playingFile() const;
     TPlaylistItem* findFilename(const QString& filename);
+    // Called by TPlaylistItem when the filename of an item changed
+    void updateFilenameIndex(TPlaylistItem* item,
+                             const QString& oldFilename);
+
+    // Items not played and not failed, in no particular order
+    int unplayedCount() const { return unplayedItems.count(); }
+    TPlaylistItem* unplayedItem(int i) const { return unplayedItems.at(i); }
+    // Called by TPlaylistItem when played, state or folder changed
+    void updateUnplayedIndex(TPlaylistItem* item);
 
     TPlaylistItem* getNextItem(TPlaylistItem* w, bool allowChild = true) const;
     TPlaylistItem* getNextPlaylistItem(TPlaylistItem* item) const;
@@ -81,6 +99,9 @@ public:
     void clr();
 
     bool isBusy() const { return addFilesThread || fileCopier; }
+    // Items added so far by addFiles() and the rate at which they are added.
+    // Returns false when not adding files.
+    bool addFilesProgress(int& items, int& itemsPerSecond) const;
     bool isModified() const { return root()->modified(); }
     void clearModified() { root()->setModified(false, true); }
     void emitModifiedChanged();
@@ -94,7 +115,8 @@ public:
     TPlaylistItem* validateItem(TPlaylistItem* folder, TPlaylistItem* item) const;
     TPlaylistItem* validateItem(TPlaylistItem* item) const;
 
-    TPlaylistItem* add(TPlaylistItem* item, TPlaylistItem* target, int index);
+    TPlaylistItem* add(TPlaylistItem* item, TPlaylistItem* target, int index,
+                       QList<QTreeWidgetItem*>& added);
     void removeSelected(bool deleteFromDisk);
 
     void setSort(int section, Qt::SortOrder order);
@@ -114,7 +136,17 @@ signals:
     void latestDirChanged(QString dir);
     void nothingToPlay(QString msg);
     void rootFilenameChanged(QString rootFilename);
-    void addedItems();
+    // Items added by addFiles(), with their children. Only the new root
+    // when the items replaced the playlist. dirs contains the directories
+    // listed with their modification time from before listing them.
+    void addedItems(const QList<QTreeWidgetItem*>& items,
+                    const QHash<QString, qint64>& dirs);
+    // Items added by refreshFolder()
+    void refreshedItems(const QList<QTreeWidgetItem*>& items,
+                        const QHash<QString, qint64>& dirs);
+    // The refresh of dir was aborted by addFiles()
+    void refreshAborted(const QString& dir);
+    void addFilesProgressChanged();
     void startPlay();
     void playItem(TPlaylistItem* item);
 
@@ -142,6 +174,35 @@ private:
     bool addFilesStartPlay;
     QString addFilesFileToPlay;
     bool addFilesRestartThread;
+    // Started by refreshFolder()
+    bool addFilesQuiet;
+    QString addFilesRefreshDir;
+    QSet<QString> addFilesRefreshNames;
+
+    // Items published by addFilesThread while it is running
+    bool addFilesStreaming;
+    // Inserting into addFilesParent at addFilesIndex instead of a new root
+    bool addFilesInsert;
+    TPlaylistItem* addFilesParent;
+    int addFilesIndex;
+    QList<QTreeWidgetItem*> addFilesInserted;
+    int addFilesSortSection;
+    // Replacing root by the single folder added, once it is published
+    bool addFilesSingleFolder;
+    // Folders of the thread to their copy in the tree
+    QHash<TPlaylistItem*, TPlaylistItem*> addFilesFolders;
+    // Keep the order set for appended items in rowsInserted()
+    bool addFilesKeepOrder;
+    int addFilesItemCount;
+    QElapsedTimer addFilesTimer;
+
+    // Items by filename, see filenameKey()
+    QMultiHash<QString, TPlaylistItem*> filenameIndex;
+    // Unplayed items for shuffle, with their position in unplayedItems,
+    // so an item can be removed by moving the last item in its place
+    QVector<TPlaylistItem*> unplayedItems;
+    QHash<TPlaylistItem*, int> unplayedPos;
+
     const bool isFavList;
 
     int sortSectionSaved;
@@ -162,8 +223,38 @@ private:
 
     void addFilesStartThread();
     void abortAddFilesThread();
+    void addFilesEntries();
+    void addFilesStartStream(TPlaylistItem* threadRoot, TPlaylistItem* copy);
+    void addFilesAppend(TPlaylistItem* parent, QList<QTreeWidgetItem*>& items);
+    void addFilesFinishFolder(TPlaylistItem* folder,
+                              TPlaylistItem* item,
+                              bool sync);
+    void addFilesFinishStream(TPlaylistItem* threadRoot,
+                              QList<QTreeWidgetItem*>& added);
+    void addFilesResetStream();
+    void addFilesRollback();
+    void addFilesCheckStartPlay();
+    void addFilesFinishRefresh(TPlaylistItem* threadRoot,
+                               const QStringList& removedNames,
+                               const QHash<QString, qint64>& dirs);
+    static QString refreshName(const QString& path, TPlaylistItem* child);
+
+    void getAddParent(TPlaylistItem* item,
+                      TPlaylistItem* target,
+                      int index,
+                      TPlaylistItem*& parent,
+                      int& idx);
+    void setNewRoot(TPlaylistItem* item, int currentSortSection);
     void abortFileCopier();
 
+    static QString filenameKey(const QString& filename);
+    void addToIndexes(TPlaylistItem* item);
+    void removeFromIndexes(TPlaylistItem* item);
+    TPlaylistItem* findIndexedFilename(const QString& filename);
+    static bool isUnplayed(TPlaylistItem* item);
+    void addUnplayed(TPlaylistItem* item);
+    void removeUnplayed(TPlaylistItem* item);
+
     int countItems(QTreeWidgetItem* w) const;
     int countChildren(TPlaylistItem* w) const;
     bool hasPlayableItems(TPlaylistItem* item) const;
@@ -213,6 +304,7 @@ private:
                     bool deleteFromDisk);
 
 private slots:
+    void onAddFilesEntriesReady();
     void onAddFilesThreadFinished();
     void scrollToCurrentItem();
     void onWordWrapTimeout();
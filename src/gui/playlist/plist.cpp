@@ -29,6 +29,7 @@
 #include <QClipboard>
 #include <QMimeData>
 #include <QDesktopServices>
+#include <QDateTime>
 
 
 namespace Gui {
@@ -38,7 +39,7 @@ TMenuAddRemoved::TMenuAddRemoved(TPList* pl, const QString& name) :
     TMenu(pl, name, tr("Add removed item"), "noicon"),
     plist(pl) {
 
-    menuAction()->setIcon(iconProvider.trashIcon);
+    menuAction()->setIcon(iconProvider.trashIcon());
 
     connect(this, &TMenuAddRemoved::triggered,
             this, &TMenuAddRemoved::onTriggered);
@@ -126,6 +127,8 @@ TPList::TPList(TDockWidget* parent,
 
     setObjectName(name);
 
+    setRandomSeed(quint32(QDateTime::currentMSecsSinceEpoch()));
+
     createTree();
     createActions();
     createToolbar();
@@ -158,6 +161,10 @@ void TPList::createTree() {
             this, &TPList::enableActions);
     connect(playlistWidget, &TPlaylistWidget::busyChanged,
             this, &TPList::busyChanged);
+    connect(playlistWidget, &TPlaylistWidget::busyChanged,
+            this, &TPList::setPLaylistTitle);
+    connect(playlistWidget, &TPlaylistWidget::addFilesProgressChanged,
+            this, &TPList::setPLaylistTitle);
     connect(playlistWidget, &TPlaylistWidget::startPlay,
             this, &TPList::startPlay);
     connect(playlistWidget, &TPlaylistWidget::playItem,
@@ -178,7 +185,7 @@ void TPList::createActions() {
                           ? tr("Import favorites")
                           : tr("Open playlist"),
                           "noicon", QKeySequence("Ctrl+P"));
-    openAct->setIcon(iconProvider.openIcon);
+    openAct->setIcon(iconProvider.openIcon());
     connect(openAct, &TAction::triggered,
             this, &TPList::openPlaylistDialog);
 
@@ -186,26 +193,26 @@ void TPList::createActions() {
     saveAct = new TAction(owner, shortName + "_save",
                           tr("Save %1").arg(tranNameLower),
                           "noicon", QKeySequence("Ctrl+S"));
-    saveAct->setIcon(iconProvider.saveIcon);
+    saveAct->setIcon(iconProvider.saveIcon());
     connect(saveAct, &TAction::triggered, this, &TPList::save);
 
     // SaveAs
     saveAsAct = new TAction(owner, shortName + "_save_as",
                             tr("Save %1 as...").arg(tranNameLower), "noicon");
-    saveAsAct->setIcon(iconProvider.saveAsIcon);
+    saveAsAct->setIcon(iconProvider.saveAsIcon());
     connect(saveAsAct, &TAction::triggered, this, &TPList::saveAs);
 
     // Refresh
     refreshAct = new TAction(owner, shortName+ "_refresh",
                              tr("Refresh %1").arg(tranNameLower), "noicon",
                              Qt::Key_F5);
-    refreshAct->setIcon(iconProvider.refreshIcon);
+    refreshAct->setIcon(iconProvider.refreshIcon());
     connect(refreshAct, &TAction::triggered, this, &TPList::refresh);
 
     // Browse directory
     browseDirAct = new TAction(owner, shortName + "_browse_dir",
                                tr("Browse directory or URL"), "noicon");
-    browseDirAct->setIcon(iconProvider.browseURLIcon);
+    browseDirAct->setIcon(iconProvider.browseURLIcon());
     connect(browseDirAct, &TAction::triggered, this, &TPList::browseDir);
 
     // Play
@@ -233,7 +240,7 @@ void TPList::createActions() {
     // Find playing
     findPlayingAct = new TAction(owner, shortName + "_find_playing",
                                  tr("Find playing item"), "noicon", Qt::Key_F3);
-    findPlayingAct->setIcon(iconProvider.findIcon);
+    findPlayingAct->setIcon(iconProvider.findIcon());
     connect(findPlayingAct, &TAction::triggered,
             this, &TPList::findPlayingItem);
     contextMenu->addAction(findPlayingAct);
@@ -263,7 +270,7 @@ void TPList::createActions() {
     // New folder
     newFolderAct = new TAction(this, shortName + "_new_folder",
                                tr("New folder"), "noicon", Qt::Key_F10);
-    newFolderAct->setIcon(iconProvider.newFolderIcon);
+    newFolderAct->setIcon(iconProvider.newFolderIcon());
     connect(newFolderAct, &TAction::triggered, this, &TPList::newFolder);
     contextMenu->addAction(newFolderAct);
 
@@ -271,14 +278,14 @@ void TPList::createActions() {
     // Cut
     cutAct = new TAction(this, shortName + "_cut", tr("Cut file name(s)"),
                          "noicon", QKeySequence("Ctrl+X"));
-    cutAct->setIcon(iconProvider.cutIcon);
+    cutAct->setIcon(iconProvider.cutIcon());
     connect(cutAct, &TAction::triggered, this, &TPList::cut);
     contextMenu->addAction(cutAct);
 
     // Copy
     copyAct = new TAction(owner, shortName + "_copy", tr("Copy file name(s)"),
                           "noicon", QKeySequence("Ctrl+C"));
-    copyAct->setIcon(iconProvider.copyIcon);
+    copyAct->setIcon(iconProvider.copyIcon());
     connect(copyAct, &TAction::triggered, this, &TPList::copySelected);
     contextMenu->addAction(copyAct);
 
@@ -286,7 +293,7 @@ void TPList::createActions() {
     pasteAct = new TAction(owner, shortName + "_paste",
                            tr("Paste file name(s)"), "noicon",
                            QKeySequence("Ctrl+V"));
-    pasteAct->setIcon(iconProvider.pasteIcon);
+    pasteAct->setIcon(iconProvider.pasteIcon());
     connect(pasteAct, &TAction::triggered, this, &TPList::paste);
     connect(QApplication::clipboard(), &QClipboard::dataChanged,
             this, &TPList::enablePaste);
@@ -297,7 +304,7 @@ void TPList::createActions() {
     playlistAddMenu = new Menu::TMenu(this, shortName + "_add_menu",
                                       tr("Add to %1").arg(tranName.toLower()),
                                       "noicon");
-    playlistAddMenu->menuAction()->setIcon(iconProvider.okIcon);
+    playlistAddMenu->menuAction()->setIcon(iconProvider.okIcon());
 
     // Add playing
     QObject* altOwner;
@@ -341,14 +348,14 @@ void TPList::createActions() {
     // Remove menu
     playlistRemoveMenu = new Menu::TMenu(this, shortName + "_remove_menu",
         tr("Remove from %1").arg(tranNameLower), "noicon");
-    playlistRemoveMenu->menuAction()->setIcon(iconProvider.cancelIcon);
+    playlistRemoveMenu->menuAction()->setIcon(iconProvider.cancelIcon());
     connect(playlistRemoveMenu, &Menu::TMenu::aboutToShow,
             this, &TPList::enableRemoveMenu);
 
     // Delete from playlist
     removeSelectedAct = new TAction(this, shortName + "_delete",
         tr("Delete from %1").arg(tranNameLower), "noicon", Qt::Key_Delete);
-    removeSelectedAct->setIcon(iconProvider.trashIcon);
+    removeSelectedAct->setIcon(iconProvider.trashIcon());
     playlistRemoveMenu->addAction(removeSelectedAct);
     connect(removeSelectedAct, &TAction::triggered,
             this, &TPList::removeSelected);
@@ -361,7 +368,7 @@ void TPList::createActions() {
                                             shortName + "_delete_from_disk",
                                             txt, "noicon",
                                             Qt::SHIFT | Qt::Key_Delete);
-    removeSelectedFromDiskAct->setIcon(iconProvider.discardIcon);
+    removeSelectedFromDiskAct->setIcon(iconProvider.discardIcon());
     playlistRemoveMenu->addAction(removeSelectedFromDiskAct);
     connect(removeSelectedFromDiskAct, &TAction::triggered,
             this, &TPList::removeSelectedFromDisk);
@@ -370,7 +377,7 @@ void TPList::createActions() {
     removeAllAct = new TAction(this, shortName + "_clear",
         tr("Clear %1").arg(tranNameLower) + (isFavList ? "..." : ""),
         "noicon", Qt::CTRL | Qt::Key_Delete);
-    removeAllAct->setIcon(iconProvider.clearIcon);
+    removeAllAct->setIcon(iconProvider.clearIcon());
     playlistRemoveMenu->addAction(removeAllAct);
     connect(removeAllAct, &TAction::triggered, this, &TPList::removeAll);
 
@@ -899,39 +906,22 @@ void TPList::stop() {
     // player->stop() done by TPlaylist::stop()
 }
 
-TPlaylistItem* TPList::getRandomItem() const {
+void TPList::setRandomSeed(quint32 seed) {
 
-    bool foundFreeItem = false;
-    double count =  playlistWidget->countChildren();
-    int selected = int(count * qrand() / (RAND_MAX + 1.0));
-    bool foundSelected = false;
+    WZDEBUGOBJ(QString("Random seed %1").arg(seed));
+    randomGenerator.seed(seed);
+}
 
-    do {
-        int idx = 0;
-        QTreeWidgetItemIterator it(playlistWidget);
-        while (*it) {
-            TPlaylistItem* i = static_cast<TPlaylistItem*>(*it);
-            if (!i->isFolder()) {
-                if (idx == selected) {
-                    foundSelected = true;
-                }
+TPlaylistItem* TPList::getRandomItem() {
 
-                if (!i->played() && i->state() != PSTATE_FAILED) {
-                    if (foundSelected) {
-                        return i;
-                    } else {
-                        foundFreeItem = true;
-                    }
-                }
-
-                idx++;
-            }
-            it++;
-        }
-    } while (foundFreeItem);
+    int count = playlistWidget->unplayedCount();
+    if (count == 0) {
+        WZDEBUG("End of playlist");
+        return 0;
+    }
 
-    WZDEBUG("End of playlist");
-    return 0;
+    std::uniform_int_distribution<int> distribution(0, count - 1);
+    return playlistWidget->unplayedItem(distribution(randomGenerator));
 }
 
 void TPList::startPlay() {
@@ -1351,6 +1341,13 @@ void TPList:: setPLaylistTitle() {
             .arg(title)
             .arg(playlistWidget->isModified() ? "*" : "");
 
+    // Show the progress of adding files
+    int items, itemsPerSecond;
+    if (playlistWidget->addFilesProgress(items, itemsPerSecond)) {
+        title += tr(" - adding %1 items, %2 per second")
+                 .arg(items).arg(itemsPerSecond);
+    }
+
     dock->setWindowTitle(title);
 }
 
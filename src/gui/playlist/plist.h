@@ -3,6 +3,7 @@
 
 #include "gui/action/menu/menu.h"
 #include <QWidget>
+#include <random>
 
 
 class QToolBar;
@@ -39,6 +40,8 @@ public:
     TPlaylistWidget* getPlaylistWidget() const { return playlistWidget; }
 
     bool isBusy() const;
+    // Seed the shuffle, to repeat the same order
+    void setRandomSeed(quint32 seed);
 
     bool maybeSave();
     void setContextMenuToolbar(Action::Menu::TMenu* menu);
@@ -127,7 +130,8 @@ private:
     void createActions();
     void createToolbar();
 
-    TPlaylistItem* getRandomItem() const;
+    std::mt19937 randomGenerator;
+    TPlaylistItem* getRandomItem();
 
     void enableRemoveFromDiskAction();
     void enableActionsCurrentItem();
@@ -42,7 +42,12 @@ TAudio::TAudio(QWidget* parent, const Player::Info::TNameDescList& aol)
     setupUi(this);
 
 #if USE_ALSA_DEVICES
-    alsa_devices = TDeviceInfo::alsaDevices();
+    // Get the devices in the background, onALSADevicesFound() adds them
+    alsaDevicesThread = new TDeviceInfoThread(this,
+                                              TDeviceInfoThread::ALSA_DEVICES);
+    connect(alsaDevicesThread, &TDeviceInfoThread::finished,
+            this, &TAudio::onALSADevicesFound);
+    alsaDevicesThread->start();
 #endif
 
     // Channels combo
@@ -182,6 +187,18 @@ void TAudio::updateDriverCombo(Settings::TPreferences::TPlayerID player_id,
     setAO(wanted_ao);
 }
 
+#if USE_ALSA_DEVICES
+void TAudio::onALSADevicesFound() {
+
+    alsa_devices = alsaDevicesThread->devices;
+    alsaDevicesThread->deleteLater();
+    alsaDevicesThread = 0;
+    if (!alsa_devices.isEmpty()) {
+        updateDriverCombo(player_id, true);
+    }
+}
+#endif
+
 void TAudio::setAO(const QString& ao_driver) {
 
     int idx = ao_combo->findData(ao_driver);
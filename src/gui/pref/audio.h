@@ -49,7 +49,7 @@ public:
     virtual QPixmap sectionIcon();
 
     // Pass data to the dialog
-    void setData(Settings::TPreferences* pref);
+    virtual void setData(Settings::TPreferences* pref);
 
     // Apply changes
     virtual void getData(Settings::TPreferences* pref);
@@ -67,6 +67,7 @@ private:
 
 #if USE_ALSA_DEVICES
     TDeviceList alsa_devices;
+    TDeviceInfoThread* alsaDevicesThread;
 #endif
 
     void createHelp();
@@ -106,6 +107,9 @@ private:
 
 private slots:
     void onAOComboChanged(int);
+#if USE_ALSA_DEVICES
+    void onALSADevicesFound();
+#endif
 };
 
 } // namespace Pref
@@ -36,6 +36,7 @@
 #include "config.h"
 #include "images.h"
 #include "desktop.h"
+#include "wzdebug.h"
 
 
 #if USE_ASSOCIATIONS
@@ -43,13 +44,69 @@
 #endif
 
 #include <QTextBrowser>
+#include <QElapsedTimer>
 
 
 namespace Gui {
 namespace Pref {
 
+// Name and icon of the sections, to list the sections before creating them.
+// The names are translated in the context of the section.
+struct TSectionInfo {
+    const char* context;
+    const char* name;
+    const char* icon;
+};
+
+static const TSectionInfo section_info[TDialog::SECTION_COUNT] = {
+    { "Gui::Pref::TPlayerSection",
+      QT_TRANSLATE_NOOP("Gui::Pref::TPlayerSection", "Player"),
+      "pref_player" },
+    { "Gui::Pref::TDemuxer",
+      QT_TRANSLATE_NOOP("Gui::Pref::TDemuxer", "Demuxer"),
+      "pref_demuxer" },
+    { "Gui::Pref::TVideo",
+      QT_TRANSLATE_NOOP("Gui::Pref::TVideo", "Video"),
+      "pref_video" },
+    { "Gui::Pref::TAudio",
+      QT_TRANSLATE_NOOP("Gui::Pref::TAudio", "Audio"),
+      "speaker" },
+    { "Gui::Pref::TSubtitles",
+      QT_TRANSLATE_NOOP("Gui::Pref::TSubtitles", "Subtitles"),
+      "sub" },
+    { "Gui::Pref::TInterface",
+      QT_TRANSLATE_NOOP("Gui::Pref::TInterface", "Interface"),
+      "instance1" },
+    { "Gui::Pref::TPlaylistSection",
+      QT_TRANSLATE_NOOP("Gui::Pref::TPlaylistSection", "Playlist"),
+      "playlist" },
+    { "Gui::Pref::TInput",
+      QT_TRANSLATE_NOOP("Gui::Pref::TInput", "Input"),
+      "pref_input" },
+    { "Gui::Pref::TDrives",
+      QT_TRANSLATE_NOOP("Gui::Pref::TDrives", "Drives"),
+      "pref_devices" },
+    { "Gui::Pref::TCapture",
+      QT_TRANSLATE_NOOP("Gui::Pref::TCapture", "Capture"),
+      "screenshot" },
+    { "Gui::Pref::TPerformance",
+      QT_TRANSLATE_NOOP("Gui::Pref::TPerformance", "Performance"),
+      "pref_cache" },
+    { "Gui::Pref::TNetwork",
+      QT_TRANSLATE_NOOP("Gui::Pref::TNetwork", "Network"),
+      "pref_network" }
+#if USE_ASSOCIATIONS
+    ,{ "Gui::Pref::TAssociations",
+       QT_TRANSLATE_NOOP("Gui::Pref::TAssociations", "File Types"),
+       "pref_associations" }
+#endif
+};
+
 TDialog::TDialog(TMainWindow* mw) :
-    QDialog(mw) {
+    QDialog(mw),
+    page_list(SECTION_COUNT, 0),
+    created_sections(0),
+    data_pref(0) {
 
     setupUi(this);
 
@@ -79,70 +136,117 @@ TDialog::TDialog(TMainWindow* mw) :
     help_window->setWindowIcon(Images::icon("logo"));
     help_window->setOpenExternalLinks(true);
 
-    // Get VO and AO driver lists from TPlayerInfo:
+    // Get VO and AO driver lists from TPlayerInfo. The lists are updated by
+    // onPlayerInfoReady() when they still need to be retrieved.
     Player::Info::TPlayerInfo* i = Player::Info::TPlayerInfo::obj();
-    i->getInfo();
-
-    page_player = new TPlayerSection(this);
-    addSection(page_player);
-    connect(page_player, &TPlayerSection::binChanged,
-            this, &TDialog::onBinChanged);
-
-    page_demuxer = new TDemuxer(this);
-    addSection(page_demuxer);
-
-    page_video = new TVideo(this, i->voList());
-    addSection(page_video);
+    info_player_id = Settings::pref->player_id;
+    info_keep_drivers = true;
 
-    page_audio = new TAudio(this, i->aoList());
-    addSection(page_audio);
-
-    page_subtitles = new TSubtitles(this);
-    addSection(page_subtitles);
-
-    page_interface = new TInterface(this);
-    addSection(page_interface);
+    // List the sections with a placeholder page until they are shown
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        sections->addItem(new QListWidgetItem());
+        pages->addWidget(new QWidget(pages));
+    }
+    connect(sections, &QListWidget::currentRowChanged,
+            this, &TDialog::onSectionChanged);
+    sections->setCurrentRow(SECTION_PLAYER);
 
-    page_playlist = new TPlaylistSection(this);
-    addSection(page_playlist);
+    retranslateStrings();
 
-    page_input = new TInput(this);
-    addSection(page_input);
+    connect(i, &Player::Info::TPlayerInfo::infoReady,
+            this, &TDialog::onPlayerInfoReady);
+    i->probe();
+}
 
-    page_drives = new TDrives(this);
-    addSection(page_drives);
+TInput* TDialog::mod_input() {
+    return static_cast<TInput*>(page(SECTION_INPUT));
+}
 
-    page_capture = new TCapture(this);
-    addSection(page_capture);
+void TDialog::showSection(TSectionNumber section) {
+    sections->setCurrentRow(section);
+}
 
-    page_performance = new TPerformance(this);
-    addSection(page_performance);
+TSection* TDialog::page(TSectionNumber section) {
 
-    page_network = new TNetwork(this);
-    addSection(page_network);
+    if (page_list.at(section) == 0) {
+        createSection(section);
+    }
+    return page_list.at(section);
+}
 
+void TDialog::createSection(TSectionNumber section) {
+
+    QElapsedTimer timer;
+    timer.start();
+
+    TSection* s;
+    switch (section) {
+        case SECTION_PLAYER: {
+            TPlayerSection* p = new TPlayerSection(this);
+            connect(p, &TPlayerSection::binChanged,
+                    this, &TDialog::onBinChanged);
+            s = p;
+            break;
+        }
+        case SECTION_DEMUXER: s = new TDemuxer(this); break;
+        case SECTION_VIDEO:
+            s = new TVideo(this, Player::Info::TPlayerInfo::obj()->voList());
+            break;
+        case SECTION_AUDIO:
+            s = new TAudio(this, Player::Info::TPlayerInfo::obj()->aoList());
+            break;
+        case SECTION_SUBTITLES: s = new TSubtitles(this); break;
+        case SECTION_GUI: s = new TInterface(this); break;
+        case SECTION_PLAYLIST: s = new TPlaylistSection(this); break;
+        case SECTION_INPUT: s = new TInput(this); break;
+        case SECTION_DRIVES: s = new TDrives(this); break;
+        case SECTION_CAPTURE: s = new TCapture(this); break;
+        case SECTION_PERFORMANCE: s = new TPerformance(this); break;
+        case SECTION_NETWORK: s = new TNetwork(this); break;
 #if USE_ASSOCIATIONS
-    page_associations = new TAssociations(this);
-    addSection(page_associations);
+        case SECTION_ASSOCIATIONS: s = new TAssociations(this); break;
 #endif
+        default:
+            WZERROR(QString("Invalid section %1").arg(section));
+            return;
+    }
+    page_list[section] = s;
+    created_sections++;
+
+    // Replace the placeholder
+    QWidget* placeholder = pages->widget(section);
+    pages->insertWidget(section, s);
+    pages->removeWidget(placeholder);
+    delete placeholder;
+    if (sections->currentRow() == section) {
+        pages->setCurrentIndex(section);
+    }
 
-    sections->setCurrentRow(SECTION_PLAYER);
+    if (data_pref) {
+        s->setData(data_pref);
+    }
 
-    retranslateStrings();
+    WZDEBUG(QString("Created section '%1' (%2 of %3) with %4 widgets in %5 ms")
+            .arg(s->sectionName()).arg(created_sections).arg(SECTION_COUNT)
+            .arg(s->findChildren<QWidget*>().count()).arg(timer.elapsed()));
 }
 
-void TDialog::showSection(TSectionNumber section) {
-    sections->setCurrentRow(section);
+void TDialog::onSectionChanged(int row) {
+
+    if (row >= 0 && row < SECTION_COUNT) {
+        page(static_cast<TSectionNumber>(row));
+    }
 }
 
 void TDialog::retranslateStrings() {
 
     retranslateUi(this);
 
-    for (int n = 0; n < pages->count(); n++) {
-        TSection* w = (TSection*) pages->widget(n);
-        sections->item(n)->setText(w->sectionName());
-        sections->item(n)->setIcon(w->sectionIcon());
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        const TSectionInfo& info = section_info[n];
+        sections->item(n)->setText(
+                    QCoreApplication::translate(info.context, info.name));
+        sections->item(n)->setIcon(Images::icon(info.icon, 32));
     }
 
     if (help_window->isVisible()) {
@@ -181,93 +285,71 @@ void TDialog::onBinChanged(Settings::TPreferences::TPlayerID player_id,
                            bool keep_current_drivers,
                            const QString& path) {
 
-    Player::Info::TPlayerInfo* i = Player::Info::TPlayerInfo::obj();
-    i->getInfo(path);
-    page_video->vo_list = i->voList();
-    page_video->updateDriverCombo(player_id, keep_current_drivers);
-    page_audio->ao_list = i->aoList();
-    page_audio->updateDriverCombo(player_id, keep_current_drivers);
+    info_player_id = player_id;
+    info_keep_drivers = keep_current_drivers;
+    // The drivers of the video and audio section need to follow the player
+    page(SECTION_VIDEO);
+    page(SECTION_AUDIO);
+    Player::Info::TPlayerInfo::obj()->probe(path);
 }
 
-void TDialog::addSection(TSection* s) {
+void TDialog::onPlayerInfoReady() {
 
-    QListWidgetItem *i = new QListWidgetItem(s->sectionIcon(), s->sectionName());
-    sections->addItem(i);
-    pages->addWidget(s);
+    Player::Info::TPlayerInfo* i = Player::Info::TPlayerInfo::obj();
+    TVideo* video = static_cast<TVideo*>(page_list.at(SECTION_VIDEO));
+    if (video) {
+        video->vo_list = i->voList();
+        video->updateDriverCombo(info_player_id, info_keep_drivers);
+    }
+    TAudio* audio = static_cast<TAudio*>(page_list.at(SECTION_AUDIO));
+    if (audio) {
+        audio->ao_list = i->aoList();
+        audio->updateDriverCombo(info_player_id, info_keep_drivers);
+    }
 }
 
 void TDialog::setData(Settings::TPreferences* pref) {
 
-    page_player->setData(pref);
-    page_demuxer->setData(pref);
-    page_video->setData(pref);
-    page_audio->setData(pref);
-    page_subtitles->setData(pref);
-    page_interface->setData(pref);
-    page_playlist->setData(pref);
-    page_input->setData(pref);
-    page_drives->setData(pref);
-    page_capture->setData(pref);
-    page_performance->setData(pref);
-    page_network->setData(pref);
-
-#if USE_ASSOCIATIONS
-    page_associations->setData(pref);
-#endif
-
+    data_pref = pref;
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        TSection* s = page_list.at(n);
+        if (s) {
+            s->setData(pref);
+        }
+    }
 }
 
+// Sections not created cannot have changes
 void TDialog::getData(Settings::TPreferences* pref) {
 
-    page_player->getData(pref);
-    page_demuxer->getData(pref);
-    page_video->getData(pref);
-    page_audio->getData(pref);
-    page_subtitles->getData(pref);
-    page_interface->getData(pref);
-    page_playlist->getData(pref);
-    page_input->getData(pref);
-    page_drives->getData(pref);
-    page_capture->getData(pref);
-    page_performance->getData(pref);
-    page_network->getData(pref);
-
-#if USE_ASSOCIATIONS
-    page_associations->getData(pref);
-#endif
-
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        TSection* s = page_list.at(n);
+        if (s) {
+            s->getData(pref);
+        }
+    }
 }
 
 bool TDialog::requiresRestartApp() {
 
-    return page_player->requiresRestartApp()
-            || page_demuxer->requiresRestartApp()
-            || page_video->requiresRestartApp()
-            || page_audio->requiresRestartApp()
-            || page_subtitles->requiresRestartApp()
-            || page_interface->requiresRestartApp()
-            || page_playlist->requiresRestartApp()
-            || page_input->requiresRestartApp()
-            || page_drives->requiresRestartApp()
-            || page_capture->requiresRestartApp()
-            || page_performance->requiresRestartApp()
-            || page_network->requiresRestartApp();
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        TSection* s = page_list.at(n);
+        if (s && s->requiresRestartApp()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool TDialog::requiresRestartPlayer() {
 
-    return page_player->requiresRestartPlayer()
-            || page_demuxer->requiresRestartPlayer()
-            || page_video->requiresRestartPlayer()
-            || page_audio->requiresRestartPlayer()
-            || page_subtitles->requiresRestartPlayer()
-            || page_interface->requiresRestartPlayer()
-            || page_playlist->requiresRestartPlayer()
-            || page_input->requiresRestartPlayer()
-            || page_drives->requiresRestartPlayer()
-            || page_capture->requiresRestartPlayer()
-            || page_performance->requiresRestartPlayer()
-            || page_network->requiresRestartPlayer();
+    for (int n = 0; n < SECTION_COUNT; n++) {
+        TSection* s = page_list.at(n);
+        if (s && s->requiresRestartPlayer()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void TDialog::showHelp() {
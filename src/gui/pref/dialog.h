@@ -23,6 +23,8 @@
 #include "log4qt/logger.h"
 #include "settings/preferences.h"
 
+#include <QVector>
+
 
 class QTextBrowser;
 class QPushButton;
@@ -35,25 +37,10 @@ class TMainWindow;
 namespace Pref {
 
 class TSection;
-class TPlayerSection;
-class TDemuxer;
-class TVideo;
-class TAudio;
-class TSubtitles;
-class TInterface;
-class TPlaylistSection;
 class TInput;
-class TDrives;
-class TCapture;
-class TUpdates;
-class TNetwork;
-class TPerformance;
-
-#if USE_ASSOCIATIONS
-class TAssociations;
-#endif
 
 
+// The sections are created when they are shown for the first time
 class TDialog : public QDialog, public Ui::TDialog {
     Q_OBJECT
     LOG4QT_DECLARE_QCLASS_LOGGER
@@ -71,15 +58,16 @@ public:
         SECTION_DRIVES,
         SECTION_CAPTURE,
         SECTION_PERFORMANCE,
-        SECTION_NETWORK
+        SECTION_NETWORK,
 #if USE_ASSOCIATIONS
-        ,SECTION_ASSOCIATIONS
+        SECTION_ASSOCIATIONS,
 #endif
+        SECTION_COUNT
     };
 
     TDialog(TMainWindow* mw);
 
-    TInput* mod_input() const { return page_input; }
+    TInput* mod_input();
 
     // Pass data to the standard dialogs
     void setData(Settings::TPreferences* pref);
@@ -107,33 +95,29 @@ protected:
     virtual void changeEvent(QEvent* event);
 
 private:
-    TPlayerSection* page_player;
-    TDemuxer* page_demuxer;
-    TVideo* page_video;
-    TAudio* page_audio;
-    TSubtitles* page_subtitles;
-    TInterface* page_interface;
-    TPlaylistSection* page_playlist;
-    TInput* page_input;
-    TDrives* page_drives;
-    TCapture* page_capture;
-    TPerformance* page_performance;
-    TNetwork* page_network;
-
-#if USE_ASSOCIATIONS
-    TAssociations* page_associations;
-#endif
-
+    // Created sections, 0 until shown
+    QVector<TSection*> page_list;
+    int created_sections;
+    // Preferences passed to setData(), to pass to sections created later
+    Settings::TPreferences* data_pref;
 
     QTextBrowser* help_window;
     QPushButton* helpButton;
 
-    void addSection(TSection* s);
+    // Driver combo update waiting for TPlayerInfo
+    Settings::TPreferences::TPlayerID info_player_id;
+    bool info_keep_drivers;
+
+    // Return section, creating it when needed
+    TSection* page(TSectionNumber section);
+    void createSection(TSectionNumber section);
 
 private slots:
+    void onSectionChanged(int row);
     void showHelp();
     void onBinChanged(Settings::TPreferences::TPlayerID player_id,
                       bool keep_current_drivers, const QString &path);
+    void onPlayerInfoReady();
 };
 
 } // namespace Pref
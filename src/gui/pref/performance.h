@@ -40,7 +40,7 @@ public:
     virtual QPixmap sectionIcon();
 
     // Pass data to the dialog
-    void setData(Settings::TPreferences* pref);
+    virtual void setData(Settings::TPreferences* pref);
 
     // Apply changes
     virtual void getData(Settings::TPreferences* pref);
@@ -57,6 +57,7 @@ void TPlaylistSection::setData(Settings::TPreferences* pref) {
     image_duration_spinbox->setValue(pref->imageDuration);
 
     directory_playlist_check->setChecked(pref->useDirectoriePlaylists);
+    auto_refresh_check->setChecked(pref->autoRefreshPlaylist);
 
     name_blacklist_edit->setPlainText(pref->nameBlacklist.join("\n"));
     title_blacklist_edit->setPlainText(pref->titleBlacklist.join("\n"));
@@ -77,6 +78,7 @@ void TPlaylistSection::getData(Settings::TPreferences* pref) {
     }
     pref->imageDuration = image_duration_spinbox->value();
     pref->useDirectoriePlaylists = directory_playlist_check->isChecked();
+    pref->autoRefreshPlaylist = auto_refresh_check->isChecked();
 
     pref->nameBlacklist = name_blacklist_edit->toPlainText().split("\n",
         QString::SkipEmptyParts);
@@ -101,6 +103,9 @@ void TPlaylistSection::createHelp() {
         tr("Check this option to add files in subdirectories recursively"
            " to the playlist when opening a directory. Otherwise only the files"
            " directly inside the directory will be added to the playlist."));
+    setWhatsThis(auto_refresh_check, tr("Refresh directory playlists"),
+        tr("Check this option to update the playlist when files are added to"
+           " or removed from the directory it was opened from."));
 }
 
 }} // namespace Gui::Pref
@@ -32,6 +32,10 @@ TSection::TSection(QWidget* parent, Qt::WindowFlags f) :
     iconSize(32) {
 }
 
+void TSection::setData(Settings::TPreferences* pref) {
+    Q_UNUSED(pref)
+}
+
 void TSection::getData(Settings::TPreferences* pref) {
     Q_UNUSED(pref)
 
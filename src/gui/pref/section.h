@@ -40,6 +40,9 @@ class TSection : public QWidget {
 public:
     TSection(QWidget* parent = 0, Qt::WindowFlags f = 0);
 
+    // Pass data to the section
+    virtual void setData(Settings::TPreferences* pref);
+    // Apply changes
     virtual void getData(Settings::TPreferences* pref);
 
     // Return the name of the section
@@ -41,7 +41,12 @@ TVideo::TVideo(QWidget* parent, const Player::Info::TNameDescList& vol) :
     setupUi(this);
 
 #if USE_XV_ADAPTORS
-    xv_adaptors = TDeviceInfo::xvAdaptors();
+    // Get the adaptors in the background, onXVAdaptorsFound() adds them
+    xvAdaptorsThread = new TDeviceInfoThread(this,
+                                             TDeviceInfoThread::XV_ADAPTORS);
+    connect(xvAdaptorsThread, &TDeviceInfoThread::finished,
+            this, &TVideo::onXVAdaptorsFound);
+    xvAdaptorsThread->start();
 #endif
 
     // Hardware decoding combo
@@ -271,6 +276,18 @@ void TVideo::updateDriverCombo(TPreferences::TPlayerID player_id,
     setVO(wanted_vo);
 }
 
+#if USE_XV_ADAPTORS
+void TVideo::onXVAdaptorsFound() {
+
+    xv_adaptors = xvAdaptorsThread->devices;
+    xvAdaptorsThread->deleteLater();
+    xvAdaptorsThread = 0;
+    if (!xv_adaptors.isEmpty()) {
+        updateDriverCombo(player_id, true);
+    }
+}
+#endif
+
 void TVideo::setVO(const QString& vo_driver) {
 
     int idx = vo_combo->findData(vo_driver);
@@ -51,7 +51,7 @@ public:
     virtual QPixmap sectionIcon();
 
     // Pass data to the dialog
-    void setData(Settings::TPreferences* pref);
+    virtual void setData(Settings::TPreferences* pref);
 
     // Apply changes
     virtual void getData(Settings::TPreferences* pref);
@@ -69,6 +69,7 @@ private:
 
 #if USE_XV_ADAPTORS
     TDeviceList xv_adaptors;
+    TDeviceInfoThread* xvAdaptorsThread;
 #endif
 
 #ifndef Q_OS_WIN
@@ -109,6 +110,9 @@ private:
 
 private slots:
     void onVOComboChanged(int);
+#if USE_XV_ADAPTORS
+    void onXVAdaptorsFound();
+#endif
 
 #ifndef Q_OS_WIN
     void on_vdpau_button_clicked();
@@ -12,23 +12,32 @@ LOG4QT_DECLARE_STATIC_LOGGER(logger, TIconProvider)
 
 TIconProvider iconProvider;
 
-TIconProvider::TIconProvider() : iconSize(QSize(22, 22)) {
+TIconProvider::TIconProvider() :
+    iconSize(QSize(22, 22)),
+    style(0),
+    mutex(QMutex::Recursive),
+    cache_hits(0),
+    cache_misses(0) {
+
+    for (int i = 0; i < ICON_COUNT; i++) {
+        created[i] = false;
+    }
 }
 
 QIcon TIconProvider::getIconSymLinked(const QIcon& icon) {
 
-    if (icon.cacheKey() == folderIcon.cacheKey()) {
-        return folderSymLinkIcon;
+    if (icon.cacheKey() == folderIcon().cacheKey()) {
+        return folderSymLinkIcon();
     }
-    return fileSymLinkIcon;
+    return fileSymLinkIcon();
 }
 
 QIcon TIconProvider::getIconLinked(const QIcon& icon) {
 
-    if (icon.cacheKey() == folderIcon.cacheKey()) {
-        return folderSymLinkIcon;
+    if (icon.cacheKey() == folderIcon().cacheKey()) {
+        return folderSymLinkIcon();
     }
-    return fileLinkIcon;
+    return fileLinkIcon();
 }
 
 static QPen getPen() {
@@ -102,8 +111,9 @@ QIcon TIconProvider::getFileSymLinkedIcon() {
     if (linkIcon.isNull()) {
         return style->standardIcon(QStyle::SP_FileLinkIcon);
     }
-    QSize size = fileIcon.actualSize(iconSize);
-    QPixmap pixmap = fileIcon.pixmap(size);
+    QIcon file = fileIcon();
+    QSize size = file.actualSize(iconSize);
+    QPixmap pixmap = file.pixmap(size);
     QPainter painter(&pixmap);
     linkIcon.paint(&painter, QRect(QPoint(), size));
     return pixmap;
@@ -129,74 +139,129 @@ QIcon TIconProvider::getIconStd(const QString& name,
 }
 
 
+QIcon TIconProvider::getIconDir(QStyle::StandardPixmap closed,
+                                QStyle::StandardPixmap open) {
+
+    QIcon icon;
+    icon.addPixmap(style->standardPixmap(closed), QIcon::Normal, QIcon::Off);
+    icon.addPixmap(style->standardPixmap(open), QIcon::Normal, QIcon::On);
+    return icon;
+}
+
+QIcon TIconProvider::createIcon(TIconId id) {
+
+    switch (id) {
+        case URL_ICON: return Images::icon("open_url");
+        case FILE_ICON: return style->standardIcon(QStyle::SP_FileIcon);
+        case FILE_SYM_LINK_ICON: return getFileSymLinkedIcon();
+        case FILE_LINK_ICON:
+            return getIconStd("emblem-symbolic-link", QStyle::SP_FileLinkIcon);
+        case FOLDER_ICON:
+            return getIconDir(QStyle::SP_DirClosedIcon, QStyle::SP_DirOpenIcon);
+        case FOLDER_SYM_LINK_ICON:
+            return getIconDir(QStyle::SP_DirLinkIcon,
+                              QStyle::SP_DirLinkOpenIcon);
+
+        case AUDIO_CD_ICON: return Images::icon("cdda");
+        case VIDEO_CD_ICON: return Images::icon("vcd");
+        // TODO: icon size is 32
+        case DVD_ICON: return Images::icon("dvd", iconSize.width());
+        case BR_ICON: return Images::icon("vcd", iconSize.width());
+
+        case ICON_PLAYED: return style->standardIcon(QStyle::SP_DialogOkButton);
+        case ICON_LOADING: return Images::icon("loading");
+        case ICON_PLAYING: return style->standardIcon(QStyle::SP_MediaPlay);
+        case ICON_STOPPING: return Images::icon("stopping");
+        case ICON_FAILED: return Images::icon("failed");
+
+        case RECENT_ICON:
+            return getIconImage("document-open-recent", "recent_menu");
+        case OPEN_ICON:
+            return style->standardIcon(QStyle::SP_DialogOpenButton);
+        case SAVE_ICON:
+            return style->standardIcon(QStyle::SP_DialogSaveButton);
+        case SAVE_AS_ICON:
+            return getIconStd("document-save-as", QStyle::SP_DriveHDIcon);
+        case REFRESH_ICON:
+            return style->standardIcon(QStyle::SP_BrowserReload);
+        case BROWSE_URL_ICON:
+            return getIconStd("system-file-manager", QStyle::SP_DirOpenIcon);
+        case NEW_FOLDER_ICON:
+            return style->standardIcon(QStyle::SP_FileDialogNewFolder);
+        case CLOSE_ICON:
+            return getIconStd("window-close", QStyle::SP_DialogCloseButton);
+        case QUIT_ICON: return getIconImage("application-exit", "exit");
+
+        case PAUSE_ICON: return Images::icon("pause");
+        case PLAY_ICON: return Images::icon("play");
+
+        case FULLSCREEN_ICON:
+            return getIconImage("view-fullscreen", "fullscreen");
+        case FULLSCREEN_EXIT_ICON:
+            return getIconImage("view-restore", "fullscreen");
+        case WINDOW_SIZE_ICON:
+            return getIconImage("zoom-in", "window_size_menu");
+        case OPTIMIZE_SIZE_ICON:
+            return getIconImage("zoom-fit-best", "size_optimize");
+        case ZOOM_RESET_ICON:
+            return getIconImage("zoom-original", "reset_zoom_pan");
+        case ZOOM_IN_ICON: return getIconImage("zoom-in", "inc_zoom");
+        case ZOOM_OUT_ICON: return getIconImage("zoom-out", "dec_zoom");
+
+        case CUT_ICON: return getIconImage("edit-cut", "cut");
+        case COPY_ICON: return getIconImage("edit-copy", "copy");
+        case PASTE_ICON: return getIconImage("edit-paste", "paste");
+        case FIND_ICON: return getIconImage("edit-find", "find");
+
+        case OK_ICON: return style->standardIcon(QStyle::SP_DialogOkButton);
+        case CANCEL_ICON:
+            return style->standardIcon(QStyle::SP_DialogCancelButton);
+
+        case TRASH_ICON: return style->standardIcon(QStyle::SP_TrashIcon);
+        case DISCARD_ICON:
+            return style->standardIcon(QStyle::SP_DialogDiscardButton);
+        case CLEAR_ICON:
+            return getIconStd("edit-clear", QStyle::SP_DialogResetButton);
+
+        case CONFLICT_ITEM: return Images::icon("conflict");
+
+        case ICON_COUNT: break;
+    }
+
+    WZERROR(QString("Unknown icon id %1").arg(id));
+    return QIcon();
+}
+
+QIcon TIconProvider::icon(TIconId id) {
+
+    QMutexLocker locker(&mutex);
+    if (created[id]) {
+        cache_hits++;
+    } else {
+        cache_misses++;
+        icons[id] = createIcon(id);
+        created[id] = true;
+    }
+    return icons[id];
+}
+
 void TIconProvider::setStyle(QStyle* aStyle) {
 
     style = aStyle;
 
-    urlIcon =  Images::icon("open_url");
-    fileIcon = style->standardIcon(QStyle::SP_FileIcon);
-
-    fileSymLinkIcon = getFileSymLinkedIcon();
-    fileLinkIcon = getIconStd("emblem-symbolic-link", QStyle::SP_FileLinkIcon);
-
-    folderIcon = QIcon();
-    folderIcon.addPixmap(style->standardPixmap(QStyle::SP_DirClosedIcon),
-                         QIcon::Normal, QIcon::Off);
-    folderIcon.addPixmap(style->standardPixmap(QStyle::SP_DirOpenIcon),
-                         QIcon::Normal, QIcon::On);
-
-    folderSymLinkIcon = QIcon();
-    folderSymLinkIcon.addPixmap(style->standardPixmap(QStyle::SP_DirLinkIcon),
-                             QIcon::Normal, QIcon::Off);
-    folderSymLinkIcon.addPixmap(style->standardPixmap(QStyle::SP_DirLinkOpenIcon),
-                             QIcon::Normal, QIcon::On);
-
-    audioCDIcon = Images::icon("cdda");
-    videoCDIcon = Images::icon("vcd");
-    // TODO: icon size is 32
-    dvdIcon = Images::icon("dvd", iconSize.width());
-    brIcon = Images::icon("vcd", iconSize.width());
-
-    iconPlayed =  style->standardIcon(QStyle::SP_DialogOkButton);
-    iconLoading = Images::icon("loading");
-    iconPlaying =  style->standardIcon(QStyle::SP_MediaPlay);
-    iconStopping = Images::icon("stopping");
-    iconFailed =  Images::icon("failed");
-
-    recentIcon = getIconImage("document-open-recent", "recent_menu");
-    openIcon = style->standardIcon(QStyle::SP_DialogOpenButton);
-    saveIcon = style->standardIcon(QStyle::SP_DialogSaveButton);
-    saveAsIcon = getIconStd("document-save-as", QStyle::SP_DriveHDIcon);
-    refreshIcon = style->standardIcon(QStyle::SP_BrowserReload);
-    browseURLIcon = getIconStd("system-file-manager", QStyle::SP_DirOpenIcon);
-
-    newFolderIcon = style->standardIcon(QStyle::SP_FileDialogNewFolder);
-
-    closeIcon = getIconStd("window-close", QStyle::SP_DialogCloseButton);
-    quitIcon = getIconImage("application-exit", "exit");
-
-    pauseIcon = Images::icon("pause");
-    playIcon = Images::icon("play");
-
-    fullscreenIcon = getIconImage("view-fullscreen", "fullscreen");
-    fullscreenExitIcon = getIconImage("view-restore", "fullscreen");
-    windowSizeIcon = getIconImage("zoom-in", "window_size_menu");
-    optimizeSizeIcon = getIconImage("zoom-fit-best", "size_optimize");
-    zoomResetIcon = getIconImage("zoom-original", "reset_zoom_pan");
-    zoomInIcon = getIconImage("zoom-in", "inc_zoom");
-    zoomOutIcon = getIconImage("zoom-out", "dec_zoom");
-
-    cutIcon = getIconImage("edit-cut", "cut");
-    copyIcon = getIconImage("edit-copy", "copy");
-    pasteIcon = getIconImage("edit-paste", "paste");
-    findIcon = getIconImage("edit-find", "find");
-
-    okIcon = style->standardIcon(QStyle::SP_DialogOkButton);
-    cancelIcon = style->standardIcon(QStyle::SP_DialogCancelButton);
-
-    trashIcon = style->standardIcon(QStyle::SP_TrashIcon);
-    discardIcon = style->standardIcon(QStyle::SP_DialogDiscardButton);
-    clearIcon = getIconStd("edit-clear", QStyle::SP_DialogResetButton);
-
-    conflictItem = Images::icon("conflict");
+    // Drop the icons of the previous style
+    {
+        QMutexLocker locker(&mutex);
+        for (int i = 0; i < ICON_COUNT; i++) {
+            icons[i] = QIcon();
+            created[i] = false;
+        }
+    }
+    iconBlacklistedCache.clear();
+    iconEditedCache.clear();
+
+    // Create the icons used by TPlaylistItem in the GUI thread
+    for (int i = URL_ICON; i <= BR_ICON; i++) {
+        icon(static_cast<TIconId>(i));
+    }
 }
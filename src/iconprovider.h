@@ -5,6 +5,7 @@
 #include <QFileInfo>
 #include <QSize>
 #include <QMap>
+#include <QMutex>
 #include <QStyle>
 
 
@@ -15,58 +16,121 @@ public:
 
     QSize iconSize;
 
-    QIcon urlIcon;
-    QIcon fileIcon;
-    QIcon fileSymLinkIcon;
-    QIcon fileLinkIcon;
-    QIcon folderIcon;
-    QIcon folderSymLinkIcon;
-
-    QIcon audioCDIcon;
-    QIcon videoCDIcon;
-    QIcon dvdIcon;
-    QIcon brIcon;
-
-    QIcon iconPlayed;
-    QIcon iconLoading;
-    QIcon iconPlaying;
-    QIcon iconStopping;
-    QIcon iconFailed;
-
-    QIcon recentIcon;
-    QIcon openIcon;
-    QIcon saveIcon;
-    QIcon saveAsIcon;
-    QIcon refreshIcon;
-    QIcon browseURLIcon;
-    QIcon newFolderIcon;
-    QIcon closeIcon;
-    QIcon quitIcon;
-
-    QIcon pauseIcon;
-    QIcon playIcon;
-
-    QIcon fullscreenIcon;
-    QIcon fullscreenExitIcon;
-    QIcon windowSizeIcon;
-    QIcon optimizeSizeIcon;
-    QIcon zoomResetIcon;
-    QIcon zoomInIcon;
-    QIcon zoomOutIcon;
-
-    QIcon cutIcon;
-    QIcon copyIcon;
-    QIcon pasteIcon;
-    QIcon findIcon;
-
-    QIcon okIcon;
-    QIcon cancelIcon;
-
-    QIcon trashIcon;
-    QIcon discardIcon;
-    QIcon clearIcon;
-
-    QIcon conflictItem;
+    enum TIconId {
+        URL_ICON,
+        FILE_ICON,
+        FILE_SYM_LINK_ICON,
+        FILE_LINK_ICON,
+        FOLDER_ICON,
+        FOLDER_SYM_LINK_ICON,
+
+        AUDIO_CD_ICON,
+        VIDEO_CD_ICON,
+        DVD_ICON,
+        BR_ICON,
+
+        ICON_PLAYED,
+        ICON_LOADING,
+        ICON_PLAYING,
+        ICON_STOPPING,
+        ICON_FAILED,
+
+        RECENT_ICON,
+        OPEN_ICON,
+        SAVE_ICON,
+        SAVE_AS_ICON,
+        REFRESH_ICON,
+        BROWSE_URL_ICON,
+        NEW_FOLDER_ICON,
+        CLOSE_ICON,
+        QUIT_ICON,
+
+        PAUSE_ICON,
+        PLAY_ICON,
+
+        FULLSCREEN_ICON,
+        FULLSCREEN_EXIT_ICON,
+        WINDOW_SIZE_ICON,
+        OPTIMIZE_SIZE_ICON,
+        ZOOM_RESET_ICON,
+        ZOOM_IN_ICON,
+        ZOOM_OUT_ICON,
+
+        CUT_ICON,
+        COPY_ICON,
+        PASTE_ICON,
+        FIND_ICON,
+
+        OK_ICON,
+        CANCEL_ICON,
+
+        TRASH_ICON,
+        DISCARD_ICON,
+        CLEAR_ICON,
+
+        CONFLICT_ITEM,
+
+        ICON_COUNT
+    };
+
+    // Icons are created on first use and shared by all users, like the
+    // items of the playlists, until the style changes. The icons of playlist
+    // items are created by setStyle(), because the items are created by the
+    // thread adding files.
+    QIcon icon(TIconId id);
+
+    QIcon urlIcon() { return icon(URL_ICON); }
+    QIcon fileIcon() { return icon(FILE_ICON); }
+    QIcon fileSymLinkIcon() { return icon(FILE_SYM_LINK_ICON); }
+    QIcon fileLinkIcon() { return icon(FILE_LINK_ICON); }
+    QIcon folderIcon() { return icon(FOLDER_ICON); }
+    QIcon folderSymLinkIcon() { return icon(FOLDER_SYM_LINK_ICON); }
+
+    QIcon audioCDIcon() { return icon(AUDIO_CD_ICON); }
+    QIcon videoCDIcon() { return icon(VIDEO_CD_ICON); }
+    QIcon dvdIcon() { return icon(DVD_ICON); }
+    QIcon brIcon() { return icon(BR_ICON); }
+
+    QIcon iconPlayed() { return icon(ICON_PLAYED); }
+    QIcon iconLoading() { return icon(ICON_LOADING); }
+    QIcon iconPlaying() { return icon(ICON_PLAYING); }
+    QIcon iconStopping() { return icon(ICON_STOPPING); }
+    QIcon iconFailed() { return icon(ICON_FAILED); }
+
+    QIcon recentIcon() { return icon(RECENT_ICON); }
+    QIcon openIcon() { return icon(OPEN_ICON); }
+    QIcon saveIcon() { return icon(SAVE_ICON); }
+    QIcon saveAsIcon() { return icon(SAVE_AS_ICON); }
+    QIcon refreshIcon() { return icon(REFRESH_ICON); }
+    QIcon browseURLIcon() { return icon(BROWSE_URL_ICON); }
+    QIcon newFolderIcon() { return icon(NEW_FOLDER_ICON); }
+    QIcon closeIcon() { return icon(CLOSE_ICON); }
+    QIcon quitIcon() { return icon(QUIT_ICON); }
+
+    QIcon pauseIcon() { return icon(PAUSE_ICON); }
+    QIcon playIcon() { return icon(PLAY_ICON); }
+
+    QIcon fullscreenIcon() { return icon(FULLSCREEN_ICON); }
+    QIcon fullscreenExitIcon() { return icon(FULLSCREEN_EXIT_ICON); }
+    QIcon windowSizeIcon() { return icon(WINDOW_SIZE_ICON); }
+    QIcon optimizeSizeIcon() { return icon(OPTIMIZE_SIZE_ICON); }
+    QIcon zoomResetIcon() { return icon(ZOOM_RESET_ICON); }
+    QIcon zoomInIcon() { return icon(ZOOM_IN_ICON); }
+    QIcon zoomOutIcon() { return icon(ZOOM_OUT_ICON); }
+
+    QIcon cutIcon() { return icon(CUT_ICON); }
+    QIcon copyIcon() { return icon(COPY_ICON); }
+    QIcon pasteIcon() { return icon(PASTE_ICON); }
+    QIcon findIcon() { return icon(FIND_ICON); }
+
+    QIcon okIcon() { return icon(OK_ICON); }
+    QIcon cancelIcon() { return icon(CANCEL_ICON); }
+
+    QIcon trashIcon() { return icon(TRASH_ICON); }
+    QIcon discardIcon() { return icon(DISCARD_ICON); }
+    QIcon clearIcon() { return icon(CLEAR_ICON); }
+
+    QIcon conflictItem() { return icon(CONFLICT_ITEM); }
 
     void setStyle(QStyle* aStyle);
     QIcon getIconSymLinked(const QIcon& icon);
@@ -74,13 +138,24 @@ public:
     QIcon getIconBlacklisted(const QIcon& icon);
     QIcon getIconEdited(const QIcon& icon);
 
+    int cacheHits() const { return cache_hits; }
+    int cacheMisses() const { return cache_misses; }
+
 private:
     QStyle* style;
+    QMutex mutex;
+    QIcon icons[ICON_COUNT];
+    bool created[ICON_COUNT];
+    int cache_hits;
+    int cache_misses;
     QMap<qint64, QIcon> iconBlacklistedCache;
     QMap<qint64, QIcon> iconEditedCache;
 
     QIcon getIconImage(const QString& name, const QString& name2);
     QIcon getIconStd(const QString& name, QStyle::StandardPixmap stdIcon);
+    QIcon getIconDir(QStyle::StandardPixmap closed,
+                     QStyle::StandardPixmap open);
+    QIcon createIcon(TIconId id);
 
     QIcon getFileSymLinkedIcon();
     QPixmap getPixMapEdited(QIcon icon, QIcon::Mode mode, QIcon::State state);
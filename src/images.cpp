@@ -23,6 +23,7 @@
 #include <QResource>
 
 #include "wzdebug.h"
+#include "starttrace.h"
 #include "settings/preferences.h"
 #include "settings/paths.h"
 
@@ -36,8 +37,13 @@ QString Images::themes_path;
 QString Images::last_resource_loaded;
 bool Images::has_rcc = false;
 
+QHash<QString, QPixmap> Images::cache;
+int Images::cache_hits = 0;
+int Images::cache_misses = 0;
+
 
 void Images::setTheme(const QString& name) {
+    WZSTARTTRACE("Images::setTheme");
 
     if (!last_resource_loaded.isEmpty()) {
         WZD << "Unloading" << last_resource_loaded;
@@ -46,6 +52,11 @@ void Images::setTheme(const QString& name) {
     }
     has_rcc = false;
 
+    if (!cache.isEmpty()) {
+        WZD << "Clearing" << cache.count() << "cached icons of theme"
+            << current_theme;
+        cache.clear();
+    }
     current_theme = name;
 
     QString dir = TPaths::configPath() + "/themes/" + name;
@@ -99,22 +110,59 @@ QString Images::iconFilename(const QString& name) {
     return filename;
 }
 
-QPixmap Images::icon(const QString& name, int size) {
+QPixmap Images::loadIcon(const QString& name, int size, bool flipped) {
+
+    qint64 start = TStartTrace::isEnabled() ? TStartTrace::now() : 0;
+    QPixmap pixmap(iconFilename(name));
+    if (pixmap.isNull()) {
+        // WZT << name << "not found");
+    } else {
+        if (size > 0) {
+            pixmap = resize(pixmap, size);
+        }
+        if (flipped) {
+            pixmap = flip(pixmap);
+        }
+    }
+
+    if (TStartTrace::isEnabled()) {
+        TStartTrace::complete("Images::icon " + name, start);
+    }
+    return pixmap;
+}
+
+QPixmap Images::cachedIcon(const QString& name, int size, bool flipped) {
 
     if (name.isEmpty()) {
         return QPixmap();
     }
 
-    QPixmap pixmap(iconFilename(name));
-    if (pixmap.isNull()) {
-        // WZT << name << "not found");
-    } else if (size > 0) {
-        pixmap = resize(pixmap, size);
+    // Switch theme before building the key
+    if (current_theme != pref->iconset) {
+        setTheme(pref->iconset);
     }
 
+    if (size <= 0) {
+        size = -1;
+    }
+    QString key = current_theme + "/" + name + "/" + QString::number(size)
+                  + (flipped ? "/f" : "");
+    QHash<QString, QPixmap>::const_iterator i = cache.constFind(key);
+    if (i != cache.constEnd()) {
+        cache_hits++;
+        return i.value();
+    }
+
+    cache_misses++;
+    QPixmap pixmap = loadIcon(name, size, flipped);
+    cache.insert(key, pixmap);
     return pixmap;
 }
 
+QPixmap Images::icon(const QString& name, int size) {
+    return cachedIcon(name, size, false);
+}
+
 QPixmap Images::resize(const QPixmap& pixmap, int size) {
     return QPixmap::fromImage(
                 pixmap.toImage()
@@ -127,7 +175,7 @@ QPixmap Images::flip(const QPixmap& pixmap) {
 }
 
 QPixmap Images::flippedIcon(const QString& name, int size) {
-    return flip(icon(name, size));
+    return cachedIcon(name, size, true);
 }
 
 QString Images::styleSheet() {
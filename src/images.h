@@ -22,6 +22,7 @@
 #include <QString>
 #include <QPixmap>
 #include <QIcon>
+#include <QHash>
 
 
 // TODO: rename to TImages
@@ -29,10 +30,15 @@ class Images {
 public:
     static void setTheme(const QString& name);
 
+    // Icons are loaded on first use and cached by theme, name, size and flip
+    // until the theme changes
     static QPixmap icon(const QString& name, int size=-1);
     static QPixmap flippedIcon(const QString& name, int size=-1);
     static QString iconFilename(const QString& icon_name);
 
+    static int cacheHits() { return cache_hits; }
+    static int cacheMisses() { return cache_misses; }
+
     static QString styleSheet();
     static QString themesDirectory();
 
@@ -41,10 +47,16 @@ public:
 private:
     static QPixmap resize(const QPixmap& pixmap, int size = 20);
     static QPixmap flip(const QPixmap& pixmap);
+    static QPixmap cachedIcon(const QString& name, int size, bool flipped);
+    static QPixmap loadIcon(const QString& name, int size, bool flipped);
 
     static QString current_theme;
     static QString themes_path;
     static QString last_resource_loaded;
+
+    static QHash<QString, QPixmap> cache;
+    static int cache_hits;
+    static int cache_misses;
 };
 
 #endif
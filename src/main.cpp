@@ -27,6 +27,9 @@
 #include "gui/logwindow.h"
 #include "gui/logwindowappender.h"
 #include "settings/preferences.h"
+#include "iconprovider.h"
+#include "images.h"
+#include "starttrace.h"
 #include "wzdebug.h"
 
 
@@ -133,9 +136,33 @@ Log4Qt::Level getLevel(int argc, char** argv) {
     return level;
 }
 
+QString getStartTraceFile(int argc, char** argv) {
+
+    for(int i = 0; i < argc; i++) {
+        if (isOption(argv[i], "trace-startup")) {
+            i++;
+            if (i < argc) {
+                return QString::fromLocal8Bit(argv[i]);
+            }
+            WZWARN("Expected file name after --trace-startup");
+            break;
+        }
+    }
+
+    return "";
+}
+
 int main(int argc, char** argv) {
 
-    initLog4Qt(getLevel(argc, argv));
+    QString traceFile = getStartTraceFile(argc, argv);
+    if (!traceFile.isEmpty()) {
+        TStartTrace::enable(traceFile);
+    }
+
+    {
+        WZSTARTTRACE("initLog4Qt");
+        initLog4Qt(getLevel(argc, argv));
+    }
 
     int exitCode;
     do {
@@ -148,9 +175,18 @@ int main(int argc, char** argv) {
             app.start();
             WZINFO(QString("Executing %1").arg(app.applicationName()));
             exitCode = app.exec();
+            WZDEBUG(QString("Icon cache hits %1 misses %2, image cache hits"
+                            " %3 misses %4")
+                    .arg(iconProvider.cacheHits())
+                    .arg(iconProvider.cacheMisses())
+                    .arg(Images::cacheHits())
+                    .arg(Images::cacheMisses()));
         }
     } while (exitCode == TApp::START_APP);
 
+    // Write the trace if nothing was played
+    TStartTrace::finish();
+
     WZTRACE("Returning exit code " + QString::number(exitCode));
     return exitCode;
 }
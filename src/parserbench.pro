@@ -0,0 +1,102 @@
+# Headless benchmark replaying recorded player output through the parsers.
+# Record transcripts by setting transcript_path in the [players] section of
+# the ini file, then run: parserbench [--mpv|--mplayer] [--repeat n] files
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET = parserbench
+
+CONFIG += qt warn_on console
+CONFIG -= app_bundle
+
+# Default to release build
+!CONFIG(debug, debug|release) {
+!CONFIG(release, debug|release) {
+    CONFIG += release
+}
+}
+
+# Intermediates
+MOC_DIR = .moc-bench
+OBJECTS_DIR = .obj-bench
+
+# Log4qt
+include(log4qt/log4qt.pri)
+
+QT += network
+QT += widgets gui
+
+DEFINES += WZPLAYER_VERSION_STR=\\\"$$system(git describe --dirty --always --tags)\\\"
+
+HEADERS += maps/chapters.h \
+    maps/map.h \
+    maps/titletracks.h \
+    maps/tracks.h \
+    player/info/playerinfo.h \
+    player/info/playerinfomplayer.h \
+    player/info/playerinfompv.h \
+    player/info/playerinfoprobe.h \
+    player/process/exitmsg.h \
+    player/process/mplayerprocess.h \
+    player/process/mpvfiltergraph.h \
+    player/process/mpvipc.h \
+    player/process/mpvprocess.h \
+    player/process/playerprocess.h \
+    player/process/process.h \
+    settings/aspectratio.h \
+    settings/assstyles.h \
+    settings/filters.h \
+    settings/lrulist.h \
+    settings/mediasettings.h \
+    settings/paths.h \
+    settings/preferences.h \
+    settings/recents.h \
+    settings/updatecheckerdata.h \
+    colorutils.h \
+    config.h \
+    discname.h \
+    mediadata.h \
+    name.h \
+    starttrace.h \
+    subtracks.h \
+    version.h \
+    wzdebug.h \
+    wzfiles.h \
+    wztime.h
+
+SOURCES += bench/parserbench.cpp \
+    maps/chapters.cpp \
+    maps/map.cpp \
+    maps/titletracks.cpp \
+    maps/tracks.cpp \
+    player/info/playerinfo.cpp \
+    player/info/playerinfomplayer.cpp \
+    player/info/playerinfompv.cpp \
+    player/info/playerinfoprobe.cpp \
+    player/process/exitmsg.cpp \
+    player/process/mplayerprocess.cpp \
+    player/process/mpvfiltergraph.cpp \
+    player/process/mpvipc.cpp \
+    player/process/mpvprocess.cpp \
+    player/process/playerprocess.cpp \
+    player/process/process.cpp \
+    settings/aspectratio.cpp \
+    settings/assstyles.cpp \
+    settings/filters.cpp \
+    settings/lrulist.cpp \
+    settings/mediasettings.cpp \
+    settings/paths.cpp \
+    settings/preferences.cpp \
+    settings/recents.cpp \
+    settings/updatecheckerdata.cpp \
+    colorutils.cpp \
+    config.cpp \
+    discname.cpp \
+    mediadata.cpp \
+    name.cpp \
+    starttrace.cpp \
+    subtracks.cpp \
+    version.cpp \
+    wzdebug.cpp \
+    wzfiles.cpp \
+    wztime.cpp
@@ -17,19 +17,12 @@
 */
 
 #include "player/info/playerinfo.h"
+#include "player/info/playerinfoprobe.h"
+#include "starttrace.h"
 
 #include <QFileInfo>
-#include <QDateTime>
-#include <QSettings>
-#include <QDir>
 
 #include "settings/preferences.h"
-#include "settings/paths.h"
-
-#include "player/info/playerinfomplayer.h"
-#include "player/info/playerinfompv.h"
-
-#define INFOREADER_SAVE_VERSION 3
 
 
 using namespace Settings;
@@ -49,137 +42,147 @@ TPlayerInfo* TPlayerInfo::obj() {
 
 TPlayerInfo::TPlayerInfo() :
     QObject(),
-    bin_size(0) {
+    bin_size(0),
+    running_probe(0) {
 }
 
 void TPlayerInfo::getInfo() {
+
+    // Changes to the binary are picked up by probe() and getInfo(path)
+    if (bin_date.isValid() && bin == Settings::pref->player_bin) {
+        return;
+    }
     getInfo(Settings::pref->player_bin);
 }
 
-QString TPlayerInfo::getGroup() {
-    QString group = bin;
-    return group
-            .replace("/", "_")
-            .replace("\\", "_")
-            .replace(".", "_")
-            .replace(":", "_");
+void TPlayerInfo::probe() {
+    probe(Settings::pref->player_bin);
+}
+
+bool TPlayerInfo::isLoaded(const QString& path, const QFileInfo& fi) const {
+    return path == bin
+            && fi.size() == bin_size
+            && fi.lastModified() == bin_date;
 }
 
-void TPlayerInfo::clearInfo() {
+void TPlayerInfo::clearInfo(const QString& path) {
 
+    bin = path;
+    bin_size = 0;
+    bin_date = QDateTime();
     vo_list.clear();
     ao_list.clear();
-    demuxerList().clear();
+    demuxer_list.clear();
     vc_list.clear();
     ac_list.clear();
     vf_list.clear();
     option_list.clear();
+    buildIndex();
+}
+
+void TPlayerInfo::buildIndex() {
+
+    option_set = option_list.toSet();
+    vf_set = vf_list.toSet();
+    vo_set.clear();
+    vo_set.reserve(vo_list.count());
+    for (int i = 0; i < vo_list.count(); i++) {
+        vo_set.insert(vo_list.at(i).name());
+    }
+}
+
+void TPlayerInfo::setInfo(const TPlayerInfoProbe* p) {
+
+    bin = p->bin;
+    bin_size = p->bin_size;
+    bin_date = p->bin_date;
+    vo_list = p->vo_list;
+    ao_list = p->ao_list;
+    demuxer_list = p->demuxer_list;
+    vc_list = p->vc_list;
+    ac_list = p->ac_list;
+    vf_list = p->vf_list;
+    option_list = p->option_list;
+    buildIndex();
 }
 
 void TPlayerInfo::getInfo(const QString& path) {
-    WZDEBUG("'" + path + "'");
 
     // Player not existing
     QFileInfo fi(path);
     if (!fi.exists()) {
-        bin = path;
-        bin_size = 0;
-        clearInfo();
+        clearInfo(path);
         WZWARN("Player '" + path + "' not found");
         return;
     }
 
     // Already loaded info
-    qint64 size = fi.size();
-    if (path == bin && size == bin_size) {
-        WZDEBUG("Reusing player info from memory");
+    if (isLoaded(path, fi)) {
         return;
     }
 
-    bin = path;
-    bin_size = size;
-
-    // Get info from ini file
-    QString dataPath = TPaths::dataPath();
-    if (!QDir().mkpath(dataPath)) {
-        WZERROR(QString("Failed to create data directory '%1'. %2")
-                .arg(dataPath).arg(strerror(errno)));
+    // Wait for the running probe
+    if (running_probe && running_probe->bin == path) {
+        WZDEBUG("Waiting for running probe of '" + path + "'");
+        WZSTARTTRACE("Waiting for player info");
+        running_probe->wait();
+        onProbeFinished();
+        if (isLoaded(path, fi)) {
+            return;
+        }
     }
 
-    QString inifile = TPaths::playerInfoFileName();
-    QSettings set(inifile, QSettings::IniFormat);
-    set.beginGroup(getGroup());
+    WZDEBUG("'" + path + "'");
+    TPlayerInfoProbe p(0, path);
+    p.probe();
+    setInfo(&p);
+}
+
+void TPlayerInfo::probe(const QString& path) {
 
-    if (set.value("size", -1).toInt() == bin_size) {
-        vo_list = convertListToInfoList(set.value("vo_list").toStringList());
-        ao_list = convertListToInfoList(set.value("ao_list").toStringList());
-        demuxer_list = convertListToInfoList(set.value("demuxer_list").toStringList());
-        vc_list = convertListToInfoList(set.value("vc_list").toStringList());
-        ac_list = convertListToInfoList(set.value("ac_list").toStringList());
-        vf_list = set.value("vf_list").toStringList();
-        option_list = set.value("option_list").toStringList();
+    QFileInfo fi(path);
+    if (!fi.exists()) {
+        clearInfo(path);
+        WZWARN("Player '" + path + "' not found");
+        emit infoReady();
+        return;
+    }
 
-        WZINFO("Loaded player info from '" + inifile + "'");
+    if (isLoaded(path, fi)) {
+        emit infoReady();
         return;
     }
 
-    // Get info from player
-    if (TPreferences::getPlayerID(bin) == TPreferences::ID_MPLAYER) {
-        TPlayerInfoMplayer ir(bin);
-        ir.getInfo();
-        vo_list = ir.voList();
-        ao_list = ir.aoList();
-        demuxer_list = ir.demuxerList();
-        vc_list = ir.vcList();
-        ac_list = ir.acList();
-        vf_list.clear();
-        option_list.clear();
-    } else {
-        TPlayerInfoMPV ir(bin);
-        ir.getInfo();
-        vo_list = ir.voList();
-        ao_list = ir.aoList();
-        demuxer_list = ir.demuxerList();
-        vc_list = ir.vcList();
-        ac_list = ir.acList();
-        vf_list = ir.vfList();
-        option_list = ir.optionList();
+    if (running_probe) {
+        if (running_probe->bin == path) {
+            return;
+        }
+        // Let the probe of the previous player finish on its own
+        running_probe->disconnect(this);
+        running_probe = 0;
     }
 
-    WZINFO("Saving player info to '" + inifile + "'");
-    set.setValue("size", bin_size);
-    set.setValue("date", fi.lastModified());
-    set.setValue("vo_list", convertInfoListToList(vo_list));
-    set.setValue("ao_list", convertInfoListToList(ao_list));
-    set.setValue("demuxer_list", convertInfoListToList(demuxer_list));
-    set.setValue("vc_list", convertInfoListToList(vc_list));
-    set.setValue("ac_list", convertInfoListToList(ac_list));
-    set.setValue("vf_list", vf_list);
-    set.setValue("option_list", option_list);
-    set.sync();
+    WZDEBUG("Starting probe of '" + path + "'");
+    running_probe = new TPlayerInfoProbe(this, path);
+    connect(running_probe, &TPlayerInfoProbe::finished,
+            this, &TPlayerInfo::onProbeFinished);
+    connect(running_probe, &TPlayerInfoProbe::finished,
+            running_probe, &TPlayerInfoProbe::deleteLater);
+    running_probe->start();
 }
 
-QStringList TPlayerInfo::convertInfoListToList(const TNameDescList& l) {
+void TPlayerInfo::onProbeFinished() {
 
-    QStringList r;
-    for (int i = 0; i < l.count(); i++) {
-        const TNameDesc& d = l.at(i);
-        r << d.name() + "|" + d.desc();
+    // Already handled by getInfo()
+    if (!running_probe || !running_probe->isFinished()) {
+        return;
     }
-    return r;
-}
-
-TNameDescList TPlayerInfo::convertListToInfoList(const QStringList& l) {
 
-    TNameDescList r;
-    QStringList s;
-    for (int n = 0; n < l.count(); n++) {
-        s = l.at(n).split("|");
-        if (s.count() >= 2) {
-            r.append(TNameDesc(s.at(0), s.at(1)));
-        }
-    }
-    return r;
+    WZDEBUG("Probe of '" + running_probe->bin + "' finished");
+    running_probe->disconnect(this);
+    setInfo(running_probe);
+    running_probe = 0;
+    emit infoReady();
 }
 
 } // namespace Info
@@ -24,6 +24,10 @@
 #include <QObject>
 #include <QList>
 #include <QStringList>
+#include <QDateTime>
+#include <QSet>
+
+class QFileInfo;
 
 
 namespace Player {
@@ -56,15 +60,25 @@ private:
 typedef QList<TNameDesc> TNameDescList;
 
 
-class TPlayerInfo : QObject {
+class TPlayerInfoProbe;
+
+class TPlayerInfo : public QObject {
     Q_OBJECT
     LOG4QT_DECLARE_QCLASS_LOGGER
 
 public:
     TPlayerInfo();
 
+    // Get the info of the player, waiting for it when it needs to be
+    // retrieved from the player. Without path only the first call checks the
+    // binary, later calls return the loaded info of pref->player_bin without
+    // touching the file system.
     void getInfo();
     void getInfo(const QString& path);
+    // Get the info of the player in a separate thread. Emits infoReady()
+    // when done.
+    void probe();
+    void probe(const QString& path);
 
     TNameDescList voList() { return vo_list; }
     TNameDescList aoList() { return ao_list; }
@@ -75,13 +89,24 @@ public:
     QStringList vfList() { return vf_list; }
     QStringList optionList() { return option_list; }
 
+    // Constant time lookups. Options include the leading "--".
+    bool hasOption(const QString& option) const {
+        return option_set.contains(option);
+    }
+    bool hasVideoFilter(const QString& vf) const { return vf_set.contains(vf); }
+    bool hasVO(const QString& vo) const { return vo_set.contains(vo); }
+
     //! Returns an TPlayerInfo object. If it didn't exist before, one
     //! is created.
     static TPlayerInfo* obj();
 
+signals:
+    void infoReady();
+
 protected:
     QString bin;
     qint64 bin_size;
+    QDateTime bin_date;
 
     TNameDescList vo_list;
     TNameDescList ao_list;
@@ -91,12 +116,21 @@ protected:
     QStringList vf_list;
     QStringList option_list;
 
+    QSet<QString> option_set;
+    QSet<QString> vf_set;
+    QSet<QString> vo_set;
+
 private:
     static TPlayerInfo* static_obj;
-    static QStringList convertInfoListToList(const TNameDescList& l);
-    static TNameDescList convertListToInfoList(const QStringList& l);
-    QString getGroup();
-    void clearInfo();
+    TPlayerInfoProbe* running_probe;
+
+    bool isLoaded(const QString& path, const QFileInfo& fi) const;
+    void setInfo(const TPlayerInfoProbe* p);
+    void clearInfo(const QString& path);
+    void buildIndex();
+
+private slots:
+    void onProbeFinished();
 };
 
 } // namespace Info
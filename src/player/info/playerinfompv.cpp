@@ -38,44 +38,64 @@ void TPlayerInfoMPV::getInfo() {
     ao_list.clear();
     vf_list.clear();
 
-    demuxer_list = getList(run("--demuxer help"));
-    vc_list = getList(run("--vd help"));
-    ac_list = getList(run("--ad help"));
-    vo_list = getList(run("--vo help"));
-    ao_list = getList(run("--ao help"));
+    QList<QList<QByteArray> > output = run(QStringList()
+                                           << "--demuxer help"
+                                           << "--vd help"
+                                           << "--ad help"
+                                           << "--vo help"
+                                           << "--ao help"
+                                           << "--vf help"
+                                           << "--list-options");
+
+    demuxer_list = getList(output.at(0));
+    vc_list = getList(output.at(1));
+    ac_list = getList(output.at(2));
+    vo_list = getList(output.at(3));
+    ao_list = getList(output.at(4));
 
     {
-        TNameDescList list = getList(run("--vf help"));
+        TNameDescList list = getList(output.at(5));
         for (int i = 0; i < list.count(); i++) {
             vf_list.append(list.at(i).name());
         }
     }
 
-    option_list = getOptionsList(run("--list-options"));
+    option_list = getOptionsList(output.at(6));
 }
 
-QList<QByteArray> TPlayerInfoMPV::run(QString options) {
-    WZDEBUG("bin '" + bin + "', options '" + options + "'");
-
-    QList<QByteArray> r;
-
-    QStringList args = options.split(" ");
-    QProcess proc;
-    proc.setProcessChannelMode(QProcess::MergedChannels);
-    proc.start(bin, args);
-    if (!proc.waitForStarted()) {
-        WZWARN("process can not start");
-        return r;
+// Run the player once for every entry in options, all at the same time.
+// Returns the output lines of every run.
+QList<QList<QByteArray> > TPlayerInfoMPV::run(const QStringList& options) {
+
+    QList<QProcess*> procs;
+    for (int i = 0; i < options.count(); i++) {
+        WZDEBUG("bin '" + bin + "', options '" + options.at(i) + "'");
+        QProcess* proc = new QProcess();
+        proc->setProcessChannelMode(QProcess::MergedChannels);
+        proc->start(bin, options.at(i).split(" "));
+        procs.append(proc);
     }
 
-    //Wait until finish
-    if (!proc.waitForFinished()) {
-        WZWARN("process did not finish. Killing it...");
-        proc.kill();
+    QList<QList<QByteArray> > r;
+    for (int i = 0; i < procs.count(); i++) {
+        QProcess* proc = procs.at(i);
+        QList<QByteArray> lines;
+        if (!proc->waitForStarted()) {
+            WZWARN("process can not start");
+        } else {
+            //Wait until finish
+            if (!proc->waitForFinished()) {
+                WZWARN("process did not finish. Killing it...");
+                proc->kill();
+                proc->waitForFinished();
+            }
+            QByteArray data = proc->readAll().replace("\r", "");
+            lines = data.split('\n');
+        }
+        r.append(lines);
     }
 
-    QByteArray data = proc.readAll().replace("\r", "");
-    r = data.split('\n');
+    qDeleteAll(procs);
     return r;
 }
 
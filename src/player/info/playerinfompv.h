@@ -50,7 +50,7 @@ public:
     QStringList optionList() { return option_list; }
 
 protected:
-    QList<QByteArray> run(QString options);
+    QList<QList<QByteArray> > run(const QStringList& options);
     TNameDescList getList(const QList<QByteArray> &);
     QStringList getOptionsList(const QList<QByteArray> &);
 
@@ -0,0 +1,162 @@
+#include "player/info/playerinfoprobe.h"
+#include "player/info/playerinfomplayer.h"
+#include "player/info/playerinfompv.h"
+#include "settings/preferences.h"
+#include "settings/paths.h"
+#include "starttrace.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+
+
+using namespace Settings;
+
+namespace Player {
+namespace Info {
+
+TPlayerInfoProbe::TPlayerInfoProbe(QObject* parent, const QString& path) :
+    QThread(parent),
+    bin(path),
+    bin_size(0) {
+}
+
+TPlayerInfoProbe::~TPlayerInfoProbe() {
+    wait();
+}
+
+void TPlayerInfoProbe::run() {
+    probe();
+}
+
+QString TPlayerInfoProbe::getGroup() const {
+
+    QString group = bin;
+    return group
+            .replace("/", "_")
+            .replace("\\", "_")
+            .replace(".", "_")
+            .replace(":", "_");
+}
+
+QByteArray TPlayerInfoProbe::hashFile(const QString& filename) {
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result().toHex();
+}
+
+void TPlayerInfoProbe::probe() {
+    WZDEBUG("'" + bin + "'");
+    WZSTARTTRACE("TPlayerInfoProbe::probe");
+
+    QFileInfo fi(bin);
+    bin_size = fi.size();
+    bin_date = fi.lastModified();
+    QByteArray hash = hashFile(bin);
+
+    QString dataPath = TPaths::dataPath();
+    if (!QDir().mkpath(dataPath)) {
+        WZERROR(QString("Failed to create data directory '%1'. %2")
+                .arg(dataPath).arg(strerror(errno)));
+    }
+
+    // Get info from ini file
+    QString inifile = TPaths::playerInfoFileName();
+    QSettings set(inifile, QSettings::IniFormat);
+    set.beginGroup(getGroup());
+    if (set.value("size", -1).toLongLong() == bin_size
+        && set.value("date").toDateTime() == bin_date
+        && set.value("hash").toByteArray() == hash) {
+        load(set);
+        WZINFO("Loaded player info from '" + inifile + "'");
+        return;
+    }
+
+    // Get info from player
+    WZSTARTTRACE("Running player to get info");
+    if (TPreferences::getPlayerID(bin) == TPreferences::ID_MPLAYER) {
+        TPlayerInfoMplayer ir(bin);
+        ir.getInfo();
+        vo_list = ir.voList();
+        ao_list = ir.aoList();
+        demuxer_list = ir.demuxerList();
+        vc_list = ir.vcList();
+        ac_list = ir.acList();
+        vf_list.clear();
+        option_list.clear();
+    } else {
+        TPlayerInfoMPV ir(bin);
+        ir.getInfo();
+        vo_list = ir.voList();
+        ao_list = ir.aoList();
+        demuxer_list = ir.demuxerList();
+        vc_list = ir.vcList();
+        ac_list = ir.acList();
+        vf_list = ir.vfList();
+        option_list = ir.optionList();
+    }
+
+    WZINFO("Saving player info to '" + inifile + "'");
+    save(set, hash);
+}
+
+void TPlayerInfoProbe::load(QSettings& set) {
+
+    vo_list = convertListToInfoList(set.value("vo_list").toStringList());
+    ao_list = convertListToInfoList(set.value("ao_list").toStringList());
+    demuxer_list = convertListToInfoList(set.value("demuxer_list").toStringList());
+    vc_list = convertListToInfoList(set.value("vc_list").toStringList());
+    ac_list = convertListToInfoList(set.value("ac_list").toStringList());
+    vf_list = set.value("vf_list").toStringList();
+    option_list = set.value("option_list").toStringList();
+}
+
+void TPlayerInfoProbe::save(QSettings& set, const QByteArray& hash) {
+
+    set.setValue("size", bin_size);
+    set.setValue("date", bin_date);
+    set.setValue("hash", hash);
+    set.setValue("vo_list", convertInfoListToList(vo_list));
+    set.setValue("ao_list", convertInfoListToList(ao_list));
+    set.setValue("demuxer_list", convertInfoListToList(demuxer_list));
+    set.setValue("vc_list", convertInfoListToList(vc_list));
+    set.setValue("ac_list", convertInfoListToList(ac_list));
+    set.setValue("vf_list", vf_list);
+    set.setValue("option_list", option_list);
+    set.sync();
+}
+
+QStringList TPlayerInfoProbe::convertInfoListToList(const TNameDescList& l) {
+
+    QStringList r;
+    for (int i = 0; i < l.count(); i++) {
+        const TNameDesc& d = l.at(i);
+        r << d.name() + "|" + d.desc();
+    }
+    return r;
+}
+
+TNameDescList TPlayerInfoProbe::convertListToInfoList(const QStringList& l) {
+
+    TNameDescList r;
+    QStringList s;
+    for (int n = 0; n < l.count(); n++) {
+        s = l.at(n).split("|");
+        if (s.count() >= 2) {
+            r.append(TNameDesc(s.at(0), s.at(1)));
+        }
+    }
+    return r;
+}
+
+} // namespace Info
+} // namespace Player
+
+#include "moc_playerinfoprobe.cpp"
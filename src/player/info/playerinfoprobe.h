@@ -0,0 +1,60 @@
+#ifndef PLAYER_INFO_PLAYERINFOPROBE_H
+#define PLAYER_INFO_PLAYERINFOPROBE_H
+
+#include "player/info/playerinfo.h"
+#include "wzdebug.h"
+
+#include <QThread>
+#include <QDateTime>
+
+class QSettings;
+
+
+namespace Player {
+namespace Info {
+
+// Gets the info of a player binary from the ini cache or, when the binary
+// changed, by running the player. probe() blocks, start() runs it in a
+// separate thread. The cache is keyed by the path, size, modification time
+// and a hash of the content of the binary.
+class TPlayerInfoProbe : public QThread {
+    Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
+
+public:
+    explicit TPlayerInfoProbe(QObject* parent, const QString& path);
+    virtual ~TPlayerInfoProbe() override;
+
+    void probe();
+
+    // Inputs
+    const QString bin;
+
+    // Outputs
+    qint64 bin_size;
+    QDateTime bin_date;
+
+    TNameDescList vo_list;
+    TNameDescList ao_list;
+    TNameDescList demuxer_list;
+    TNameDescList vc_list;
+    TNameDescList ac_list;
+    QStringList vf_list;
+    QStringList option_list;
+
+protected:
+    virtual void run() override;
+
+private:
+    QString getGroup() const;
+    static QByteArray hashFile(const QString& filename);
+    static QStringList convertInfoListToList(const TNameDescList& l);
+    static TNameDescList convertListToInfoList(const QStringList& l);
+    void load(QSettings& set);
+    void save(QSettings& set, const QByteArray& hash);
+};
+
+} // namespace Info
+} // namespace Player
+
+#endif // PLAYER_INFO_PLAYERINFOPROBE_H
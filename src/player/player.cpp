@@ -19,6 +19,7 @@
 #include "player/player.h"
 #include "player/process/playerprocess.h"
 #include "player/process/exitmsg.h"
+#include "player/thumbnailindex.h"
 
 #include "gui/playerwindow.h"
 #include "gui/videowindow.h"
@@ -41,6 +42,7 @@
 #include "extensions.h"
 #include "colorutils.h"
 #include "wzfiles.h"
+#include "starttrace.h"
 #include "wzdebug.h"
 
 #include <QDir>
@@ -51,6 +53,8 @@
 #include <QNetworkProxy>
 #include <QTimer>
 #include <QApplication>
+#include <QScreen>
+#include <QWindow>
 
 
 LOG4QT_DECLARE_STATIC_LOGGER(logger, Player::TPlayer)
@@ -59,6 +63,9 @@ Player::TPlayer* player = 0;
 
 namespace Player {
 
+// Interval to check for GUI visibility while position updates are pending
+const int HIDDEN_POSITION_INTERVAL = 500;
+
 int TPlayer::restartMS = 0;
 bool TPlayer::startPausedOnce = false;
 
@@ -71,7 +78,10 @@ TPlayer::TPlayer(QWidget* parent,
     mset(&mdat),
     playerWindow(pw),
     previewPlayer(aPreviewPlayer),
+    thumbnails(0),
     keepSize(false),
+    positionPending(false),
+    filter_restarts_avoided(0),
     _state(aPreviewPlayer
            ? STATE_LOADING
            : STATE_STOPPED) {
@@ -88,6 +98,11 @@ TPlayer::TPlayer(QWidget* parent,
     keepSizeTimer->setSingleShot(true);
     connect(keepSizeTimer, &QTimer::timeout, this, &TPlayer::clearKeepSize);
 
+    positionTimer = new QTimer(this);
+    positionTimer->setSingleShot(true);
+    connect(positionTimer, &QTimer::timeout,
+            this, &TPlayer::onPositionTimerTimeout);
+
     proc = Player::Process::TPlayerProcess::createPlayerProcess(
                 this, name + "_proc", &mdat);
 
@@ -165,6 +180,10 @@ TPlayer::TPlayer(QWidget* parent,
     if (previewPlayer) {
         connect(previewPlayer, &TPlayer::mediaEOF,
                 this, &TPlayer::onPreviewPlayerEOF);
+
+        thumbnails = new TThumbnailIndex(this);
+        connect(thumbnails, &TThumbnailIndex::ready,
+                this, &TPlayer::onThumbnailsReady);
     }
 }
 
@@ -239,12 +258,11 @@ void TPlayer::onProcessFinished(bool normal_exit, int exit_code, bool eof) {
     WZDEBUGOBJ("Entering the stopped state");
     setState(STATE_STOPPED);
 
-    if (previewPlayer) {
-        previewPlayer->stop();
-    }
+    stopPreviewPlayer(true);
 
     if (eof || exit_code == Player::Process::TExitMsg::EXIT_OUT_POINT_REACHED) {
         WZDEBUGOBJ("Emit mediaEOF()");
+        gapTimer.start();
         emit mediaEOF();
     } else if (!normal_exit) {
         WZDEBUGOBJ("Emit playerError()");
@@ -396,6 +414,23 @@ void TPlayer::openDisc(TDiscName disc, bool fast_open) {
     return;
 } // openDisc
 
+// Pass the media expected to play next to the player, so it can continue
+// with it without a gap after the end of the current media
+void TPlayer::setNextMedia(const QString& filename) {
+
+    // Only local files. Discs, streams and images need TPlayer::open().
+    QFileInfo fi(filename);
+    if (!proc->isReady()
+        || !fi.isFile()
+        || extensions.isImage(filename)
+        || TDiscName(filename).valid) {
+        return;
+    }
+
+    WZDOBJ << fi.absoluteFilePath();
+    proc->appendMedia(fi.absoluteFilePath());
+}
+
 // Generic open, autodetect type
 void TPlayer::open(QString filename, QString displayName) {
     WZDOBJ << filename;
@@ -630,9 +665,12 @@ void TPlayer::unloadAudioFile() {
     }
 }
 
-void TPlayer::stopPlayer() {
+// Stop the player. With keepIdle a player that can be reused for the next
+// media is kept running.
+void TPlayer::stopPlayer(bool keepIdle) {
 
-    if (proc->state() == QProcess::NotRunning) {
+    if (proc->state() == QProcess::NotRunning
+        || (keepIdle && proc->isIdle())) {
         return;
     }
 
@@ -643,14 +681,17 @@ void TPlayer::stopPlayer() {
     msg(tr("Stopping player..."), 0);
     QTime time;
     time.start();
-    proc->quit(0);
-
-    if (previewPlayer) {
-        previewPlayer->stop();
+    if (keepIdle) {
+        proc->stopPlaying();
+    } else {
+        proc->quit(0);
     }
 
+    stopPreviewPlayer(keepIdle);
+
     int lastSec = timeout;
-    while (proc->state() == QProcess::Running) {
+    while (proc->state() == QProcess::Running
+           && !(keepIdle && proc->isIdle())) {
         int elapsed = time.elapsed();
         if (elapsed >= timeout) {
             break;
@@ -663,7 +704,7 @@ void TPlayer::stopPlayer() {
         QApplication::processEvents(QEventLoop::ExcludeUserInputEvents, 100);
     };
 
-    if (proc->state() == QProcess::Running) {
+    if (proc->state() == QProcess::Running && !(keepIdle && proc->isIdle())) {
         QString s = tr("Player did not quit in %1 ms, killing it...")
                 .arg(timeout);
         WZWARNOBJ(s);
@@ -676,20 +717,34 @@ void TPlayer::stopPlayer() {
     WZDEBUGOBJ(QString("Player stopped in %1 ms").arg(time.elapsed()));
 }
 
+void TPlayer::stopPreviewPlayer(bool keepIdle) {
+
+    if (previewPlayer) {
+        previewPlayer->stopPlayer(keepIdle);
+        previewPlayer->setState(STATE_STOPPED);
+    }
+}
+
 void TPlayer::stop() {
 
+    gapTimer.invalidate();
     if (_state != STATE_STOPPED) {
         WZDEBUGOBJ("Current state " + stateToString());
-        stopPlayer();
+        stopPlayer(false);
         WZDEBUGOBJ("Entering the stopped state");
         setState(STATE_STOPPED);
+    } else if (proc->isIdle()) {
+        stopPlayer(false);
     }
 }
 
 void TPlayer::play() {
     WZDEBUGOBJ("Current state " + stateToString());
 
-    switch (proc->state()) {
+    // An idle player has nothing to resume
+    QProcess::ProcessState state = proc->isIdle() ? QProcess::NotRunning
+                                                  : proc->state();
+    switch (state) {
         case QProcess::Running:
             if (_state == STATE_PAUSED) {
                 proc->setPause(false);
@@ -799,12 +854,28 @@ void TPlayer::startPreviewPlayer() {
                 && !mdat.image
                 && mdat.hasVideo()) {
             if (Settings::pref->seek_preview) {
+                // Only use the preview player until the thumbnails are
+                // indexed
+                if (thumbnails->open(mdat.filename, mdat.duration_ms)) {
+                    WZDEBUGOBJ("Using indexed thumbnails for preview");
+                    previewPlayer->stop();
+                    return;
+                }
                 WZDEBUGOBJ("Starting preview player");
                 previewPlayer->open(mdat.filename);
                 return;
             }
             WZINFO("Preview disabled in settings");
         }
+        thumbnails->close();
+        previewPlayer->stop();
+    }
+}
+
+void TPlayer::onThumbnailsReady() {
+
+    if (thumbnails->fileName() == mdat.filename) {
+        WZDEBUGOBJ("Thumbnails indexed, stopping preview player");
         previewPlayer->stop();
     }
 }
@@ -840,6 +911,12 @@ void TPlayer::onPlayingStartedNewMedia() {
 void TPlayer::onPlayingStarted() {
     WZTOBJ;
 
+    if (previewPlayer && TStartTrace::isEnabled()) {
+        TStartTrace::end("Loading media");
+        TStartTrace::instant("playingStarted");
+        TStartTrace::finish();
+    }
+
     if (forced_titles.contains(mdat.filename)) {
         mdat.title = forced_titles[mdat.filename];
     }
@@ -854,6 +931,10 @@ void TPlayer::onPlayingStarted() {
     emit mediaStartedPlaying();
 
     WZDEBUGOBJ(QString("Loading done in %1 ms").arg(proc->startTime.elapsed()));
+    if (gapTimer.isValid()) {
+        WZDEBUGOBJ(QString("Gap between media %1 ms").arg(gapTimer.elapsed()));
+        gapTimer.invalidate();
+    }
 }
 
 void TPlayer::clearOSD() {
@@ -1145,6 +1226,7 @@ void TPlayer::setAudioOptions(const QString& fileName) {
 
 void TPlayer::startPlayer() {
     WZDOBJ;
+    WZSTARTTRACE("TPlayer::startPlayer");
 
     using namespace Settings;
 
@@ -1820,7 +1902,15 @@ end_video_filters:
 
     proc->setProcessEnvironment(env);
 
-    if (proc->startPlayer()) {
+    bool started;
+    {
+        WZSTARTTRACE("Player process spawn");
+        started = proc->startPlayer();
+    }
+    if (started) {
+        if (previewPlayer) {
+            TStartTrace::begin("Loading media");
+        }
         msg(tr("Loading %1...").arg(displayName), 0);
     } else {
         // Error reported by onProcessError()
@@ -1829,7 +1919,7 @@ end_video_filters:
     }
 } //startPlayer()
 
-void TPlayer::seekCmd(double value, int mode) {
+void TPlayer::seekCmd(double value, int mode, bool keyFrames) {
 
     // seek <value> [type]
     // Seek to some place in the movie.
@@ -1837,7 +1927,6 @@ void TPlayer::seekCmd(double value, int mode) {
     // mode 1 is a seek to <value> % in the movie.
     // mode 2 is a seek to an absolute position of <value> seconds.
 
-    bool keyFrames = Settings::pref->seek_keyframes;
     if (mode == 0) {
         QString s(tr("Seek %1%2 from %3")
                   .arg(keyFrames ? tr("key frame ") : "" )
@@ -1874,27 +1963,34 @@ void TPlayer::seekCmd(double value, int mode) {
     }
 
     if (proc->isReady()) {
-        proc->seek(value, mode, Settings::pref->seek_keyframes,
-                   _state == STATE_PAUSED);
+        proc->seek(value, mode, keyFrames, _state == STATE_PAUSED);
     } else {
         WZTRACEOBJ("Player not ready. Ignoring seek command");
     }
 }
 
 void TPlayer::seekRelative(double secs) {
-    seekCmd(secs, 0);
+    seekCmd(secs, 0, Settings::pref->seek_keyframes);
 }
 
 void TPlayer::seekPercentage(double perc) {
-    seekCmd(perc, 1);
+    seekCmd(perc, 1, Settings::pref->seek_keyframes);
 }
 
 void TPlayer::seekSecond(double sec) {
-    seekCmd(sec, 2);
+    seekCmd(sec, 2, Settings::pref->seek_keyframes);
 }
 
 void TPlayer::seekMS(int ms) {
-    seekCmd(double(ms) / 1000, 2);
+    seekCmd(double(ms) / 1000, 2, Settings::pref->seek_keyframes);
+}
+
+void TPlayer::seekKeyFrameMS(int ms) {
+    seekCmd(double(ms) / 1000, 2, true);
+}
+
+void TPlayer::seekKeyFramePercentage(double perc) {
+    seekCmd(perc, 1, true);
 }
 
 void TPlayer::forward1() {
@@ -2132,11 +2228,25 @@ void TPlayer::setStereoMode(int mode) {
 
 // Video filters
 
+// Returns true if the player can change filter without a restart
+bool TPlayer::changeVideoFilterLive(const QString& filter) {
+
+    if (!proc->canChangeVideoFilter(filter)) {
+        return false;
+    }
+    if (proc->isRunning()) {
+        filter_restarts_avoided++;
+        WZDEBUGOBJ(QString("Changing filter '%1' live, avoided %2 restarts")
+                   .arg(filter).arg(filter_restarts_avoided));
+    }
+    return true;
+}
+
 void TPlayer::setVideoFilter(const QString& filter,
                              bool enable,
                              const QVariant& option) {
 
-    if (Settings::pref->isMPV() && !mdat.video_hwdec) {
+    if (changeVideoFilterLive(filter)) {
         proc->setVideoFilter(filter, enable, option);
     } else {
         restartPlayer();
@@ -2221,11 +2331,10 @@ void TPlayer::setDenoiser(int id) {
     WZDEBUGOBJ(QString::number(id));
 
     if (id != mset.current_denoiser) {
-        if (Settings::pref->isMPlayer() || mdat.video_hwdec) {
+        if (!changeVideoFilterLive("hqdn3d")) {
             mset.current_denoiser = id;
             restartPlayer();
         } else {
-            // MPV
             QString dsoft = Settings::pref->filters.item("denoise_soft")
                             .options();
             QString dnormal =
@@ -2257,11 +2366,10 @@ void TPlayer::setSharpen(int id) {
     WZDEBUGOBJ(QString::number(id));
 
     if (id != mset.current_unsharp) {
-        if (Settings::pref->isMPlayer() || mdat.video_hwdec) {
+        if (!changeVideoFilterLive("sharpen")) {
             mset.current_unsharp = id;
             restartPlayer();
         } else {
-            // MPV
             // Remove previous filter
             switch (mset.current_unsharp) {
                 case 1: proc->setVideoFilter("blur", false); break;
@@ -2291,7 +2399,7 @@ void TPlayer::setStereo3D(const QString& in, const QString& out) {
     WZDEBUGOBJ("In '" + in + "' out: '" + out + "'");
 
     if ((mset.stereo3d_in != in) || (mset.stereo3d_out != out)) {
-        if (Settings::pref->isMPlayer() || mdat.video_hwdec) {
+        if (!changeVideoFilterLive("stereo3d")) {
             mset.stereo3d_in = in;
             mset.stereo3d_out = out;
             restartPlayer();
@@ -2925,16 +3033,68 @@ void TPlayer::handleOutPoint() {
     }
 }
 
+bool TPlayer::isGUIVisible() const {
+
+    QWidget* w = playerWindow->window();
+    return w->isVisible() && !w->isMinimized();
+}
+
+int TPlayer::positionUpdateInterval() const {
+
+    if (Settings::pref->position_update_interval > 0) {
+        return Settings::pref->position_update_interval;
+    }
+
+    // Once per display frame
+    QScreen* screen = 0;
+    QWindow* window = playerWindow->window()->windowHandle();
+    if (window) {
+        screen = window->screen();
+    }
+    if (!screen) {
+        screen = QGuiApplication::primaryScreen();
+    }
+    if (screen && screen->refreshRate() > 0) {
+        return qMax(1, qRound(1000 / screen->refreshRate()));
+    }
+    return 16;
+}
+
 void TPlayer::onReceivedPositionMS(int ms) {
 
     mset.current_ms = ms;
     handleOutPoint();
 
-    emit positionMSChanged(mset.current_ms);
+    // Pass at most one position per interval to the GUI and none while it is
+    // hidden or minimized
+    if (isPreviewPlayer()) {
+        emit positionMSChanged(mset.current_ms);
+    } else if (positionTimer->isActive()) {
+        positionPending = true;
+    } else if (isGUIVisible()) {
+        emit positionMSChanged(mset.current_ms);
+        positionTimer->start(positionUpdateInterval());
+    } else {
+        positionPending = true;
+        positionTimer->start(HIDDEN_POSITION_INTERVAL);
+    }
 
     handleChapters();
 }
 
+void TPlayer::onPositionTimerTimeout() {
+
+    if (positionPending) {
+        if (isGUIVisible()) {
+            positionPending = false;
+            emit positionMSChanged(mset.current_ms);
+            positionTimer->start(positionUpdateInterval());
+        } else {
+            positionTimer->start(HIDDEN_POSITION_INTERVAL);
+        }
+    }
+}
+
 // TMPVProcess sends it only once after initial start
 void TPlayer::onReceivedPause() {
     WZDEBUGOBJ("At " + TWZTime::formatMS(mset.current_ms));
@@ -2945,11 +3105,11 @@ void TPlayer::setDeinterlace(int ID) {
     WZDEBUGOBJ(QString::number(ID));
 
     if (ID != mset.current_deinterlacer) {
-        if (Settings::pref->isMPlayer()) {
+        if (!changeVideoFilterLive("yadif")) {
             mset.current_deinterlacer = ID;
             restartPlayer();
         } else {
-            // MPV: remove previous filter
+            // Remove previous filter
             switch (mset.current_deinterlacer) {
                 case Settings::TMediaSettings::L5:
                     proc->setVideoFilter("l5", false);
@@ -3238,11 +3398,10 @@ void TPlayer::setRotate(int r) {
     WZDEBUGOBJ(QString::number(r));
 
     if (mset.rotate != r) {
-        if (Settings::pref->isMPlayer()) {
+        if (!changeVideoFilterLive("rotate")) {
             mset.rotate = r;
             restartPlayer();
         } else {
-            // MPV
             // Remove previous filter
             if (mset.rotate) {
                 proc->setVideoFilter("rotate", false, mset.rotate);
@@ -20,6 +20,7 @@
 #define PLAYER_PLAYER_H
 
 #include <QProcess>
+#include <QElapsedTimer>
 
 #include "config.h"
 #include "mediadata.h"
@@ -39,6 +40,8 @@ namespace Process {
     class TPlayerProcess;
 }
 
+class TThumbnailIndex;
+
 
 class TPlayer : public QObject {
     Q_OBJECT
@@ -54,6 +57,8 @@ public:
     Gui::TPlayerWindow* playerWindow;
     TPlayer* previewPlayer;
     bool isPreviewPlayer() const { return previewPlayer == 0; }
+    // Seek preview thumbnails. Only created for the main player.
+    TThumbnailIndex* thumbnails;
 
     bool keepSize;
 
@@ -75,6 +80,9 @@ public:
     }
     bool isBuffering() const;
 
+    //! Number of filter changes applied without restarting the player
+    int filterRestartsAvoided() const { return filter_restarts_avoided; }
+
     bool hasVideo() const { return mdat.hasVideo(); }
     bool hasAudio() const { return mdat.hasAudio(); }
     bool hasExternalSubs() const;
@@ -92,6 +100,9 @@ public:
 
     // Stop player if running and save MediaInfo
     void close();
+    // Tell the player which file will be opened after the current one,
+    // so it can prefetch it and continue with it without a gap
+    void setNextMedia(const QString& filename);
 
     void restart(); // Restart current file
     void reload(); // Reopen current file
@@ -133,6 +144,9 @@ public slots:
     void seekPercentage(double perc);
     void seekSecond(double sec);
     void seekMS(int ms);
+    // Seek to the nearest key frame, used while dragging the time slider
+    void seekKeyFrameMS(int ms);
+    void seekKeyFramePercentage(double perc);
 
     void setSpeed(double value);
     void incSpeed10(); //!< Inc speed 10%
@@ -376,6 +390,13 @@ private:
     bool seeking;
 
     QTimer* keepSizeTimer;
+    // Throttle GUI position updates
+    QTimer* positionTimer;
+    bool positionPending;
+
+    int filter_restarts_avoided;
+    // Time between the end of the previous media and the start of the next
+    QElapsedTimer gapTimer;
 
     QString displayName;
     QString newDisplayName;
@@ -393,7 +414,8 @@ private:
 
     void setAudioOptions(const QString& fileName);
     void startPlayer();
-    void stopPlayer();
+    void stopPlayer(bool keepIdle = true);
+    void stopPreviewPlayer(bool keepIdle);
     void restartPlayer(TState state = STATE_RESTARTING);
 
     void setInPointMS(int ms);
@@ -407,6 +429,7 @@ private:
     void updatePreviewWindowSize();
 
     bool haveVideoFilters() const;
+    bool changeVideoFilterLive(const QString& filter);
     void setVideoFilter(const QString& filter, bool enable,
                         const QVariant& option);
 
@@ -421,10 +444,12 @@ private:
     void getPanFromPlayerWindow();
     void pan(int dx, int dy);
 
-    void seekCmd(double value, int mode);
+    void seekCmd(double value, int mode, bool keyFrames);
 
     void handleChapters();
     void handleOutPoint();
+    bool isGUIVisible() const;
+    int positionUpdateInterval() const;
     void updateLoop();
 
 private slots:
@@ -433,9 +458,11 @@ private slots:
     void onProcessError(QProcess::ProcessError error);
     void onProcessFinished(bool normal_exit, int exit_code, bool eof);
     void onPreviewPlayerEOF();
+    void onThumbnailsReady();
 
     void onReceivedMessage(const QString& s);
     void onReceivedPositionMS(int ms);
+    void onPositionTimerTimeout();
     void onReceivedPause();
     void onReceivedVideoOut();
     void onAudioTracksChanged();
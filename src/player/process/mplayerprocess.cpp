@@ -45,6 +45,23 @@ TMPlayerProcess::TMPlayerProcess(QObject* parent,
                                  const QString& name,
                                  TMediaData* mdata) :
     TPlayerProcess(parent, name, mdata),
+    start_frame_set(false),
+    start_frame(0),
+    frame_off_by_one(0),
+    sub_source(-1),
+    sub_file(false),
+    sub_vob(false),
+    sub_demux(false),
+    sub_file_id(-1),
+    last_duration_check_ms(0),
+    check_duration_wait_ms(1000),
+    video_tracks_changed(false),
+    get_selected_video_track(false),
+    audio_tracks_changed(false),
+    get_selected_audio_track(false),
+    subtitles_changed(false),
+    get_selected_subtitle(false),
+    clip_info_id(-1),
     mute_option_set(false),
     pause_option_set(false) {
 }
@@ -259,6 +276,13 @@ bool TMPlayerProcess::parseAnswer(const QString& name, const QString& value) {
         return true;
     }
 
+    // Answer to get_time_pos sent after a seek
+    if (name == "TIME_POSITION") {
+        seekDone();
+        notifyTime(value.toDouble());
+        return true;
+    }
+
     int i = value.toInt();
 
     // Video track
@@ -910,14 +934,11 @@ bool TMPlayerProcess::parseLine(QString& line) {
 
     // DVD/BLURAY titles
     static QRegExp rx_title_length("^ID_(DVD|BLURAY)_TITLE_(\\d+)_LENGTH=(.*)");
-    // DVD/BLURAY chapters
-    static QRegExp rx_title_chapters("^CHAPTERS: (.*)");
 
     // DVDNAV
     static QRegExp rx_dvdread_vts_count("^libdvdread: Found (\\d+) VTS");
     static QRegExp rx_dvdnav_switched_vts("^DVDNAV, switched to title: (\\d+)");
     static QRegExp rx_dvdnav_new_title("^DVDNAV, NEW TITLE (\\d+)");
-    static QRegExp rx_dvdnav_title_is_menu("^DVDNAV_TITLE_IS_MENU");
     static QRegExp rx_dvdnav_chapters("^TITLE (\\d+), CHAPTERS: (.*)");
 
     static QRegExp rx_kill_line(
@@ -951,7 +972,6 @@ bool TMPlayerProcess::parseLine(QString& line) {
     static QRegExp rx_error_open("^Failed to open (.*).");
     static QRegExp rx_error_http_403("Server returned 403:");
     static QRegExp rx_error_http_404("Server returned 404:");
-    static QRegExp rx_error_no_stream_found("^No stream found to handle url ");
 
     // Font cache
     static QRegExp rx_fontcache("^\\[ass\\] Updating font"
@@ -966,212 +986,249 @@ bool TMPlayerProcess::parseLine(QString& line) {
                               "|libdvdread: Get key )");
 
 
+    // The regular expressions below are only run on lines starting with the
+    // token they match, so a line is passed to at most a few of them. Checks
+    // for text not at the start of a line keep their original position.
+
     // Parse A: V: status line
-    if (rx_av.indexIn(line) >= 0) {
-        return parseStatusLine(rx_av.cap(1).toDouble(), line);
-    }
-    if (rx_a_or_v.indexIn(line) >= 0) {
-        return parseStatusLine(rx_a_or_v.cap(1).toDouble(), line);
+    if (line.length() > 1 && line.at(1) == ':') {
+        if (line.startsWith(QLatin1String("A: "))
+                && rx_av.indexIn(line) >= 0) {
+            return parseStatusLine(rx_av.cap(1).toDouble(), line);
+        }
+        if (rx_a_or_v.indexIn(line) >= 0) {
+            return parseStatusLine(rx_a_or_v.cap(1).toDouble(), line);
+        }
     }
 
     // Messages that kill the log
-    if (rx_kill_line.indexIn(line) >= 0)
+    if ((line.startsWith('r') || line.startsWith('[') || line.startsWith('P'))
+            && rx_kill_line.indexIn(line) >= 0) {
         return true;
+    }
 
     // First ask mom
     if (TPlayerProcess::parseLine(line))
         return true;
 
-    // Pause
-    if (line == "ID_PAUSED") {
-        return parsePause();
-    }
-
-    // Answers ANS_name=value
-    if (rx_answer.indexIn(line) >= 0) {
-        return parseAnswer(rx_answer.cap(1).toUpper(), rx_answer.cap(2));
-    }
-
-    // AO driver
-    if (rx_ao.indexIn(line) >= 0) {
-        md->ao = rx_ao.cap(1);
-        logger()->debug("parseLine: audio driver '%1'", md->ao);
-        return true;
-    }
-
-    // Video track ID, (NAME|LANG), value
-    if (rx_video_track.indexIn(line) >= 0) {
-        bool changed = md->videos.updateTrack(rx_video_track.cap(1).toInt(),
-                                              rx_video_track.cap(2),
-                                              rx_video_track.cap(3));
-        if (changed) video_tracks_changed = true;
-        return changed;
-    }
+    bool id_line = line.startsWith(QLatin1String("ID_"));
+    if (id_line) {
+        // Pause
+        if (line == "ID_PAUSED") {
+            return parsePause();
+        }
 
-    // Audio track ID, (NAME|LANG), value
-    if (rx_audio_track.indexIn(line) >= 0) {
-        bool changed = md->audios.updateTrack(rx_audio_track.cap(1).toInt(),
-                                              rx_audio_track.cap(2),
-                                              rx_audio_track.cap(3));
-        if (changed) audio_tracks_changed = true;
-        return changed;
-    }
+        // Video track ID, (NAME|LANG), value
+        if (line.startsWith(QLatin1String("ID_VID_"))
+                && rx_video_track.indexIn(line) >= 0) {
+            bool changed = md->videos.updateTrack(
+                               rx_video_track.cap(1).toInt(),
+                               rx_video_track.cap(2),
+                               rx_video_track.cap(3));
+            if (changed) video_tracks_changed = true;
+            return changed;
+        }
 
-    // Audio track alt ID, lang and format
-    if (rx_audio_track_alt.indexIn(line) >= 0) {
-        int id = rx_audio_track_alt.cap(3).toInt();
-        bool selected = md->audios.getSelectedID() == id;
-        bool changed = md->audios.updateTrack(id, rx_audio_track_alt.cap(2),
-                                              rx_audio_track_alt.cap(1),
-                                              selected);
-        if (changed) audio_tracks_changed = true;
-        return changed;
-    }
+        // Audio track ID, (NAME|LANG), value
+        if (line.startsWith(QLatin1String("ID_AID_"))
+                && rx_audio_track.indexIn(line) >= 0) {
+            bool changed = md->audios.updateTrack(
+                               rx_audio_track.cap(1).toInt(),
+                               rx_audio_track.cap(2),
+                               rx_audio_track.cap(3));
+            if (changed) audio_tracks_changed = true;
+            return changed;
+        }
 
-    // Subtitle ID
-    if (rx_sub_id.indexIn(line) >= 0) {
-        return parseSubID(rx_sub_id.cap(1), rx_sub_id.cap(2).toInt());
-    }
+        // Subtitle ID
+        if (rx_sub_id.indexIn(line) >= 0) {
+            return parseSubID(rx_sub_id.cap(1), rx_sub_id.cap(2).toInt());
+        }
 
-    // Subtitle track (SID|VSID), id, (LANG|NAME) and value
-    if (rx_sub_track.indexIn(line) >= 0) {
-        return parseSubTrack(rx_sub_track.cap(1), rx_sub_track.cap(2).toInt(),
-                             rx_sub_track.cap(3), rx_sub_track.cap(4));
-    }
+        // Subtitle track (SID|VSID), id, (LANG|NAME) and value
+        if (rx_sub_track.indexIn(line) >= 0) {
+            return parseSubTrack(rx_sub_track.cap(1),
+                                 rx_sub_track.cap(2).toInt(),
+                                 rx_sub_track.cap(3), rx_sub_track.cap(4));
+        }
 
-    // Video property ID_VIDEO_name and value
-    if (rx_video_prop.indexIn(line) >= 0) {
-        return parseVideoProperty(rx_video_prop.cap(1),rx_video_prop.cap(2));
-    }
+        // Video property ID_VIDEO_name and value
+        if (line.startsWith(QLatin1String("ID_VIDEO_"))
+                && rx_video_prop.indexIn(line) >= 0) {
+            return parseVideoProperty(rx_video_prop.cap(1),
+                                      rx_video_prop.cap(2));
+        }
 
-    // Audio property ID_AUDIO_name and value
-    if (rx_audio_prop.indexIn(line) >= 0) {
-        return parseAudioProperty(rx_audio_prop.cap(1), rx_audio_prop.cap(2));
-    }
+        // Audio property ID_AUDIO_name and value
+        if (line.startsWith(QLatin1String("ID_AUDIO_"))
+                && rx_audio_prop.indexIn(line) >= 0) {
+            return parseAudioProperty(rx_audio_prop.cap(1),
+                                      rx_audio_prop.cap(2));
+        }
 
-    // Chapters
-    if (rx_chapters.indexIn(line) >= 0) {
-        return parseChapter(rx_chapters.cap(1).toInt(),
-                            rx_chapters.cap(2),
-                            rx_chapters.cap(3).trimmed());
+        // Chapters
+        if (line.startsWith(QLatin1String("ID_CHAPTER_"))
+                && rx_chapters.indexIn(line) >= 0) {
+            return parseChapter(rx_chapters.cap(1).toInt(),
+                                rx_chapters.cap(2),
+                                rx_chapters.cap(3).trimmed());
+        }
+    } else if (line.startsWith(QLatin1String("ANS_"))) {
+        // Answers ANS_name=value
+        if (rx_answer.indexIn(line) >= 0) {
+            return parseAnswer(rx_answer.cap(1).toUpper(), rx_answer.cap(2));
+        }
+    } else if (line.startsWith(QLatin1String("AO: "))) {
+        // AO driver
+        if (rx_ao.indexIn(line) >= 0) {
+            md->ao = rx_ao.cap(1);
+            logger()->debug("parseLine: audio driver '%1'", md->ao);
+            return true;
+        }
+    } else if (line.startsWith(QLatin1String("audio stream: "))) {
+        // Audio track alt ID, lang and format
+        if (rx_audio_track_alt.indexIn(line) >= 0) {
+            int id = rx_audio_track_alt.cap(3).toInt();
+            bool selected = md->audios.getSelectedID() == id;
+            bool changed = md->audios.updateTrack(id,
+                                                  rx_audio_track_alt.cap(2),
+                                                  rx_audio_track_alt.cap(1),
+                                                  selected);
+            if (changed) audio_tracks_changed = true;
+            return changed;
+        }
     }
 
     // Matroshka chapters
-    if (rx_mkvchapters.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("[mkv] Chapter "))
+            && rx_mkvchapters.indexIn(line) >= 0) {
         int c = rx_mkvchapters.cap(1).toInt();
         WZDEBUGOBJ("Adding MKV chapter " + QString::number(c));
         md->chapters.addID(c);
         return true;
     }
 
-    // Audio/Video CD tracks
-    if (rx_cd_track.indexIn(line) >= 0) {
-        return parseCDTrack(rx_cd_track.cap(1),
-                            rx_cd_track.cap(2).toInt(),
-                            rx_cd_track.cap(3));
-    }
-
-    // DVD/Bluray title length
-    if (rx_title_length.indexIn(line) >= 0) {
-        return parseTitleLength(rx_title_length.cap(2).toInt(),
-                                rx_title_length.cap(3));
-    }
-
-    // DVD/Bluray chapters for title only stored in md->chapters
-    if (rx_title_chapters.indexIn(line) >= 0) {
-        return parseTitleChapters(md->chapters, rx_title_chapters.cap(1));
-    }
+    if (id_line) {
+        // Audio/Video CD tracks
+        if (rx_cd_track.indexIn(line) >= 0) {
+            return parseCDTrack(rx_cd_track.cap(1),
+                                rx_cd_track.cap(2).toInt(),
+                                rx_cd_track.cap(3));
+        }
 
-    // DVDNAV chapters for title stored in md->titles[title].chapters
-    if (rx_dvdnav_chapters.indexIn(line) >= 0) {
-        int title = rx_dvdnav_chapters.cap(1).toInt();
-        if (md->titles.contains(title))
-            return parseTitleChapters(md->titles[title].chapters,
-                                      rx_dvdnav_chapters.cap(2));
-        WZWARNOBJ("Unexpected title " + QString::number(title));
-        return false;
-    }
-    if (rx_dvdnav_switched_vts.indexIn(line) >= 0) {
-        return dvdnavVTSChanged(rx_dvdnav_switched_vts.cap(1).toInt());
-    }
-    if (rx_dvdnav_new_title.indexIn(line) >= 0) {
-        return dvdnavTitleChanged(rx_dvdnav_new_title.cap(1).toInt());
-    }
-    if (rx_dvdnav_title_is_menu.indexIn(line) >= 0) {
-        return dvdnavTitleIsMenu();
-    }
-    if (rx_dvdread_vts_count.indexIn(line) >= 0) {
-        int count = rx_dvdread_vts_count.cap(1).toInt();
-        md->titles.setVTSCount(count);
-        WZDEBUGOBJ("VTS count set to " + QString::number(count));
-        return true;
-    }
+        // DVD/Bluray title length
+        if (rx_title_length.indexIn(line) >= 0) {
+            return parseTitleLength(rx_title_length.cap(2).toInt(),
+                                    rx_title_length.cap(3));
+        }
 
-    // Clip info
-    if (rx_clip_info_name.indexIn(line) >= 0) {
-        return parseClipInfoName(rx_clip_info_name.cap(1).toInt(),
-                                 rx_clip_info_name.cap(2));
-    }
-    if (rx_clip_info_value.indexIn(line) >= 0) {
-        return parseClipInfoValue(rx_clip_info_value.cap(1).toInt(),
-                                  rx_clip_info_value.cap(2));
+        // Clip info
+        if (line.startsWith(QLatin1String("ID_CLIP_INFO_"))) {
+            if (rx_clip_info_name.indexIn(line) >= 0) {
+                return parseClipInfoName(rx_clip_info_name.cap(1).toInt(),
+                                         rx_clip_info_name.cap(2));
+            }
+            if (rx_clip_info_value.indexIn(line) >= 0) {
+                return parseClipInfoValue(rx_clip_info_value.cap(1).toInt(),
+                                          rx_clip_info_value.cap(2));
+            }
+        }
+    } else if (line.startsWith(QLatin1String("CHAPTERS: "))) {
+        // DVD/Bluray chapters for title only stored in md->chapters
+        return parseTitleChapters(md->chapters, line.mid(10));
+    } else if (line.startsWith(QLatin1String("TITLE "))) {
+        // DVDNAV chapters for title stored in md->titles[title].chapters
+        if (rx_dvdnav_chapters.indexIn(line) >= 0) {
+            int title = rx_dvdnav_chapters.cap(1).toInt();
+            if (md->titles.contains(title))
+                return parseTitleChapters(md->titles[title].chapters,
+                                          rx_dvdnav_chapters.cap(2));
+            WZWARNOBJ("Unexpected title " + QString::number(title));
+            return false;
+        }
+    } else if (line.startsWith(QLatin1String("DVDNAV"))) {
+        if (rx_dvdnav_switched_vts.indexIn(line) >= 0) {
+            return dvdnavVTSChanged(rx_dvdnav_switched_vts.cap(1).toInt());
+        }
+        if (rx_dvdnav_new_title.indexIn(line) >= 0) {
+            return dvdnavTitleChanged(rx_dvdnav_new_title.cap(1).toInt());
+        }
+        if (line.startsWith(QLatin1String("DVDNAV_TITLE_IS_MENU"))) {
+            return dvdnavTitleIsMenu();
+        }
+    } else if (line.startsWith(QLatin1String("libdvdread: Found "))) {
+        if (rx_dvdread_vts_count.indexIn(line) >= 0) {
+            int count = rx_dvdread_vts_count.cap(1).toInt();
+            md->titles.setVTSCount(count);
+            WZDEBUGOBJ("VTS count set to " + QString::number(count));
+            return true;
+        }
     }
 
     // Stream title
-    if (rx_stream_title_and_url.indexIn(line) >= 0) {
-        QString s = rx_stream_title_and_url.cap(1);
-        QString url = rx_stream_title_and_url.cap(2);
-        WZDEBUGOBJ("Stream title '" + s + "', stream_url '" + url + "'");
-        md->detected_type = TMediaData::TYPE_STREAM;
-        md->title = s;
-        md->stream_url = url;
-        emit receivedStreamTitle();
-        return true;
-    }
-
-    if (rx_stream_title.indexIn(line) >= 0) {
-        QString s = rx_stream_title.cap(1);
-        WZDEBUGOBJ("Stream title '" + s + "'");
-        md->detected_type = TMediaData::TYPE_STREAM;
-        md->title = s;
-        emit receivedStreamTitle();
-        return true;
-    }
+    if (line.contains(QLatin1String("StreamTitle='"))) {
+        if (rx_stream_title_and_url.indexIn(line) >= 0) {
+            QString s = rx_stream_title_and_url.cap(1);
+            QString url = rx_stream_title_and_url.cap(2);
+            WZDEBUGOBJ("Stream title '" + s + "', stream_url '" + url + "'");
+            md->detected_type = TMediaData::TYPE_STREAM;
+            md->title = s;
+            md->stream_url = url;
+            emit receivedStreamTitle();
+            return true;
+        }
 
-    // Screenshot
-    if (rx_screenshot.indexIn(line) >= 0) {
-        QString shot = rx_screenshot.cap(1);
-        WZDEBUGOBJ("Screenshot: '" + shot + "'");
-        emit receivedScreenshot(shot);
-        return true;
+        if (rx_stream_title.indexIn(line) >= 0) {
+            QString s = rx_stream_title.cap(1);
+            WZDEBUGOBJ("Stream title '" + s + "'");
+            md->detected_type = TMediaData::TYPE_STREAM;
+            md->title = s;
+            emit receivedStreamTitle();
+            return true;
+        }
     }
 
-    // Catch all property ID_name = value
-    if (rx_prop.indexIn(line) >= 0) {
-        return parseProperty(rx_prop.cap(1), rx_prop.cap(2));
+    if (id_line) {
+        // Catch all property ID_name = value
+        if (rx_prop.indexIn(line) >= 0) {
+            return parseProperty(rx_prop.cap(1), rx_prop.cap(2));
+        }
+    } else if (line.startsWith(QLatin1String("*** screenshot '"))) {
+        // Screenshot
+        if (rx_screenshot.indexIn(line) >= 0) {
+            QString shot = rx_screenshot.cap(1);
+            WZDEBUGOBJ("Screenshot: '" + shot + "'");
+            emit receivedScreenshot(shot);
+            return true;
+        }
+    } else if (line.startsWith(QLatin1String("Failed to open "))) {
+        // Errors
+        if (rx_error_open.indexIn(line) >= 0) {
+            if (exit_code_override == 0
+                    && rx_error_open.cap(1) == md->filename) {
+                WZDEBUGOBJ("Storing open failed");
+                exit_code_override = TExitMsg::ERR_OPEN;
+            } else {
+                WZDEBUGOBJ("Skipped open failed");
+            }
+            return true;
+        }
     }
 
-    // Errors
-    if (rx_error_open.indexIn(line) >= 0) {
-        if (exit_code_override == 0 && rx_error_open.cap(1) == md->filename) {
-            WZDEBUGOBJ("Storing open failed");
-            exit_code_override = TExitMsg::ERR_OPEN;
-        } else {
-            WZDEBUGOBJ("Skipped open failed");
+    if (line.contains(QLatin1String("Server returned 40"))) {
+        if (rx_error_http_403.indexIn(line) >= 0) {
+            WZDEBUGOBJ("Storing HTTP 403");
+            exit_code_override = TExitMsg::ERR_HTTP_403;
+            return true;
+        }
+        if (rx_error_http_404.indexIn(line) >= 0) {
+            WZDEBUGOBJ("Storing HTTP 404");
+            exit_code_override = TExitMsg::ERR_HTTP_404;
+            return true;
         }
-        return true;
-    }
-    if (rx_error_http_403.indexIn(line) >= 0) {
-        WZDEBUGOBJ("Storing HTTP 403");
-        exit_code_override = TExitMsg::ERR_HTTP_403;
-        return true;
-    }
-    if (rx_error_http_404.indexIn(line) >= 0) {
-        WZDEBUGOBJ("Storing HTTP 404");
-        exit_code_override = TExitMsg::ERR_HTTP_404;
-        return true;
     }
-    if (rx_error_no_stream_found.indexIn(line) >= 0) {
+
+    if (line.startsWith(QLatin1String("No stream found to handle url "))) {
         if (exit_code_override == 0) {
             WZDEBUGOBJ("Storing no stream");
             exit_code_override = TExitMsg::ERR_NO_STREAM_FOUND;
@@ -1182,7 +1239,8 @@ bool TMPlayerProcess::parseLine(QString& line) {
     }
 
     // Font cache
-    if (rx_fontcache.indexIn(line) >= 0) {
+    if (line.startsWith(QLatin1String("[ass] "))
+            && rx_fontcache.indexIn(line) >= 0) {
         WZDEBUGOBJ("emit receivedUpdatingFontCache()");
         emit receivedUpdatingFontCache();
         return true;
@@ -1360,7 +1418,8 @@ void TMPlayerProcess::addAudioFilter(const QString& filter_name, const QVariant&
 }
 
 void TMPlayerProcess::setVolume(int v) {
-    writeToPlayer("pausing_keep_force volume " + QString::number(v) + " 1");
+    queueToPlayer("volume",
+                  "pausing_keep_force volume " + QString::number(v) + " 1");
 }
 
 void TMPlayerProcess::setOSDLevel(int level) {
@@ -1429,6 +1488,10 @@ void TMPlayerProcess::seekPlayerTime(double secs,
     paused = currently_paused;
 
     writeToPlayer(s);
+    // MPlayer handles commands in order, so the answer to get_time_pos
+    // arrives when the seek finished. While paused it does not report the
+    // position in the status line.
+    writeToPlayer("pausing_keep_force get_time_pos", false);
 }
 
 void TMPlayerProcess::mute(bool b) {
@@ -1476,23 +1539,27 @@ void TMPlayerProcess::showTimeOnOSD() {
 }
 
 void TMPlayerProcess::setContrast(int value) {
-    writeToPlayer("pausing_keep contrast " + QString::number(value) + " 1");
+    queueToPlayer("contrast",
+                  "pausing_keep contrast " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setBrightness(int value) {
-    writeToPlayer("pausing_keep brightness " + QString::number(value) + " 1");
+    queueToPlayer("brightness",
+                  "pausing_keep brightness " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setHue(int value) {
-    writeToPlayer("pausing_keep hue " + QString::number(value) + " 1");
+    queueToPlayer("hue", "pausing_keep hue " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setSaturation(int value) {
-    writeToPlayer("pausing_keep saturation " + QString::number(value) + " 1");
+    queueToPlayer("saturation",
+                  "pausing_keep saturation " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setGamma(int value) {
-    writeToPlayer("pausing_keep gamma " + QString::number(value) + " 1");
+    queueToPlayer("gamma",
+                  "pausing_keep gamma " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setChapter(int ID) {
@@ -1524,11 +1591,11 @@ void TMPlayerProcess::setExternalSubtitleFile(const QString& filename) {
 }
 
 void TMPlayerProcess::setSubPos(int pos) {
-    writeToPlayer("sub_pos " + QString::number(pos) + " 1");
+    queueToPlayer("sub_pos", "sub_pos " + QString::number(pos) + " 1");
 }
 
 void TMPlayerProcess::setSubScale(double value) {
-    writeToPlayer("sub_scale " + QString::number(value) + " 1");
+    queueToPlayer("sub_scale", "sub_scale " + QString::number(value) + " 1");
 }
 
 void TMPlayerProcess::setSubStep(int value) {
@@ -1546,7 +1613,7 @@ void TMPlayerProcess::setSubForcedOnly(bool b) {
 }
 
 void TMPlayerProcess::setSpeed(double value) {
-    writeToPlayer("speed_set " + QString::number(value));
+    queueToPlayer("speed", "speed_set " + QString::number(value));
 }
 
 void TMPlayerProcess::enableKaraoke(bool b) {
@@ -1566,17 +1633,17 @@ void TMPlayerProcess::enableVolnorm(bool b, const QString& option) {
 }
 
 void TMPlayerProcess::setAudioEqualizer(const QString& values) {
-    writeToPlayer("af_cmdline equalizer " + values);
+    queueToPlayer("equalizer", "af_cmdline equalizer " + values);
 }
 
 void TMPlayerProcess::setAudioDelay(double delay) {
-    writeToPlayer("pausing_keep_force audio_delay "
-                 + QString::number(delay) +" 1");
+    queueToPlayer("audio_delay", "pausing_keep_force audio_delay "
+                  + QString::number(delay) +" 1");
 }
 
 void TMPlayerProcess::setSubDelay(double delay) {
-    writeToPlayer("pausing_keep_force sub_delay "
-                 + QString::number(delay) +" 1");
+    queueToPlayer("sub_delay", "pausing_keep_force sub_delay "
+                  + QString::number(delay) +" 1");
 }
 
 void TMPlayerProcess::setLoop(int v) {
@@ -1616,7 +1683,8 @@ void TMPlayerProcess::setTitle(int ID) {
 }
 
 void TMPlayerProcess::discSetMousePos(int x, int y) {
-    writeToPlayer(QString("set_mouse_pos %1 %2").arg(x).arg(y), false);
+    queueToPlayer("mouse_pos",
+                  QString("set_mouse_pos %1 %2").arg(x).arg(y), false);
 }
 
 void TMPlayerProcess::discButtonPressed(const QString& button_name) {
@@ -1624,7 +1692,7 @@ void TMPlayerProcess::discButtonPressed(const QString& button_name) {
 }
 
 void TMPlayerProcess::setAspect(double aspect) {
-    writeToPlayer("switch_ratio " + QString::number(aspect));
+    queueToPlayer("aspect", "switch_ratio " + QString::number(aspect));
 }
 
 void TMPlayerProcess::toggleDeinterlace() {
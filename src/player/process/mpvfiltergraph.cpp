@@ -0,0 +1,73 @@
+#include "player/process/mpvfiltergraph.h"
+#include "wzdebug.h"
+
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, Player::Process::TMPVFilterGraph)
+
+namespace Player {
+namespace Process {
+
+TMPVFilterGraph::TMPVFilterGraph() {
+}
+
+QString TMPVFilterGraph::label(const QString& filter_name) {
+
+    if (filter_name == "l5" || filter_name == "yadif"
+        || filter_name == "lb" || filter_name == "kerndeint") {
+        return "deinterlace";
+    }
+    if (filter_name == "hqdn3d") {
+        return "denoise";
+    }
+    if (filter_name == "blur" || filter_name == "sharpen") {
+        return "unsharp";
+    }
+    if (filter_name == "expand") {
+        return "letterbox";
+    }
+    if (filter_name == "phase" || filter_name == "deblock"
+        || filter_name == "dering" || filter_name == "gradfun"
+        || filter_name == "noise" || filter_name == "postprocessing"
+        || filter_name == "letterbox" || filter_name == "scale"
+        || filter_name == "rotate" || filter_name == "flip"
+        || filter_name == "mirror" || filter_name == "stereo3d"
+        || filter_name == "format") {
+        return filter_name;
+    }
+    return "";
+}
+
+QString TMPVFilterGraph::addOption(const QString& label,
+                                   const QString& filter) {
+
+    filters[label] = filter;
+    return "--vf-add=@" + label + ":" + filter;
+}
+
+QStringList TMPVFilterGraph::setFilter(const QString& label,
+                                       const QString& filter) {
+
+    QStringList commands;
+    if (filters.contains(label)) {
+        if (filters.value(label) == filter) {
+            WZDEBUG("Filter '" + filter + "' already set");
+            return commands;
+        }
+        commands << "vf del @" + label;
+    }
+    commands << "vf add \"@" + label + ":" + filter + "\"";
+    filters[label] = filter;
+    return commands;
+}
+
+QStringList TMPVFilterGraph::removeFilter(const QString& label) {
+
+    QStringList commands;
+    if (filters.remove(label)) {
+        commands << "vf del @" + label;
+    }
+    return commands;
+}
+
+} // namespace Process
+} // namespace Player
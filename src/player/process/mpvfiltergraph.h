@@ -0,0 +1,48 @@
+#ifndef PLAYER_PROCESS_MPVFILTERGRAPH_H
+#define PLAYER_PROCESS_MPVFILTERGRAPH_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+
+
+namespace Player {
+namespace Process {
+
+// Keeps track of the labelled filters in the video filter chain of MPV.
+// Filters that can be changed while playing are added with a label, like
+// --vf-add=@deinterlace:yadif, so they can later be removed or replaced with
+// vf del @label without knowing their exact options. Filters replacing each
+// other, like the deinterlacers, share a label.
+class TMPVFilterGraph {
+public:
+    TMPVFilterGraph();
+
+    void clear() { filters.clear(); }
+
+    // Label for filter_name as used by TPlayer, empty if the filter is not
+    // managed by the graph
+    static QString label(const QString& filter_name);
+
+    bool contains(const QString& label) const {
+        return filters.contains(label);
+    }
+
+    // Register filter added on the command line and return the option
+    QString addOption(const QString& label, const QString& filter);
+
+    // Commands to replace the filter in the slot for label with filter.
+    // Empty if filter is already in place.
+    QStringList setFilter(const QString& label, const QString& filter);
+    // Commands to remove the filter for label, empty if not present
+    QStringList removeFilter(const QString& label);
+
+private:
+    // Label -> filter
+    QMap<QString, QString> filters;
+};
+
+} // namespace Process
+} // namespace Player
+
+#endif // PLAYER_PROCESS_MPVFILTERGRAPH_H
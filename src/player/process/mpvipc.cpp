@@ -0,0 +1,251 @@
+#include "player/process/mpvipc.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+
+
+namespace Player {
+namespace Process {
+
+// Time between connection attempts while the player is starting
+const int CONNECT_INTERVAL = 20;
+const int CONNECT_TRIES = 250;
+
+// Log the latency every LOG_LATENCY_INTERVAL replies
+const int LOG_LATENCY_INTERVAL = 1000;
+
+TMPVIPC::TMPVIPC(QObject* parent, const QString& name) :
+    QObject(parent),
+    connect_tries(0),
+    next_request_id(1),
+    next_observer_id(1),
+    reply_count(0),
+    latency_total_ns(0),
+    latency_max_ns(0) {
+
+    setObjectName(name);
+
+    QString base = QString("wzplayer-%1-%2")
+                   .arg(QCoreApplication::applicationPid()).arg(name);
+#ifdef Q_OS_WIN
+    server_name = base;
+#else
+    server_name = QDir::temp().filePath(base + ".sock");
+#endif
+
+    socket = new QLocalSocket(this);
+    connect(socket, &QLocalSocket::connected,
+            this, &TMPVIPC::onConnected);
+    connect(socket, &QLocalSocket::readyRead,
+            this, &TMPVIPC::onReadyRead);
+
+    connectTimer = new QTimer(this);
+    connectTimer->setInterval(CONNECT_INTERVAL);
+    connect(connectTimer, &QTimer::timeout,
+            this, &TMPVIPC::tryConnect);
+}
+
+TMPVIPC::~TMPVIPC() {
+}
+
+QString TMPVIPC::serverOption() const {
+
+#ifdef Q_OS_WIN
+    return "--input-ipc-server=\\\\.\\pipe\\" + server_name;
+#else
+    return "--input-ipc-server=" + server_name;
+#endif
+}
+
+bool TMPVIPC::isConnected() const {
+    return socket->state() == QLocalSocket::ConnectedState;
+}
+
+void TMPVIPC::connectToPlayer() {
+
+    disconnectFromPlayer();
+    connect_tries = CONNECT_TRIES;
+    tryConnect();
+}
+
+void TMPVIPC::tryConnect() {
+
+    if (isConnected()) {
+        connectTimer->stop();
+        return;
+    }
+
+    connect_tries--;
+    if (connect_tries < 0) {
+        connectTimer->stop();
+        WZWARNOBJ("Failed to connect to '" + server_name + "'");
+        return;
+    }
+
+    socket->abort();
+    socket->connectToServer(server_name);
+    if (!connectTimer->isActive()) {
+        connectTimer->start();
+    }
+}
+
+void TMPVIPC::onConnected() {
+    WZDEBUGOBJ("Connected to '" + server_name + "'");
+
+    connectTimer->stop();
+    input.clear();
+    emit connected();
+}
+
+void TMPVIPC::disconnectFromPlayer() {
+
+    connectTimer->stop();
+    if (socket->state() != QLocalSocket::UnconnectedState) {
+        logLatency();
+        socket->abort();
+    }
+    pending_requests.clear();
+    input.clear();
+}
+
+double TMPVIPC::averageLatencyMS() const {
+
+    if (reply_count == 0) {
+        return 0;
+    }
+    return double(latency_total_ns) / reply_count / 1000000;
+}
+
+void TMPVIPC::logLatency() {
+
+    if (reply_count > 0) {
+        WZDOBJ << "Received" << reply_count << "replies."
+               << "Average latency" << averageLatencyMS() << "ms."
+               << "Max latency" << maxLatencyMS() << "ms";
+    }
+}
+
+void TMPVIPC::write(const QJsonObject& obj) {
+
+    if (isConnected()) {
+        socket->write(QJsonDocument(obj).toJson(QJsonDocument::Compact)
+                      + "\n");
+    } else {
+        WZWOBJ << "Not connected while trying to write" << obj;
+    }
+}
+
+void TMPVIPC::writeText(const QString& text) {
+
+    if (isConnected()) {
+        socket->write(text.toUtf8() + "\n");
+    } else {
+        WZWOBJ << "Not connected while trying to write" << text;
+    }
+}
+
+int TMPVIPC::sendCommand(const QVariantList& command) {
+
+    int id = next_request_id++;
+    QJsonObject obj;
+    obj["command"] = QJsonArray::fromVariantList(command);
+    obj["request_id"] = id;
+
+    QElapsedTimer& timer = pending_requests[id];
+    timer.start();
+    write(obj);
+    return id;
+}
+
+int TMPVIPC::sendCommand(const QVariantMap& command) {
+
+    int id = next_request_id++;
+    QJsonObject obj;
+    obj["command"] = QJsonObject::fromVariantMap(command);
+    obj["request_id"] = id;
+
+    QElapsedTimer& timer = pending_requests[id];
+    timer.start();
+    write(obj);
+    return id;
+}
+
+int TMPVIPC::getProperty(const QString& name) {
+    return sendCommand(QVariantList() << "get_property" << name);
+}
+
+void TMPVIPC::observeProperty(const QString& name) {
+    sendCommand(QVariantList() << "observe_property" << next_observer_id++
+                << name);
+}
+
+void TMPVIPC::onReadyRead() {
+
+    input.append(socket->readAll());
+
+    int from = 0;
+    int to;
+    while ((to = input.indexOf('\n', from)) >= 0) {
+        if (to > from) {
+            parseMessage(input.mid(from, to - from));
+        }
+        from = to + 1;
+    }
+    input.remove(0, from);
+}
+
+void TMPVIPC::parseReply(int requestID, const QJsonObject& obj) {
+
+    if (pending_requests.contains(requestID)) {
+        qint64 ns = pending_requests.take(requestID).nsecsElapsed();
+        latency_total_ns += ns;
+        if (ns > latency_max_ns) {
+            latency_max_ns = ns;
+        }
+        reply_count++;
+        if (reply_count % LOG_LATENCY_INTERVAL == 0) {
+            logLatency();
+        }
+    }
+
+    bool success = obj.value("error").toString() == "success";
+    if (!success) {
+        WZDOBJ << "Request" << requestID << "failed with"
+               << obj.value("error").toString();
+    }
+    emit replyReceived(requestID, success, obj.value("data").toVariant());
+}
+
+void TMPVIPC::parseMessage(const QByteArray& msg) {
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(msg, &error);
+    if (!doc.isObject()) {
+        WZWOBJ << "Failed to parse" << msg << error.errorString();
+        return;
+    }
+
+    QJsonObject obj = doc.object();
+    if (obj.contains("request_id")) {
+        parseReply(obj.value("request_id").toInt(), obj);
+        return;
+    }
+
+    QString event = obj.value("event").toString();
+    if (event == "property-change") {
+        emit propertyChanged(obj.value("name").toString(),
+                             obj.value("data").toVariant());
+    } else if (!event.isEmpty()) {
+        WZTOBJ << "Event" << event;
+        emit eventReceived(event, obj);
+    }
+}
+
+} // namespace Process
+} // namespace Player
+
+#include "moc_mpvipc.cpp"
@@ -0,0 +1,89 @@
+#ifndef PLAYER_PROCESS_MPVIPC_H
+#define PLAYER_PROCESS_MPVIPC_H
+
+#include "wzdebug.h"
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QVariant>
+#include <QJsonObject>
+
+class QLocalSocket;
+class QTimer;
+
+
+namespace Player {
+namespace Process {
+
+// Client for the JSON IPC server of MPV (--input-ipc-server).
+// Property changes requested with observeProperty() arrive as
+// propertyChanged() signals. Requests get a request_id and their reply
+// arrives as replyReceived() with the same ID. The time between sending a
+// request and receiving its reply is kept to make the latency of commands
+// measurable.
+class TMPVIPC : public QObject {
+    Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
+public:
+    TMPVIPC(QObject* parent, const QString& name);
+    virtual ~TMPVIPC() override;
+
+    // Option to pass to MPV to start the IPC server
+    QString serverOption() const;
+    bool isConnected() const;
+
+    // Start trying to connect to the server of a starting player
+    void connectToPlayer();
+    void disconnectFromPlayer();
+
+    // Returns the request ID
+    int sendCommand(const QVariantList& command);
+    // Command with named arguments, e.g. {"name": "loadfile", "url": ...}
+    int sendCommand(const QVariantMap& command);
+    int getProperty(const QString& name);
+    void observeProperty(const QString& name);
+    // Write a command in input.conf format. Does not generate a reply.
+    void writeText(const QString& text);
+
+    int replies() const { return reply_count; }
+    double averageLatencyMS() const;
+    double maxLatencyMS() const { return double(latency_max_ns) / 1000000; }
+
+signals:
+    void connected();
+    void propertyChanged(const QString& name, const QVariant& data);
+    void replyReceived(int requestID, bool success, const QVariant& data);
+    void eventReceived(const QString& event, const QJsonObject& obj);
+
+private:
+    QLocalSocket* socket;
+    QTimer* connectTimer;
+    QString server_name;
+    int connect_tries;
+
+    int next_request_id;
+    int next_observer_id;
+    QHash<int, QElapsedTimer> pending_requests;
+
+    int reply_count;
+    qint64 latency_total_ns;
+    qint64 latency_max_ns;
+
+    QByteArray input;
+
+    void write(const QJsonObject& obj);
+    void parseMessage(const QByteArray& msg);
+    void parseReply(int requestID, const QJsonObject& obj);
+    void logLatency();
+
+private slots:
+    void tryConnect();
+    void onConnected();
+    void onReadyRead();
+};
+
+} // namespace Process
+} // namespace Player
+
+#endif // PLAYER_PROCESS_MPVIPC_H
@@ -18,6 +18,7 @@
 
 #include "player/process/mpvprocess.h"
 #include "player/process/playerprocess.h"
+#include "player/process/mpvipc.h"
 #include "player/process/exitmsg.h"
 #include "player/info/playerinfo.h"
 #include "settings/preferences.h"
@@ -30,6 +31,7 @@
 
 #include <QDir>
 #include <QRegExp>
+#include <QTimer>
 
 
 LOG4QT_DECLARE_STATIC_LOGGER(logger, Player::Process::TMPVProcess)
@@ -39,19 +41,599 @@ namespace Process {
 
 const int BITRATE_START_INTERVAL = 11000;
 
+// Time to wait for TPlayer to open media continued without gap before
+// stopping it and the max number of output lines to hold for it
+const int HOLD_TIMEOUT = 5000;
+const int MAX_HELD_LINES = 1000;
+
 TMPVProcess::TMPVProcess(QObject* parent,
                          const QString& name,
                          TMediaData* mdata) :
-    TPlayerProcess(parent, name, mdata) {
-}
-
-bool TMPVProcess::startPlayer() {
+    TPlayerProcess(parent, name, mdata),
+    use_ipc(false),
+    received_playing_msg(false),
+    ipc_buffering(false),
+    ipc_idle(false),
+    titles_request_id(-1),
+    chapters_request_id(-1),
+    keep_running(false),
+    player_idle(false),
+    stop_requested(false),
+    discard_finished(false),
+    reused_count(0),
+    continuing(false),
+    holding(false),
+    continued_early(false),
+    media_arg(-1),
+    received_buffering(false),
+    received_title_not_found(false),
+    capturing(false),
+    quit_at_end_of_title(false),
+    quit_at_end_of_title_ms(0) {
+
+    holdTimer = new QTimer(this);
+    holdTimer->setSingleShot(true);
+    holdTimer->setInterval(HOLD_TIMEOUT);
+    connect(holdTimer, &QTimer::timeout,
+            this, &TMPVProcess::onHoldTimeout);
+
+    ipc = new TMPVIPC(this, name);
+    connect(ipc, &TMPVIPC::connected,
+            this, &TMPVProcess::onIPCConnected);
+    connect(ipc, &TMPVIPC::propertyChanged,
+            this, &TMPVProcess::onIPCPropertyChanged);
+    connect(ipc, &TMPVIPC::replyReceived,
+            this, &TMPVProcess::onIPCReplyReceived);
+    connect(ipc, &TMPVIPC::eventReceived,
+            this, &TMPVProcess::onIPCEventReceived);
+}
+
+void TMPVProcess::resetPlayingState() {
+
+    TPlayerProcess::resetPlayingState();
 
     received_buffering = false;
     received_title_not_found = false;
     quit_at_end_of_title = false;
 
-    return TPlayerProcess::startPlayer();
+    received_playing_msg = false;
+    ipc_buffering = false;
+    ipc_idle = false;
+    titles_request_id = -1;
+    chapters_request_id = -1;
+    player_idle = false;
+}
+
+bool TMPVProcess::startPlayer() {
+
+    if (keep_running) {
+        return startKeptPlayer();
+    }
+
+    if (TPlayerProcess::startPlayer()) {
+        if (use_ipc) {
+            ipc->connectToPlayer();
+        }
+        return true;
+    }
+    return false;
+}
+
+// Split args into the options the player process needs to be started with
+// and the options that can be passed per file to loadfile. Returns false if
+// the arguments cannot be split.
+bool TMPVProcess::splitArguments(QStringList& process_args,
+                                 QStringList& options) const {
+
+    // Options that cannot be set per file
+    static QStringList global_options = QStringList()
+        << "config" << "quiet" << "terminal" << "idle" << "wid" << "vo"
+        << "ao" << "reset-on-next-file" << "cursor-autohide" << "log-file"
+        << "profile" << "include" << "use-filedir-conf";
+    static QStringList global_prefixes = QStringList()
+        << "input-" << "msg-" << "term-" << "gpu-" << "opengl-" << "vulkan-"
+        << "d3d11-" << "x11-" << "wayland-";
+
+    for (int i = 0; i < args.count(); i++) {
+        if (i == media_arg) {
+            continue;
+        }
+
+        QString arg = args.at(i);
+        if (!arg.startsWith("--")) {
+            if (arg.startsWith("-")) {
+                // Short options like -v
+                process_args << arg;
+                continue;
+            }
+            WZDOBJ << "Cannot split unexpected argument" << arg;
+            return false;
+        }
+
+        QString name = arg.mid(2);
+        QString value;
+        bool separate = false;
+        int eq = name.indexOf('=');
+        if (eq >= 0) {
+            value = name.mid(eq + 1);
+            name = name.left(eq);
+        } else if (i + 1 < args.count() && i + 1 != media_arg
+                   && !args.at(i + 1).startsWith("-")) {
+            // Value passed as separate argument
+            value = args.at(i + 1);
+            separate = true;
+        } else if (name.startsWith("no-")) {
+            name = name.mid(3);
+            value = "no";
+        } else {
+            value = "yes";
+        }
+
+        bool global = global_options.contains(name);
+        for (int p = 0; !global && p < global_prefixes.count(); p++) {
+            global = name.startsWith(global_prefixes.at(p));
+        }
+
+        if (global) {
+            process_args << arg;
+            if (separate) {
+                process_args << value;
+            }
+        } else {
+            // Escape the value with its length, so it can contain commas
+            options << name + "=%" + QString::number(value.toUtf8().size())
+                       + "%" + value;
+        }
+        if (separate) {
+            i++;
+        }
+    }
+
+    return true;
+}
+
+// Start playing the media set by setMedia() with a player kept running.
+// Restarts the player if it is not idle or if it needs other options.
+bool TMPVProcess::startKeptPlayer() {
+
+    QStringList process_args;
+    QStringList options;
+    if (!splitArguments(process_args, options)) {
+        // Start a player that will not be reused
+        quitIdlePlayer();
+        running_args.clear();
+        load_url.clear();
+        file_options.clear();
+        if (TPlayerProcess::startPlayer()) {
+            ipc->connectToPlayer();
+            return true;
+        }
+        return false;
+    }
+
+    file_options = options;
+    if (isIdle() && ipc->isConnected()
+        && program == running_program && process_args == running_args) {
+        reused_count++;
+        if ((continuing || holding) && media_url == continuing_url
+            && options == continuing_options) {
+            continueHeldMedia();
+            return true;
+        }
+
+        WZDOBJ << "Reusing running player for the" << reused_count
+               << "time";
+        dropHeldMedia();
+        resetPlayingState();
+        loadFile(media_url, options, "replace");
+        return true;
+    }
+
+    quitIdlePlayer();
+    running_program = program;
+    running_args = process_args;
+    load_url = media_url;
+    load_options = options;
+    args = process_args;
+    if (TPlayerProcess::startPlayer()) {
+        ipc->connectToPlayer();
+        return true;
+    }
+    return false;
+}
+
+void TMPVProcess::loadFile(const QString& url, const QStringList& options,
+                           const QString& flags) {
+    WZDOBJ << flags << url << options;
+
+    QVariantMap cmd;
+    cmd["name"] = "loadfile";
+    cmd["url"] = url;
+    cmd["flags"] = flags;
+    if (!options.isEmpty()) {
+        cmd["options"] = options.join(",");
+    }
+    ipc->sendCommand(cmd);
+}
+
+// Append media to the playlist of MPV, so it can prefetch it and continue
+// with it without a gap
+void TMPVProcess::appendMedia(const QString& media) {
+
+    if (!keep_running || !ipc->isConnected() || player_idle || continuing
+        || holding) {
+        return;
+    }
+
+    // Use the options of the current media without its start position
+    // and pause. startKeptPlayer() only continues with the appended media
+    // when the options TPlayer gives for it match.
+    next_options.clear();
+    for (int i = 0; i < file_options.count(); i++) {
+        const QString& o = file_options.at(i);
+        if (!o.startsWith("start=") && !o.startsWith("pause=")) {
+            next_options << o;
+        }
+    }
+
+    // Replace a previously appended media
+    ipc->sendCommand(QVariantList() << "playlist-clear");
+    loadFile(media, next_options, "append");
+    next_url = media;
+}
+
+// Take the media MPV continued with after the end of the previous media
+// as the media opened by TPlayer
+void TMPVProcess::continueHeldMedia() {
+    WZDOBJ << "Continuing without gap with" << continuing_url;
+
+    QStringList lines = held_lines;
+    QList<QPair<QString, QVariant> > properties = held_properties;
+    holdTimer->stop();
+    // Not switched yet, the output until the switch is stale
+    continued_early = continuing;
+    holding = false;
+    held_lines.clear();
+    held_properties.clear();
+    continuing_url.clear();
+
+    resetPlayingState();
+    for (int i = 0; i < properties.count(); i++) {
+        onIPCPropertyChanged(properties.at(i).first, properties.at(i).second);
+    }
+    for (int i = 0; i < lines.count(); i++) {
+        QString line = lines.at(i);
+        parseLine(line);
+    }
+}
+
+void TMPVProcess::dropHeldMedia() {
+
+    if (continuing || holding || continued_early) {
+        WZDOBJ << "Dropping" << continuing_url << "with" << held_lines.count()
+               << "lines of output";
+        holdTimer->stop();
+        continuing = false;
+        holding = false;
+        continued_early = false;
+        held_lines.clear();
+        held_properties.clear();
+        continuing_url.clear();
+    }
+}
+
+// MPV switched to the next entry of its playlist
+void TMPVProcess::onPlaylistPosChanged() {
+
+    if (continuing) {
+        continuing = false;
+        if (continued_early) {
+            WZDOBJ << "Switched to media already opened by TPlayer";
+            continued_early = false;
+        } else {
+            WZDOBJ << "Switched to" << continuing_url << "holding its output";
+            holding = true;
+        }
+    }
+}
+
+// TPlayer did not open the media MPV continued with
+void TMPVProcess::onHoldTimeout() {
+
+    if (continuing || holding) {
+        dropHeldMedia();
+        if (ipc->isConnected()) {
+            stop_requested = true;
+            ipc->writeText("stop");
+        }
+    }
+}
+
+void TMPVProcess::quitIdlePlayer() {
+
+    if (!isRunning()) {
+        return;
+    }
+
+    WZDEBUGOBJ("Quitting running player to restart it with other options");
+    // Do not report the exit of the old process as end of the new media
+    discard_finished = true;
+    writeCommand("quit");
+    if (!waitForFinished(Settings::pref->time_to_kill_player)) {
+        WZWARNOBJ("Player did not quit, killing it");
+        kill();
+        waitForFinished();
+    }
+}
+
+void TMPVProcess::stopPlaying() {
+
+    if (keep_running && ipc->isConnected()) {
+        if (!player_idle) {
+            WZDEBUGOBJ("Stopping playback, keeping player running");
+            stop_requested = true;
+            next_url.clear();
+            dropHeldMedia();
+            ipc->writeText("stop");
+        }
+    } else {
+        quit(0);
+    }
+}
+
+bool TMPVProcess::isIdle() const {
+    return keep_running && (player_idle || continuing || holding)
+            && isRunning();
+}
+
+void TMPVProcess::onIPCEventReceived(const QString& event,
+                                     const QJsonObject& obj) {
+
+    // Playback restarted at the new position
+    if (event == "playback-restart") {
+        if (!holding && !continued_early) {
+            seekDone();
+        }
+        return;
+    }
+
+    if (event != "end-file" || !keep_running) {
+        return;
+    }
+
+    // The player stays running with --idle, so report the end of the media
+    // like the process finished
+    QString reason = obj.value("reason").toString();
+    WZDOBJ << "End of file with reason" << reason;
+    if (reason == "redirect" || reason == "quit") {
+        return;
+    }
+    if (reason == "stop") {
+        // Media replaced by loadfile also ends with stop
+        if (stop_requested) {
+            stop_requested = false;
+            player_idle = true;
+        }
+        return;
+    }
+
+    // Media held, but not taken by TPlayer before it ended
+    dropHeldMedia();
+
+    if (reason == "eof") {
+        setEOF();
+        if (next_url.isEmpty()) {
+            player_idle = true;
+        } else {
+            // MPV continues with the appended media. Hold its output from
+            // the switch to it until TPlayer opens it.
+            continuing = true;
+            continuing_url = next_url;
+            continuing_options = next_options;
+            next_url.clear();
+            holdTimer->start();
+        }
+        emit processFinished(true, 0, true);
+    } else if (reason == "error") {
+        if (!next_url.isEmpty()) {
+            // Do not continue with the appended media after an error
+            next_url.clear();
+            stop_requested = true;
+            ipc->writeText("stop");
+        }
+        player_idle = true;
+        int code = exit_code_override;
+        if (code == 0) {
+            code = TExitMsg::ERR_OPEN;
+        }
+        emit processFinished(false, code, false);
+    }
+}
+
+void TMPVProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+
+    ipc->disconnectFromPlayer();
+    player_idle = false;
+    stop_requested = false;
+    next_url.clear();
+    dropHeldMedia();
+    if (discard_finished) {
+        discard_finished = false;
+        WZDOBJ << "Old player finished with exit code" << exitCode;
+        return;
+    }
+    TPlayerProcess::onFinished(exitCode, exitStatus);
+}
+
+void TMPVProcess::writeCommand(const QString& text) {
+
+    if (use_ipc && ipc->isConnected()) {
+        ipc->writeText(text);
+    } else {
+        TPlayerProcess::writeCommand(text);
+    }
+}
+
+void TMPVProcess::onIPCConnected() {
+
+    ipc->observeProperty("time-pos");
+    ipc->observeProperty("duration");
+    ipc->observeProperty("pause");
+    ipc->observeProperty("paused-for-cache");
+    ipc->observeProperty("core-idle");
+    ipc->observeProperty("aid");
+    ipc->observeProperty("vid");
+    ipc->observeProperty("playlist-pos");
+
+    if (!load_url.isEmpty()) {
+        loadFile(load_url, load_options, "replace");
+        load_url.clear();
+        load_options.clear();
+    }
+}
+
+void TMPVProcess::onIPCPropertyChanged(const QString& name,
+                                       const QVariant& data) {
+
+    if (quit_send) {
+        return;
+    }
+    if (name == "playlist-pos") {
+        onPlaylistPosChanged();
+        return;
+    }
+    if (holding) {
+        held_properties.append(qMakePair(name, data));
+        return;
+    }
+    if (continued_early) {
+        return;
+    }
+
+    if (name == "time-pos") {
+        if (data.isValid()) {
+            notifyTime(data.toDouble());
+        }
+    } else if (name == "duration") {
+        if (data.isValid()) {
+            notifyDuration(data.toDouble());
+        }
+        return;
+    } else if (name == "pause") {
+        paused = data.toBool();
+    } else if (name == "paused-for-cache") {
+        ipc_buffering = data.toBool();
+    } else if (name == "core-idle") {
+        ipc_idle = data.toBool();
+    } else if (name == "aid" || name == "vid") {
+        // Data is false when no track selected
+        bool ok;
+        int id = data.toInt(&ok);
+        if (!ok || data.type() == QVariant::Bool) {
+            return;
+        }
+        if (name == "aid") {
+            if (id != md->audios.getSelectedID()) {
+                md->audios.setSelectedID(id);
+                if (notified_player_is_running) {
+                    emit receivedAudioTrackChanged(id);
+                }
+            }
+        } else if (id != md->videos.getSelectedID()) {
+            md->videos.setSelectedID(id);
+            if (notified_player_is_running) {
+                emit receivedVideoTrackChanged(id);
+            }
+        }
+        return;
+    } else {
+        return;
+    }
+
+    // Wait for the playing msg before starting
+    if (received_playing_msg) {
+        parseStatus(ipc_buffering, ipc_idle);
+    }
+}
+
+void TMPVProcess::onIPCReplyReceived(int requestID,
+                                     bool success,
+                                     const QVariant& data) {
+
+    if (requestID == titles_request_id) {
+        titles_request_id = -1;
+        if (success) {
+            parseTitleList(data.toList());
+        }
+        waiting_for_answers--;
+    } else if (requestID == chapters_request_id) {
+        chapters_request_id = -1;
+        if (success) {
+            parseChapterList(data.toList());
+        }
+        waiting_for_answers--;
+    } else {
+        return;
+    }
+
+    if (received_playing_msg && !notified_player_is_running) {
+        parseStatus(ipc_buffering, ipc_idle);
+    }
+}
+
+void TMPVProcess::requestTitleLengths(int n_titles) {
+
+    if (use_ipc && ipc->isConnected()) {
+        titles_request_id = ipc->getProperty("disc-title-list");
+        waiting_for_answers++;
+        return;
+    }
+
+    for (int idx = 0; idx < n_titles; idx++) {
+        writeToPlayer(QString("print_text \"INFO_TITLE_LENGTH=%1"
+                              " ${=disc-title-list/%1/length:-1}\"")
+                      .arg(idx));
+    }
+    waiting_for_answers += n_titles;
+}
+
+void TMPVProcess::parseTitleList(const QVariantList& list) {
+
+    for (int idx = 0; idx < list.count(); idx++) {
+        QVariantMap title = list.at(idx).toMap();
+        if (title.contains("length")) {
+            md->titles.addDuration(idx + 1, title.value("length").toDouble());
+        }
+    }
+}
+
+void TMPVProcess::requestChapters(int n_chapters) {
+
+    if (use_ipc && ipc->isConnected()) {
+        chapters_request_id = ipc->getProperty("chapter-list");
+        waiting_for_answers++;
+        return;
+    }
+
+    for (int n = 0; n < n_chapters; n++) {
+        writeToPlayer(QString("print_text \"CHAPTER_%1="
+                              "${=chapter-list/%1/time:}"
+                              " '${chapter-list/%1/title:}'\"").arg(n));
+    }
+    waiting_for_answers += n_chapters;
+}
+
+void TMPVProcess::parseChapterList(const QVariantList& list) {
+
+    for (int id = 0; id < list.count(); id++) {
+        QVariantMap chapter = list.at(id).toMap();
+        double start = chapter.value("time").toDouble();
+        QString title = chapter.value("title").toString().trimmed();
+        md->chapters.addChapter(id, title, start);
+        WZDEBUGOBJ("Added chapter id " + QString::number(id)
+                   + " starting at " + QString::number(start)
+                   + " with title '" + title + "'");
+    }
 }
 
 bool TMPVProcess::parseVideoTrack(int id, QString name, bool selected) {
@@ -141,16 +723,24 @@ bool TMPVProcess::parseProperty(const QString& name, const QString& value) {
     }
 */
 
+    // Marker printed after a seek
+    if (name == "SEEK_DONE") {
+        seekDone();
+        bool ok;
+        double secs = value.toDouble(&ok);
+        if (ok) {
+            notifyTime(secs);
+        }
+        return true;
+    }
+
     if (name == "TITLES") {
         int n_titles = value.toInt();
         WZDEBUGOBJ("Creating " + QString::number(n_titles) + " titles");
         for (int idx = 0; idx < n_titles; idx++) {
             md->titles.addID(idx + 1);
-            writeToPlayer(QString("print_text \"INFO_TITLE_LENGTH=%1"
-                                 " ${=disc-title-list/%1/length:-1}\"")
-                         .arg(idx));
         }
-        waiting_for_answers += n_titles;
+        requestTitleLengths(n_titles);
         return true;
     }
 
@@ -172,16 +762,13 @@ bool TMPVProcess::parseProperty(const QString& name, const QString& value) {
         int n_chapters = value.toInt();
         WZDEBUGOBJ("Requesting start and titel of " + QString::number(n_chapters)
                 + " chapter(s)");
-        for (int n = 0; n < n_chapters; n++) {
-            writeToPlayer(QString("print_text \"CHAPTER_%1="
-                                 "${=chapter-list/%1/time:}"
-                                 " '${chapter-list/%1/title:}'\"").arg(n));
-        }
-        waiting_for_answers += n_chapters;
+        requestChapters(n_chapters);
         return true;
     }
 
     if (name == "MEDIA_TITLE") {
+        // Last line of the playing msg
+        received_playing_msg = true;
         if (md->image) {
             WZDEBUGOBJ("Ignoring image title");
         } else if (md->disc.valid) {
@@ -200,6 +787,10 @@ bool TMPVProcess::parseProperty(const QString& name, const QString& value) {
                 WZDEBUGOBJ("Title set to '" + md->title + "'");
             }
         }
+        // Status line not available when using IPC
+        if (use_ipc && ipc->isConnected()) {
+            parseStatus(ipc_buffering, ipc_idle);
+        }
         return true;
     }
 
@@ -451,6 +1042,11 @@ bool TMPVProcess::parseStatusLine(const QRegExp& rx) {
     notifyDuration(rx.cap(2).toDouble());
     notifyTime(rx.cap(1).toDouble());
 
+    return parseStatus(rx.cap(4) == "yes", rx.cap(5) == "yes");
+}
+
+bool TMPVProcess::parseStatus(bool buff, bool idle) {
+
     // Any pending questions?
     if (waitForAnswers()) {
         return true;
@@ -469,9 +1065,7 @@ bool TMPVProcess::parseStatusLine(const QRegExp& rx) {
 
     // Don't emit signal receivedPause(), it is not needed for MPV
     if (!paused) {
-        // Parse status flags buffering and idle
-        bool buff = rx.cap(4) == "yes";
-        bool idle = rx.cap(5) == "yes";
+        // Status flags buffering and idle
         if (buff || idle) {
             buffering = true;
             emit receivedBuffering();
@@ -503,8 +1097,6 @@ bool TMPVProcess::parseLine(QString& line) {
     static QRegExp rx_video_property("^VIDEO_([A-Z]+)=\\s*(.*)");
     static QRegExp rx_audio_property("^AUDIO_([A-Z]+)=\\s*(.*)");
 
-    static QRegExp rx_meta_data("^METADATA_LIST=(.*)");
-
     static QRegExp rx_chapter("^CHAPTER_(\\d+)=([0-9\\.-]+) '(.*)'");
 
     static QRegExp rx_title_switch("^\\[(cdda|vcd|dvd|dvdnav|br)\\] .*switched to (track|title):?\\s+(-?\\d+)",
@@ -516,9 +1108,6 @@ bool TMPVProcess::parseLine(QString& line) {
 
     static QRegExp rx_property("^INFO_([A-Z_]+)=\\s*(.*)");
 
-    // Messages to show in statusline
-    static QRegExp rx_message("^(\\[ytdl_hook|libdvdread: Get key)");
-
     // Errors
     static QRegExp rx_file_open("^\\[file\\] Cannot open file '.*': (.*)");
     static QRegExp rx_failed_open("^Failed to open (.*)\\.$");
@@ -530,6 +1119,17 @@ bool TMPVProcess::parseLine(QString& line) {
     // Messages to keep out of log. Invalid timestamps.
     static QRegExp rx_kill_line("^Invalid .*PTS");
 
+    // Keep the output of continued media until TPlayer opens it
+    if (holding) {
+        if (held_lines.count() < MAX_HELD_LINES) {
+            held_lines.append(line);
+        }
+        return true;
+    }
+    // Output of the previous media after TPlayer opened the next one
+    if (continued_early) {
+        return true;
+    }
 
     // Check to see if a DVD title needs to be terminated
     if (quit_at_end_of_title
@@ -543,18 +1143,24 @@ bool TMPVProcess::parseLine(QString& line) {
         return true;
     }
 
+    // The regular expressions below are only run on lines starting with the
+    // token they match, so a line is passed to at most a few of them. Checks
+    // for text not at the start of a line keep their original position.
+
     // Remove sender when using verbose
-    if (rx_verbose.indexIn(line) >= 0) {
+    if (line.startsWith('[') && rx_verbose.indexIn(line) >= 0) {
         line = rx_verbose.cap(2);
     }
 
     // Messages to keep out of log
-    if (rx_kill_line.indexIn(line) >= 0) {
+    if (line.startsWith(QLatin1String("Invalid "))
+            && rx_kill_line.indexIn(line) >= 0) {
         return true;
     }
 
     // Parse custom status line
-    if (rx_status.indexIn(line) >= 0) {
+    if (line.startsWith(QLatin1String("T:"))
+            && rx_status.indexIn(line) >= 0) {
         return parseStatusLine(rx_status);
     }
 
@@ -562,21 +1168,25 @@ bool TMPVProcess::parseLine(QString& line) {
     if (TPlayerProcess::parseLine(line))
         return true;
 
-    if (rx_message.indexIn(line) >= 0) {
+    // Messages to show in statusline
+    if (line.startsWith(QLatin1String("[ytdl_hook"))
+            || line.startsWith(QLatin1String("libdvdread: Get key"))) {
         emit receivedMessage(line);
         return true;
     }
 
     // Video id, codec, name and selected
     // If enabled, track info does give lang
-    if (rx_video_track.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("--vid="))
+            && rx_video_track.indexIn(line) >= 0) {
         return parseVideoTrack(rx_video_track.cap(2).toInt(),
                                rx_video_track.cap(3).trimmed(),
                                !rx_video_track.cap(1).trimmed().isEmpty());
     }
 
     // Audio id, lang, codec, name and selected
-    if (rx_audio_track.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("--aid="))
+            && rx_audio_track.indexIn(line) >= 0) {
         return parseAudioTrack(rx_audio_track.cap(2).toInt(),
                                rx_audio_track.cap(4),
                                rx_audio_track.cap(5).trimmed(),
@@ -584,7 +1194,8 @@ bool TMPVProcess::parseLine(QString& line) {
     }
 
     // Subtitles id, lang, name, type and selected
-    if (rx_subtitle_track.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("--sid="))
+            && rx_subtitle_track.indexIn(line) >= 0) {
         return parseSubtitleTrack(rx_subtitle_track.cap(2).toInt(),
                                   rx_subtitle_track.cap(4),
                                   rx_subtitle_track.cap(6).trimmed(),
@@ -592,87 +1203,115 @@ bool TMPVProcess::parseLine(QString& line) {
                                   !rx_subtitle_track.cap(1).trimmed().isEmpty());
     }
 
-    // AO
-    if (rx_ao.indexIn(line) >= 0) {
-        md->ao = rx_ao.cap(1);
-        WZDEBUGOBJ("Audio driver '" + md->ao + "'");
-        return true;
-    }
+    switch (line.isEmpty() ? 0 : line.at(0).unicode()) {
+    case 'A':
+        // AO
+        if (line.startsWith(QLatin1String("AO: "))) {
+            if (rx_ao.indexIn(line) >= 0) {
+                md->ao = rx_ao.cap(1);
+                WZDEBUGOBJ("Audio driver '" + md->ao + "'");
+                return true;
+            }
+            break;
+        }
 
-    // Video codec
-    // Fall back to generic VIDEO_CODEC in TPlayerProcess::parseVideoProperty()
-    // if match fails.
-    if (line.startsWith("VIDEO_CODEC=")) {
-        int i = line.indexOf(" (");
-        if (i >= 0) {
-            md->video_codec = line.left(i).mid(12);
-            md->video_codec_description = line.mid(i + 2);
-            md->video_codec_description.chop(1);
-            WZDEBUGOBJ("video_codec set to '" + md->video_codec + "'");
-            WZDEBUGOBJ("video_codec_description set to '"
-                    + md->video_codec_description + "'");
-            return true;
+        if (!line.startsWith(QLatin1String("AUDIO_"))) {
+            break;
         }
-    }
 
-    // Video property VIDEO_name and value
-    if (rx_video_property.indexIn(line) >= 0) {
-        return parseVideoProperty(rx_video_property.cap(1),
-                                  rx_video_property.cap(2));
-    }
+        // Audio codec
+        // Fall back to generic AUDIO_CODEC in
+        // TPlayerProcess::parseAudioProperty() if match fails.
+        if (line.startsWith(QLatin1String("AUDIO_CODEC="))) {
+            int i = line.indexOf(" (");
+            if (i >= 0) {
+                md->audio_codec = line.left(i).mid(12);
+                md->audio_codec_description = line.mid(i + 2);
+                md->audio_codec_description.chop(1);
+                WZDEBUGOBJ("audio_codec set to '" + md->audio_codec + "'");
+                WZDEBUGOBJ("audio_codec_description set to '"
+                        + md->audio_codec_description + "'");
+                return true;
+            }
+        }
 
-    // Audio codec
-    // Fall back to generic AUDIO_CODEC in TPlayerProcess::parseAudioProperty()
-    // if match fails.
-    if (line.startsWith("AUDIO_CODEC=")) {
-        int i = line.indexOf(" (");
-        if (i >= 0) {
-            md->audio_codec = line.left(i).mid(12);
-            md->audio_codec_description = line.mid(i + 2);
-            md->audio_codec_description.chop(1);
-            WZDEBUGOBJ("audio_codec set to '" + md->audio_codec + "'");
-            WZDEBUGOBJ("audio_codec_description set to '"
-                    + md->audio_codec_description + "'");
-            return true;
+        // Audio property AUDIO_name and value
+        if (rx_audio_property.indexIn(line) >= 0) {
+            return parseAudioProperty(rx_audio_property.cap(1),
+                                      rx_audio_property.cap(2));
         }
-    }
+        break;
 
-    // Audio property AUDIO_name and value
-    if (rx_audio_property.indexIn(line) >= 0) {
-        return parseAudioProperty(rx_audio_property.cap(1),
-                                  rx_audio_property.cap(2));
-    }
+    case 'V':
+        if (!line.startsWith(QLatin1String("VIDEO_"))) {
+            break;
+        }
 
-    // Chapter id, time and title
-    if (rx_chapter.indexIn(line) >= 0) {
-        return parseChapter(rx_chapter.cap(1).toInt(),
-                            rx_chapter.cap(2).toDouble(),
-                            rx_chapter.cap(3).trimmed());
-    }
+        // Video codec
+        // Fall back to generic VIDEO_CODEC in
+        // TPlayerProcess::parseVideoProperty() if match fails.
+        if (line.startsWith(QLatin1String("VIDEO_CODEC="))) {
+            int i = line.indexOf(" (");
+            if (i >= 0) {
+                md->video_codec = line.left(i).mid(12);
+                md->video_codec_description = line.mid(i + 2);
+                md->video_codec_description.chop(1);
+                WZDEBUGOBJ("video_codec set to '" + md->video_codec + "'");
+                WZDEBUGOBJ("video_codec_description set to '"
+                        + md->video_codec_description + "'");
+                return true;
+            }
+        }
 
-    // Property INFO_name and value
-    if (rx_property.indexIn(line) >= 0) {
-        return parseProperty(rx_property.cap(1), rx_property.cap(2));
-    }
+        // Video property VIDEO_name and value
+        if (rx_video_property.indexIn(line) >= 0) {
+            return parseVideoProperty(rx_video_property.cap(1),
+                                      rx_video_property.cap(2));
+        }
+        break;
+
+    case 'C':
+        // Chapter id, time and title
+        if (line.startsWith(QLatin1String("CHAPTER_"))
+                && rx_chapter.indexIn(line) >= 0) {
+            return parseChapter(rx_chapter.cap(1).toInt(),
+                                rx_chapter.cap(2).toDouble(),
+                                rx_chapter.cap(3).trimmed());
+        }
+        break;
 
-    // Meta data METADATA_name and value
-    if (rx_meta_data.indexIn(line) >= 0) {
-        return parseMetaDataList(rx_meta_data.cap(1));
-    }
+    case 'I':
+        // Property INFO_name and value
+        if (line.startsWith(QLatin1String("INFO_"))
+                && rx_property.indexIn(line) >= 0) {
+            return parseProperty(rx_property.cap(1), rx_property.cap(2));
+        }
+        break;
 
-    // Switch title
-    if (rx_title_switch.indexIn(line) >= 0) {
-        return parseTitleSwitched(rx_title_switch.cap(1).toLower(),
-                                  rx_title_switch.cap(3).toInt());
-    }
+    case 'M':
+        // Meta data METADATA_name and value
+        if (line.startsWith(QLatin1String("METADATA_LIST="))) {
+            return parseMetaDataList(line.mid(14));
+        }
+        break;
+
+    case '[':
+        // Switch title
+        if (rx_title_switch.indexIn(line) >= 0) {
+            return parseTitleSwitched(rx_title_switch.cap(1).toLower(),
+                                      rx_title_switch.cap(3).toInt());
+        }
 
-    // Title not found
-    if (rx_title_not_found.indexIn(line) >= 0) {
-        return parseTitleNotFound(rx_title_not_found.cap(1));
+        // Title not found
+        if (rx_title_not_found.indexIn(line) >= 0) {
+            return parseTitleNotFound(rx_title_not_found.cap(1));
+        }
+        break;
     }
 
     // Stream title
-    if (rx_stream_title.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("icy-title: "))
+            && rx_stream_title.indexIn(line) >= 0) {
         md->detected_type = TMediaData::TYPE_STREAM;
         QString s = rx_stream_title.cap(1);
         md->title = s;
@@ -682,33 +1321,39 @@ bool TMPVProcess::parseLine(QString& line) {
     }
 
     // Errors
-    if (rx_file_open.indexIn(line) >= 0) {
+    if (line.startsWith(QLatin1String("[file] "))
+            && rx_file_open.indexIn(line) >= 0) {
         WZDEBUGOBJ("Storing file open failed");
         exit_code_override = TExitMsg::ERR_FILE_OPEN;
         TExitMsg::setExitCodeMsg(rx_file_open.cap(1));
         return true;
     }
-    if (rx_failed_open.indexIn(line) >= 0) {
-        if (exit_code_override == 0 && rx_failed_open.cap(1) == md->filename) {
-            WZDEBUGOBJ("Storing open failed");
-            exit_code_override = TExitMsg::ERR_OPEN;
-        } else {
-            WZDEBUGOBJ("Skipped open failed");
+    if (line.startsWith(QLatin1String("Failed to "))) {
+        if (rx_failed_open.indexIn(line) >= 0) {
+            if (exit_code_override == 0
+                    && rx_failed_open.cap(1) == md->filename) {
+                WZDEBUGOBJ("Storing open failed");
+                exit_code_override = TExitMsg::ERR_OPEN;
+            } else {
+                WZDEBUGOBJ("Skipped open failed");
+            }
+        }
+        if (rx_failed_format.indexIn(line) >= 0) {
+            WZDEBUGOBJ("Stored unrecognized file format");
+            exit_code_override = TExitMsg::ERR_FILE_FORMAT;
         }
     }
-    if (rx_failed_format.indexIn(line) >= 0) {
-        WZDEBUGOBJ("Stored unrecognized file format");
-        exit_code_override = TExitMsg::ERR_FILE_FORMAT;
-    }
-    if (rx_error_http_403.indexIn(line) >= 0) {
-        WZDEBUGOBJ("Stored HTTP 403");
-        exit_code_override = TExitMsg::ERR_HTTP_403;
-        return true;
-    }
-    if (rx_error_http_404.indexIn(line) >= 0) {
-        WZDEBUGOBJ("Stored HTTP 404");
-        exit_code_override = TExitMsg::ERR_HTTP_404;
-        return true;
+    if (line.contains(QLatin1String("HTTP error 40"))) {
+        if (rx_error_http_403.indexIn(line) >= 0) {
+            WZDEBUGOBJ("Stored HTTP 403");
+            exit_code_override = TExitMsg::ERR_HTTP_403;
+            return true;
+        }
+        if (rx_error_http_404.indexIn(line) >= 0) {
+            WZDEBUGOBJ("Stored HTTP 404");
+            exit_code_override = TExitMsg::ERR_HTTP_404;
+            return true;
+        }
     }
 
     return false;
@@ -744,8 +1389,11 @@ void TMPVProcess::setMedia(const QString& media) {
         "METADATA_LIST=${=metadata/list:}\n"
         "INFO_MEDIA_TITLE=${=media-title:}\n";
 
-    args << "--term-status-msg=T:${=time-pos}/${=duration:${=length:0}}"
-            " P:${=pause} B:${=paused-for-cache} I:${=core-idle}";
+    // With IPC the status arrives as property change events
+    if (!use_ipc) {
+        args << "--term-status-msg=T:${=time-pos}/${=duration:${=length:0}}"
+                " P:${=pause} B:${=paused-for-cache} I:${=core-idle}";
+    }
 
     // MPV interprets the ID in a DVD URL as index [0..#titles-1] instead of
     // [1..#titles]. Sigh. When no title is given it plays the longest title it
@@ -766,6 +1414,8 @@ void TMPVProcess::setMedia(const QString& media) {
         url = "mf://@" + temp_file_name;
     }
 
+    media_url = url;
+    media_arg = args.count();
     args << url;
 
     capturing = false;
@@ -773,8 +1423,30 @@ void TMPVProcess::setMedia(const QString& media) {
 
 void TMPVProcess::setFixedOptions() {
 
+    // Load the player info once, the isOptionAvailable() checks while
+    // building the arguments only use the in memory index
+    Player::Info::TPlayerInfo::obj()->getInfo();
+
+    filter_graph.clear();
     args << "--no-config";
-    args << "--no-quiet";
+    use_ipc = Settings::pref->mpv_use_ipc;
+    keep_running = use_ipc && Settings::pref->mpv_keep_running;
+    media_arg = -1;
+    if (use_ipc) {
+        args << "--quiet";
+        args << ipc->serverOption();
+        if (keep_running) {
+            args << "--idle=yes";
+            // Undo changes made while playing before loading the next file
+            args << "--reset-on-next-file=all";
+            // Read ahead into media appended by appendMedia()
+            if (isOptionAvailable("--prefetch-playlist")) {
+                args << "--prefetch-playlist=yes";
+            }
+        }
+    } else {
+        args << "--no-quiet";
+    }
     args << "--terminal";
     args << "--no-msg-color";
     args << "--input-file=/dev/stdin";
@@ -796,23 +1468,33 @@ void TMPVProcess::disableInput() {
 }
 
 bool TMPVProcess::isOptionAvailable(const QString& option) {
+    return Player::Info::TPlayerInfo::obj()->hasOption(option);
+}
+
+void TMPVProcess::addVF(const QString& filter_name, const QString& filter) {
 
-    Player::Info::TPlayerInfo* ir = Player::Info::TPlayerInfo::obj();
-    ir->getInfo();
-    return ir->optionList().contains(option);
+    // Label the filters TPlayer can change while playing
+    QString label = TMPVFilterGraph::label(filter_name);
+    QString s;
+    if (label.isEmpty()) {
+        s = "--vf-add=" + filter;
+    } else {
+        s = filter_graph.addOption(label, filter);
+    }
+    args << s;
+    WZDEBUGOBJ("Added video filter '" + s + "'");
 }
 
-void TMPVProcess::addVFIfAvailable(const QString& vf, const QString& value) {
+void TMPVProcess::addVFIfAvailable(const QString& filter_name,
+                                   const QString& vf,
+                                   const QString& value) {
 
-    Player::Info::TPlayerInfo* ir = Player::Info::TPlayerInfo::obj();
-    ir->getInfo();
-    if (ir->vfList().contains(vf)) {
-        QString s = "--vf-add=" + vf;
+    if (Player::Info::TPlayerInfo::obj()->hasVideoFilter(vf)) {
+        QString s = vf;
         if (!value.isEmpty()) {
             s += "=" + value;
         }
-        args << s;
-        WZDEBUGOBJ("Added video filter '" + s + "'");
+        addVF(filter_name, s);
     } else {
         WZINFOOBJ("Video filter '" + vf + "' is not available");
     }
@@ -820,6 +1502,14 @@ void TMPVProcess::addVFIfAvailable(const QString& vf, const QString& value) {
 
 void TMPVProcess::setOption(const QString& name, const QVariant& value) {
 
+    if (name == "vo") {
+        QString vo = value.toString().section(',', 0, 0).section(':', 0, 0);
+        if (!vo.isEmpty()
+            && !Player::Info::TPlayerInfo::obj()->hasVO(vo)) {
+            WZWARNOBJ("Video output '" + vo + "' not listed by player");
+        }
+    }
+
     // Options without translation
     if (name == "wid"
         || name == "vo"
@@ -993,36 +1683,36 @@ void TMPVProcess::addVideoFilter(const QString& filter_name,
     if ((filter_name == "harddup") || (filter_name == "hue")) {
         // ignore
     } else if (filter_name == "eq2") {
-        args << "--vf-add=eq";
+        addVF(filter_name, "eq");
     } else if (filter_name == "blur") {
-        addVFIfAvailable("lavfi", "[unsharp=la=-1.5:ca=-1.5]");
+        addVFIfAvailable(filter_name, "lavfi", "[unsharp=la=-1.5:ca=-1.5]");
     } else if (filter_name == "sharpen") {
-        addVFIfAvailable("lavfi", "[unsharp=la=1.5:ca=1.5]");
+        addVFIfAvailable(filter_name, "lavfi", "[unsharp=la=1.5:ca=1.5]");
     } else if (filter_name == "noise") {
-        addVFIfAvailable("lavfi", "[noise=alls=9:allf=t]");
+        addVFIfAvailable(filter_name, "lavfi", "[noise=alls=9:allf=t]");
     } else if (filter_name == "deblock") {
-        addVFIfAvailable("lavfi", "[pp=" + option +"]");
+        addVFIfAvailable(filter_name, "lavfi", "[pp=" + option +"]");
     } else if (filter_name == "dering") {
-        addVFIfAvailable("lavfi", "[pp=dr]");
+        addVFIfAvailable(filter_name, "lavfi", "[pp=dr]");
     } else if (filter_name == "phase") {
-        addVFIfAvailable("lavfi", "[phase=" + option +"]");
+        addVFIfAvailable(filter_name, "lavfi", "[phase=" + option +"]");
     } else if (filter_name == "postprocessing") {
-        addVFIfAvailable("lavfi", "[pp]");
+        addVFIfAvailable(filter_name, "lavfi", "[pp]");
     } else if (filter_name == "hqdn3d") {
         QString o;
         if (!option.isEmpty())
             o = "=" + option;
-        addVFIfAvailable("lavfi", "[hqdn3d" + o +"]");
+        addVFIfAvailable(filter_name, "lavfi", "[hqdn3d" + o +"]");
     } else if (filter_name == "yadif") {
         if (option == "1") {
-            args << "--vf-add=yadif=field";
+            addVF(filter_name, "yadif=field");
         } else {
-            args << "--vf-add=yadif";
+            addVF(filter_name, "yadif");
         }
     } else if (filter_name == "kerndeint") {
-        addVFIfAvailable("lavfi", "[kerndeint=" + option +"]");
+        addVFIfAvailable(filter_name, "lavfi", "[kerndeint=" + option +"]");
     } else if (filter_name == "lb" || filter_name == "l5") {
-        addVFIfAvailable("lavfi", "[pp=" + filter_name +"]");
+        addVFIfAvailable(filter_name, "lavfi", "[pp=" + filter_name +"]");
     } else if (filter_name == "subs_on_screenshots") {
         // Ignore
     } else if (filter_name == "screenshot") {
@@ -1032,7 +1722,7 @@ void TMPVProcess::addVideoFilter(const QString& filter_name,
                     + QDir::toNativeSeparators(screenshot_dir);
         }
     } else if (filter_name == "rotate") {
-        args << "--vf-add=rotate=" + option;
+        addVF(filter_name, "rotate=" + option);
     } else {
         if (filter_name == "pp") {
             QString s;
@@ -1041,22 +1731,27 @@ void TMPVProcess::addVideoFilter(const QString& filter_name,
             } else {
                 s = "[pp=" + option + "]";
             }
-            addVFIfAvailable("lavfi", s);
+            addVFIfAvailable(filter_name, "lavfi", s);
         } else if (filter_name == "extrastereo") {
             args << "--af-add=lavfi=[extrastereo]";
         } else if (filter_name == "karaoke") {
             /* Not supported anymore, ignore */
+        } else if (filter_name == "scale" && option.isEmpty()) {
+            // Scale added for the software equalizer. Leave it unlabelled,
+            // @scale belongs to the upscaling filter changed by
+            // TPlayer::setSoftwareScaling().
+            args << "--vf-add=scale";
         } else {
             QString s = filter_name;
             if (!option.isEmpty())
                 s += "=" + option;
-            args << "--vf-add=" + s;
+            addVF(filter_name, s);
         }
     }
 }
 
 void TMPVProcess::addStereo3DFilter(const QString& in, const QString& out) {
-    args << "--vf-add=stereo3d=" + in + ":" + out;
+    addVF("stereo3d", "stereo3d=" + in + ":" + out);
 }
 
 void TMPVProcess::addAudioFilter(const QString& filter_name,
@@ -1080,7 +1775,7 @@ void TMPVProcess::addAudioFilter(const QString& filter_name,
         }
     } else if (filter_name == "equalizer") {
         previous_audio_equalizer = option;
-        args << "--af-add=equalizer=" + option;
+        args << "--af-add=@equalizer:equalizer=" + option;
     } else {
         QString s = filter_name;
         if (!option.isEmpty()) s += "=" + option;
@@ -1089,7 +1784,7 @@ void TMPVProcess::addAudioFilter(const QString& filter_name,
 }
 
 void TMPVProcess::setVolume(int v) {
-    writeToPlayer("set volume " + QString::number(v));
+    queueToPlayer("volume", "set volume " + QString::number(v));
 }
 
 void TMPVProcess::setOSDLevel(int level) {
@@ -1140,14 +1835,26 @@ void TMPVProcess::seekPlayerTime(double secs,
                                  bool currently_paused) {
     Q_UNUSED(currently_paused)
 
-    QString s = "seek " + QString::number(secs) + " ";
+    QString flags;
     switch (mode) {
-        case 0 : s += "relative "; break;
-        case 1 : s += "absolute-percent "; break;
-        case 2 : s += "absolute "; break;
+        case 0 : flags = "relative"; break;
+        case 1 : flags = "absolute-percent"; break;
+        case 2 : flags = "absolute"; break;
     }
-    if (keyframes) s += "keyframes"; else s += "exact";
-    writeToPlayer(s);
+    flags += keyframes ? "+keyframes" : "+exact";
+
+    // Send seeks as JSON request to make their latency measurable
+    if (use_ipc && ipc->isConnected() && !received_end_of_file) {
+        WZDEBUGOBJ("seek " + QString::number(secs) + " " + flags);
+        ipc->sendCommand(QVariantList() << "seek" << secs << flags);
+        return;
+    }
+
+    flags.replace('+', ' ');
+    writeToPlayer("seek " + QString::number(secs) + " " + flags);
+    // MPV handles commands in order, so INFO_SEEK_DONE arrives after the
+    // seek. Status lines printed before it can still be from before the seek.
+    writeToPlayer("print_text INFO_SEEK_DONE=${=time-pos:}", false);
 }
 
 void TMPVProcess::mute(bool b) {
@@ -1181,23 +1888,23 @@ void TMPVProcess::showTimeOnOSD() {
 }
 
 void TMPVProcess::setContrast(int value) {
-    writeToPlayer("set contrast " + QString::number(value));
+    queueToPlayer("contrast", "set contrast " + QString::number(value));
 }
 
 void TMPVProcess::setBrightness(int value) {
-    writeToPlayer("set brightness " + QString::number(value));
+    queueToPlayer("brightness", "set brightness " + QString::number(value));
 }
 
 void TMPVProcess::setHue(int value) {
-    writeToPlayer("set hue " + QString::number(value));
+    queueToPlayer("hue", "set hue " + QString::number(value));
 }
 
 void TMPVProcess::setSaturation(int value) {
-    writeToPlayer("set saturation " + QString::number(value));
+    queueToPlayer("saturation", "set saturation " + QString::number(value));
 }
 
 void TMPVProcess::setGamma(int value) {
-    writeToPlayer("set gamma " + QString::number(value));
+    queueToPlayer("gamma", "set gamma " + QString::number(value));
 }
 
 void TMPVProcess::setChapter(int ID) {
@@ -1226,11 +1933,11 @@ void TMPVProcess::setExternalSubtitleFile(const QString& filename) {
 }
 
 void TMPVProcess::setSubPos(int pos) {
-    writeToPlayer("set sub-pos " + QString::number(pos));
+    queueToPlayer("sub-pos", "set sub-pos " + QString::number(pos));
 }
 
 void TMPVProcess::setSubScale(double value) {
-    writeToPlayer("set sub-scale " + QString::number(value));
+    queueToPlayer("sub-scale", "set sub-scale " + QString::number(value));
 }
 
 void TMPVProcess::setSubStep(int value) {
@@ -1246,7 +1953,7 @@ void TMPVProcess::setSubForcedOnly(bool b) {
 }
 
 void TMPVProcess::setSpeed(double value) {
-    writeToPlayer("set speed " + QString::number(value));
+    queueToPlayer("speed", "set speed " + QString::number(value));
 }
 
 void TMPVProcess::enableKaraoke(bool) {
@@ -1275,19 +1982,22 @@ void TMPVProcess::setAudioEqualizer(const QString& values) {
     if (values == previous_audio_equalizer) {
         return;
     }
+    // Delete by label, so a replaced pending command does not need to know
+    // which equalizer was actually added
+    QString cmd;
     if (!previous_audio_equalizer.isEmpty()) {
-        writeToPlayer("af del equalizer=" + previous_audio_equalizer);
+        cmd = "af del @equalizer\n";
     }
-    writeToPlayer("af add equalizer=" + values);
+    queueToPlayer("equalizer", cmd + "af add @equalizer:equalizer=" + values);
     previous_audio_equalizer = values;
 }
 
 void TMPVProcess::setAudioDelay(double delay) {
-    writeToPlayer("set audio-delay " + QString::number(delay));
+    queueToPlayer("audio-delay", "set audio-delay " + QString::number(delay));
 }
 
 void TMPVProcess::setSubDelay(double delay) {
-    writeToPlayer("set sub-delay " + QString::number(delay));
+    queueToPlayer("sub-delay", "set sub-delay " + QString::number(delay));
 }
 
 void TMPVProcess::setLoop(int v) {
@@ -1348,7 +2058,8 @@ void TMPVProcess::discButtonPressed(const QString& button_name) {
 }
 
 void TMPVProcess::setAspect(double aspect) {
-    writeToPlayer("set video-aspect " + QString::number(aspect));
+    queueToPlayer("video-aspect",
+                  "set video-aspect " + QString::number(aspect));
 }
 
 void TMPVProcess::toggleDeinterlace() {
@@ -1356,7 +2067,7 @@ void TMPVProcess::toggleDeinterlace() {
 }
 
 void TMPVProcess::setOSDScale(double value) {
-    writeToPlayer("set osd-scale " + QString::number(value));
+    queueToPlayer("osd-scale", "set osd-scale " + QString::number(value));
 }
 
 void TMPVProcess::setVideoFilter(const QString& filter,
@@ -1411,17 +2122,43 @@ void TMPVProcess::setVideoFilter(const QString& filter,
     }
 
     if (!f.isEmpty()) {
-        writeToPlayer(QString("vf %1 \"%2\"")
-                      .arg(enable ? "add" : "del").arg(f));
+        setVF(filter, enable, f);
     }
 }
 
 void TMPVProcess::setStereo3DFilter(bool enable,
                                        const QString& in,
                                        const QString& out) {
-    QString filter = "stereo3d=" + in + ":" + out;
-    writeToPlayer(QString("vf %1 \"%2\"")
-                  .arg(enable ? "add" : "del").arg(filter));
+    setVF("stereo3d", enable, "stereo3d=" + in + ":" + out);
+}
+
+void TMPVProcess::setVF(const QString& filter_name,
+                        bool enable,
+                        const QString& filter) {
+
+    QString label = TMPVFilterGraph::label(filter_name);
+    if (label.isEmpty()) {
+        writeToPlayer(QString("vf %1 \"%2\"")
+                      .arg(enable ? "add" : "del").arg(filter));
+        return;
+    }
+
+    QStringList commands = enable ? filter_graph.setFilter(label, filter)
+                                  : filter_graph.removeFilter(label);
+    for (int i = 0; i < commands.count(); i++) {
+        writeToPlayer(commands.at(i));
+    }
+}
+
+bool TMPVProcess::canChangeVideoFilter(const QString& filter_name) const {
+
+    // Filters depending on software decoded frames need a restart to
+    // disable hardware decoding
+    if (md->video_hwdec) {
+        QString label = TMPVFilterGraph::label(filter_name);
+        return label == "deinterlace" || label == "rotate";
+    }
+    return true;
 }
 
 void TMPVProcess::setSubStyles(const Settings::TAssStyles& styles,
@@ -20,11 +20,16 @@
 #define PLAYER_PROCESS_MPVPROCESS_H
 
 #include "player/process/playerprocess.h"
+#include "player/process/mpvfiltergraph.h"
+
+class QJsonObject;
 
 
 namespace Player {
 namespace Process {
 
+class TMPVIPC;
+
 class TMPVProcess : public TPlayerProcess {
     Q_OBJECT
 public:
@@ -33,6 +38,9 @@ public:
                          TMediaData* mdata);
 
     virtual bool startPlayer();
+    virtual void stopPlaying();
+    virtual bool isIdle() const;
+    virtual void appendMedia(const QString& media);
 
     // Command line options
     void setMedia(const QString& media);
@@ -108,21 +116,73 @@ public:
     void toggleDeinterlace();
     void setOSDScale(double value);
 
+    virtual bool canChangeVideoFilter(const QString& filter_name) const;
+
     virtual void save();
 
 protected:
+    virtual void resetPlayingState();
     virtual void notifyPlayingStarted();
     virtual void checkTime(int ms);
 
     virtual bool parseLine(QString& line);
     virtual bool parseProperty(const QString& name, const QString& value);
+    virtual void writeCommand(const QString& text);
     bool isOptionAvailable(const QString& option);
-    void addVFIfAvailable(const QString& vf, const QString& value = "");
+    void addVF(const QString& filter_name, const QString& filter);
+    void setVF(const QString& filter_name, bool enable, const QString& filter);
+    void addVFIfAvailable(const QString& filter_name,
+                          const QString& vf,
+                          const QString& value = "");
 
 protected slots:
     void requestChapterInfo();
+    virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
 private:
+    TMPVIPC* ipc;
+    bool use_ipc;
+    bool received_playing_msg;
+    bool ipc_buffering;
+    bool ipc_idle;
+    int titles_request_id;
+    int chapters_request_id;
+
+    // Keep the player running with --idle and open media with loadfile
+    bool keep_running;
+    bool player_idle;
+    bool stop_requested;
+    bool discard_finished;
+    int reused_count;
+    // Executable and options the running player was started with
+    QString running_program;
+    QStringList running_args;
+    // Media and per file options to load once IPC is connected
+    QString load_url;
+    QStringList load_options;
+    // Per file options of the current media
+    QStringList file_options;
+
+    // Media appended to the playlist of MPV by appendMedia()
+    QString next_url;
+    QStringList next_options;
+    // Media MPV continues with after the end of file. Until MPV switched to
+    // it, reported by a change of playlist-pos, the output still belongs to
+    // the previous media. After the switch the output is held until TPlayer
+    // opens the media. When TPlayer opened it before the switch, the output
+    // until the switch is discarded.
+    bool continuing;
+    bool holding;
+    bool continued_early;
+    QTimer* holdTimer;
+    QString continuing_url;
+    QStringList continuing_options;
+    QStringList held_lines;
+    QList<QPair<QString, QVariant> > held_properties;
+    // Media set by setMedia() and its index in args
+    QString media_url;
+    int media_arg;
+
     bool received_buffering;
     bool received_title_not_found;
     bool capturing;
@@ -133,10 +193,26 @@ private:
 
     QString sub_file;
     QString previous_audio_equalizer;
+    TMPVFilterGraph filter_graph;
+
+    bool startKeptPlayer();
+    bool splitArguments(QStringList& process_args,
+                        QStringList& options) const;
+    void loadFile(const QString& url, const QStringList& options,
+                  const QString& flags);
+    void continueHeldMedia();
+    void dropHeldMedia();
+    void onPlaylistPosChanged();
+    void quitIdlePlayer();
 
     void convertChaptersToTitles();
     void fixTitle();
     bool parseStatusLine(const QRegExp& rx);
+    bool parseStatus(bool buff, bool idle);
+    void requestTitleLengths(int n_titles);
+    void requestChapters(int n_chapters);
+    void parseTitleList(const QVariantList& list);
+    void parseChapterList(const QVariantList& list);
     bool parseChapter(int id, double start, QString title);
     bool parseTitleSwitched(QString disc_type, int title);
     bool parseTitleNotFound(const QString& disc_type);
@@ -146,6 +222,13 @@ private:
     bool parseSubtitleTrack(int id, const QString& lang, QString name,
                             QString type, bool selected);
     bool parseMetaDataList(QString list);
+
+private slots:
+    void onIPCConnected();
+    void onIPCPropertyChanged(const QString& name, const QVariant& data);
+    void onIPCReplyReceived(int requestID, bool success, const QVariant& data);
+    void onIPCEventReceived(const QString& event, const QJsonObject& obj);
+    void onHoldTimeout();
 };
 
 } // namespace Process
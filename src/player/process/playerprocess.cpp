@@ -28,6 +28,8 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QString>
+#include <QDateTime>
+#include <QTimer>
 
 
 LOG4QT_DECLARE_STATIC_LOGGER(logger, Player::Process::TPlayerProcess)
@@ -37,6 +39,14 @@ namespace Process {
 
 const int waiting_for_answers_safe_guard_init = 100;
 
+// Log the queue latency every LOG_QUEUE_INTERVAL written commands
+const int LOG_QUEUE_INTERVAL = 1000;
+
+// Log the seek latency every LOG_SEEK_INTERVAL seeks
+const int LOG_SEEK_INTERVAL = 100;
+// Time to wait for a seek to finish before sending the next one
+const int SEEK_TIMEOUT = 1000;
+
 
 TPlayerProcess* TPlayerProcess::createPlayerProcess(QObject* parent,
                                                     const QString& name,
@@ -61,9 +71,24 @@ TPlayerProcess::TPlayerProcess(QObject* parent,
     TProcess(parent, name),
     md(mdata),
     notified_player_is_running(false),
+    waiting_for_answers(0),
+    paused(false),
+    buffering(false),
     received_end_of_file(false),
     quit_send(false),
-    line_count(0) {
+    exit_code_override(0),
+    queue_written(0),
+    queue_coalesced(0),
+    queue_latency_total_ns(0),
+    queue_latency_max_ns(0),
+    seek_in_flight(false),
+    seek_pending(false),
+    seek_count(0),
+    seek_dropped(0),
+    seek_latency_total_ns(0),
+    seek_latency_max_ns(0),
+    line_count(0),
+    waiting_for_answers_safe_guard(waiting_for_answers_safe_guard_init) {
 
     //qRegisterMetaType<TSubTracks>("TSubTracks");
     //qRegisterMetaType<Maps::TTracks>("Tracks");
@@ -71,30 +96,126 @@ TPlayerProcess::TPlayerProcess(QObject* parent,
 
     connect(this, SIGNAL(finished(int, QProcess::ExitStatus)),
             this, SLOT(onFinished(int, QProcess::ExitStatus)));
+
+    // Single shot with interval 0 fires once the event loop is idle
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(0);
+    connect(flushTimer, &QTimer::timeout,
+            this, &TPlayerProcess::flushCommandQueue);
+
+    seekTimeoutTimer = new QTimer(this);
+    seekTimeoutTimer->setSingleShot(true);
+    seekTimeoutTimer->setInterval(SEEK_TIMEOUT);
+    connect(seekTimeoutTimer, &QTimer::timeout,
+            this, &TPlayerProcess::onSeekTimeout);
 }
 
 void TPlayerProcess::writeToPlayer(const QString& text, bool log) {
 
+    // Keep the order in which commands were given
+    if (!command_queue.isEmpty()) {
+        flushCommandQueue();
+    }
+    writeNow(text, log);
+}
+
+void TPlayerProcess::queueToPlayer(const QString& key, const QString& text,
+                                   bool log) {
+
+    for (int i = 0; i < command_queue.count(); i++) {
+        if (command_queue.at(i).key == key) {
+            WZTOBJ << "Replacing" << command_queue.at(i).text << "by" << text;
+            command_queue.removeAt(i);
+            queue_coalesced++;
+            break;
+        }
+    }
+
+    TQueuedCommand cmd;
+    cmd.key = key;
+    cmd.text = text;
+    cmd.log = log;
+    cmd.queued.start();
+    command_queue.append(cmd);
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void TPlayerProcess::flushCommandQueue() {
+
+    flushTimer->stop();
+    while (!command_queue.isEmpty()) {
+        TQueuedCommand cmd = command_queue.takeFirst();
+
+        qint64 ns = cmd.queued.nsecsElapsed();
+        queue_latency_total_ns += ns;
+        if (ns > queue_latency_max_ns) {
+            queue_latency_max_ns = ns;
+        }
+        queue_written++;
+        if (queue_written % LOG_QUEUE_INTERVAL == 0) {
+            logQueueLatency();
+        }
+
+        writeNow(cmd.text, cmd.log);
+    }
+}
+
+void TPlayerProcess::clearCommandQueue() {
+
+    flushTimer->stop();
+    if (!command_queue.isEmpty()) {
+        WZDOBJ << "Dropping" << command_queue.count() << "queued commands";
+        command_queue.clear();
+    }
+}
+
+double TPlayerProcess::averageQueueLatencyMS() const {
+
+    if (queue_written == 0) {
+        return 0;
+    }
+    return double(queue_latency_total_ns) / queue_written / 1000000;
+}
+
+void TPlayerProcess::logQueueLatency() {
+
+    if (queue_written > 0) {
+        WZDOBJ << "Wrote" << queue_written << "queued commands."
+               << "Coalesced" << queue_coalesced << "commands."
+               << "Average latency" << averageQueueLatencyMS() << "ms."
+               << "Max latency" << maxQueueLatencyMS() << "ms";
+    }
+}
+
+void TPlayerProcess::writeNow(const QString& text, bool log) {
+
     if (log) {
         WZDEBUGOBJ(text);
     }
 
-    if (received_end_of_file) {
+    if (received_end_of_file && !isIdle()) {
         WZWOBJ << "Skipping write of" << text << "after eof";
     } else if (isRunning()) {
+        writeCommand(text);
+    } else {
+        WZWOBJ << "Process not running while trying to write" << text;
+    }
+}
+
+void TPlayerProcess::writeCommand(const QString& text) {
 
 #ifdef Q_OS_WIN
-        write(text.toUtf8() + "\n");
+    write(text.toUtf8() + "\n");
 #else
-        write(text.toLocal8Bit() + "\n");
+    write(text.toLocal8Bit() + "\n");
 #endif
-
-    } else {
-        WZWOBJ << "Process not running while trying to write" << text;
-    }
 }
 
-bool TPlayerProcess::startPlayer() {
+void TPlayerProcess::resetPlayingState() {
 
     exit_code_override = 0;
     TExitMsg::setExitCodeMsg("");
@@ -109,9 +230,31 @@ bool TPlayerProcess::startPlayer() {
 
     received_end_of_file = false;
     quit_send = false;
+    clearCommandQueue();
+    clearSeeks();
 
-    // Start the player process
     startTime.start();
+}
+
+bool TPlayerProcess::startPlayer() {
+
+    resetPlayingState();
+
+    // Record the output to replay it with parserbench
+    QString path = Settings::pref->player_transcript_path;
+    if (path.isEmpty()) {
+        setTranscriptFileName("");
+    } else {
+        setTranscriptFileName(QDir(path).filePath(
+            QString("%1-%2-%3.txt")
+            .arg(Settings::TPreferences::playerIDToString(
+                     Settings::pref->player_id))
+            .arg(objectName())
+            .arg(QDateTime::currentDateTime()
+                 .toString("yyyyMMdd-hhmmss-zzz"))));
+    }
+
+    // Start the player process
     start();
     // and wait for it to come up
     return waitForStarted();
@@ -123,6 +266,11 @@ void TPlayerProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
            << "override" << exit_code_override
            << "status" << exitStatus;
 
+    clearCommandQueue();
+    logQueueLatency();
+    clearSeeks();
+    logSeekLatency();
+
     if (exit_code_override) {
         exitCode = exit_code_override;
     }
@@ -271,31 +419,37 @@ bool TPlayerProcess::parseLine(QString& line) {
     if (quit_send) {
         return true;
     }
-    WZDEBUGOBJ("\"" + line + "\"");
+    if (logger()->isDebugEnabled()) {
+        WZDEBUGOBJ("\"" + line + "\"");
+    }
 
     // Video out driver
-    if (rx_vo.indexIn(line) >= 0) {
+    if (line.startsWith(QLatin1String("VO: ")) && rx_vo.indexIn(line) >= 0) {
         return parseVO(rx_vo.cap(1),
                        rx_vo.cap(2).toInt(), rx_vo.cap(3).toInt(),
                        rx_vo.cap(5).toInt(), rx_vo.cap(6).toInt());
     }
 
     // No disc
-    if (rx_no_disk.indexIn(line) >= 0) {
+    if (line.contains(QLatin1String("No medium found"), Qt::CaseInsensitive)
+            && rx_no_disk.indexIn(line) >= 0) {
         WZWARN("No disc in device");
         quit(TExitMsg::ERR_NO_DISC);
         return true;
     }
 
     // End of file
-    if (rx_eof.indexIn(line) >= 0)  {
+    if ((line.startsWith(QLatin1String("Exiting"))
+         || line.startsWith(QLatin1String("ID_EXIT=EOF")))
+            && rx_eof.indexIn(line) >= 0)  {
         WZDEBUGOBJ("Received end of file");
         setEOF();
         return true;
     }
 
     // DVD serial number
-    if (rx_dvd_serial.indexIn(line) >= 0)  {
+    if (line.contains(QLatin1String("Serial Number: "))
+            && rx_dvd_serial.indexIn(line) >= 0)  {
         md->dvd_disc_serial = rx_dvd_serial.cap(1);
         WZDEBUGOBJ("Serial set to " + md->dvd_disc_serial);
         return true;
@@ -538,7 +692,106 @@ void TPlayerProcess::seek(double secs, int mode, bool keyframes,
     if (mode == 2) {
         secs = guiTimeToPlayerTime(secs);
     }
-    seekPlayerTime(secs, mode, keyframes, currently_paused);
+
+    if (!seek_in_flight) {
+        TSeek s = { secs, mode, keyframes, currently_paused };
+        sendSeek(s);
+        return;
+    }
+
+    if (seek_pending) {
+        seek_dropped++;
+        if (mode == 0) {
+            // Add a relative seek to the target of the pending seek
+            if (pending_seek.mode == 0) {
+                pending_seek.secs += secs;
+            } else if (pending_seek.mode == 2) {
+                pending_seek.secs = qMax(0.0, pending_seek.secs + secs);
+            } else if (md->duration_ms > 0) {
+                pending_seek.secs = qBound(0.0, pending_seek.secs
+                                           + secs * 100000 / md->duration_ms,
+                                           100.0);
+            }
+            // Without duration keep the percent seek as it is
+            pending_seek.keyframes = keyframes;
+            pending_seek.paused = currently_paused;
+            return;
+        }
+    }
+
+    // A percent or absolute seek replaces the pending seek
+    pending_seek.secs = secs;
+    pending_seek.mode = mode;
+    pending_seek.keyframes = keyframes;
+    pending_seek.paused = currently_paused;
+    seek_pending = true;
+}
+
+void TPlayerProcess::sendSeek(const TSeek& s) {
+
+    seek_in_flight = true;
+    seek_timer.start();
+    seekTimeoutTimer->start();
+    seekPlayerTime(s.secs, s.mode, s.keyframes, s.paused);
+}
+
+void TPlayerProcess::seekDone() {
+
+    if (!seek_in_flight) {
+        return;
+    }
+
+    qint64 ns = seek_timer.nsecsElapsed();
+    seek_latency_total_ns += ns;
+    if (ns > seek_latency_max_ns) {
+        seek_latency_max_ns = ns;
+    }
+    seek_count++;
+    if (seek_count % LOG_SEEK_INTERVAL == 0) {
+        logSeekLatency();
+    }
+
+    seekTimeoutTimer->stop();
+    seek_in_flight = false;
+    if (seek_pending) {
+        seek_pending = false;
+        sendSeek(pending_seek);
+    }
+}
+
+void TPlayerProcess::onSeekTimeout() {
+    WZDOBJ << "Seek not finished within" << SEEK_TIMEOUT << "ms";
+
+    seek_in_flight = false;
+    if (seek_pending) {
+        seek_pending = false;
+        sendSeek(pending_seek);
+    }
+}
+
+void TPlayerProcess::clearSeeks() {
+
+    seekTimeoutTimer->stop();
+    seek_in_flight = false;
+    seek_pending = false;
+}
+
+double TPlayerProcess::averageSeekLatencyMS() const {
+
+    if (seek_count == 0) {
+        return 0;
+    }
+    return double(seek_latency_total_ns) / seek_count / 1000000;
+}
+
+void TPlayerProcess::logSeekLatency() {
+
+    if (seek_count > 0) {
+        WZDOBJ << "Finished" << seek_count << "seeks."
+               << "Dropped" << seek_dropped << "seeks."
+               << "Average seek to frame latency" << averageSeekLatencyMS()
+               << "ms. Max latency" << maxSeekLatencyMS() << "ms";
+    }
 }
 
 void TPlayerProcess::setCaptureDirectory(const QString& dir) {
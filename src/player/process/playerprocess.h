@@ -25,8 +25,11 @@
 
 #include <QTemporaryFile>
 #include <QTime>
+#include <QElapsedTimer>
+#include <QList>
 
 class QRegExp;
+class QTimer;
 class TMediaData;
 
 namespace Player {
@@ -54,10 +57,37 @@ public:
                && isRunning();
     }
     bool isBuffering() const { return buffering; }
+    // Running, but not playing anything while waiting for the next media
+    virtual bool isIdle() const { return false; }
 
     virtual bool startPlayer();
+    // Stop playing. Quits the player unless it can stay idle for reuse.
+    virtual void stopPlaying() { quit(0); }
+    // Media that will be opened after the current one, to open in advance
+    virtual void appendMedia(const QString&) {}
 
     void writeToPlayer(const QString& text, bool log = true);
+    // Queue a command setting the state identified by key. A pending command
+    // with the same key is replaced. The queue is written once per event
+    // loop iteration or before the next command passed to writeToPlayer().
+    void queueToPlayer(const QString& key, const QString& text,
+                       bool log = true);
+
+    // Time between queueing a command and writing it to the player
+    int queuedCommands() const { return queue_written; }
+    int coalescedCommands() const { return queue_coalesced; }
+    double averageQueueLatencyMS() const;
+    double maxQueueLatencyMS() const {
+        return double(queue_latency_max_ns) / 1000000;
+    }
+
+    // Time between sending a seek and the player showing the new position
+    int seeksDone() const { return seek_count; }
+    int seeksDropped() const { return seek_dropped; }
+    double averageSeekLatencyMS() const;
+    double maxSeekLatencyMS() const {
+        return double(seek_latency_max_ns) / 1000000;
+    }
 
     // Command line options
     virtual void setMedia(const QString& media) = 0;
@@ -88,6 +118,10 @@ public:
     virtual void setSubtitlesVisibility(bool b) = 0;
     virtual void seekPlayerTime(double secs, int mode, bool keyframes,
                                 bool currently_paused) = 0;
+    // Only one seek is sent to the player at a time. Seeks requested while
+    // a seek is in progress are merged into one pending seek, which is sent
+    // when the player finished the current seek. A relative seek is added to
+    // the pending seek, other seeks replace it.
     virtual void seek(double secs, int mode, bool keyframes,
                       bool currently_paused);
     virtual void mute(bool b) = 0;
@@ -137,6 +171,10 @@ public:
     virtual void toggleDeinterlace() = 0;
     virtual void setOSDScale(double value) = 0;
 
+    // Whether setVideoFilter() and setStereo3DFilter() can change
+    // filter_name while playing. If not, the player needs a restart.
+    virtual bool canChangeVideoFilter(const QString&) const { return false; }
+
     void setScreenshotDirectory(const QString& dir) { screenshot_dir = dir; }
     QString screenshotDirectory() const { return screenshot_dir; }
     virtual void setCaptureDirectory(const QString& dir);
@@ -206,6 +244,9 @@ protected:
 
     QString temp_file_name;
 
+    // Reset the state kept for the media being played
+    virtual void resetPlayingState();
+
     double guiTimeToPlayerTime(double sec);
     int playerTimeToGuiTime(int ms);
 
@@ -215,6 +256,12 @@ protected:
     void notifyTime(double time_sec);
     bool waitForAnswers();
 
+    // Write a command to the player. Default writes to stdin.
+    virtual void writeCommand(const QString& text);
+
+    // Called by descendants when the player finished a seek
+    void seekDone();
+
     virtual void notifyPlayingStarted();
     virtual bool parseLine(QString& line);
     virtual bool parseAudioProperty(const QString& name, const QString& value);
@@ -226,13 +273,55 @@ protected slots:
     virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
 private:
+    struct TQueuedCommand {
+        QString key;
+        QString text;
+        bool log;
+        QElapsedTimer queued;
+    };
+
+    QList<TQueuedCommand> command_queue;
+    QTimer* flushTimer;
+    int queue_written;
+    int queue_coalesced;
+    qint64 queue_latency_total_ns;
+    qint64 queue_latency_max_ns;
+
+    struct TSeek {
+        double secs;
+        int mode;
+        bool keyframes;
+        bool paused;
+    };
+
+    bool seek_in_flight;
+    bool seek_pending;
+    TSeek pending_seek;
+    QElapsedTimer seek_timer;
+    QTimer* seekTimeoutTimer;
+    int seek_count;
+    int seek_dropped;
+    qint64 seek_latency_total_ns;
+    qint64 seek_latency_max_ns;
+
     int line_count;
     int waiting_for_answers_safe_guard;
 
     QTemporaryFile temp_file;
 
+    void writeNow(const QString& text, bool log);
+    void clearCommandQueue();
+    void logQueueLatency();
+    void sendSeek(const TSeek& s);
+    void clearSeeks();
+    void logSeekLatency();
+
     bool parseAngle(const QString& value);
     bool parseVO(const QString& vo, int sw, int sh, int dw, int dh);
+
+private slots:
+    void flushCommandQueue();
+    void onSeekTimeout();
 };
 
 } // namespace Process
@@ -25,9 +25,13 @@ LOG4QT_DECLARE_STATIC_LOGGER(logger, Player::Process::TProcess)
 namespace Player {
 namespace Process {
 
+const int INPUT_RESERVE = 16384;
+
 TProcess::TProcess(QObject* parent, const QString& name) :
     QProcess(parent),
-    line_count(0) {
+    input_start(0),
+    line_count(0),
+    byte_count(0) {
 
     setObjectName(name);
     setProcessChannelMode(QProcess::MergedChannels);
@@ -37,6 +41,8 @@ TProcess::TProcess(QObject* parent, const QString& name) :
     connect(this, SIGNAL(finished(int, QProcess::ExitStatus)),
             this, SLOT(procFinished()));
 
+    // Reserve, so the buffer is not freed when resized to 0
+    input.reserve(INPUT_RESERVE);
     line_time.start();
 }
 
@@ -65,7 +71,19 @@ QStringList TProcess::arguments() {
 void TProcess::start() {
     WZDOBJ << "Program:" << program << "args:" << args;
 
-    remaining_output.clear();
+    input.resize(0);
+    input_start = 0;
+
+    transcript.close();
+    if (!transcript_filename.isEmpty()) {
+        transcript.setFileName(transcript_filename);
+        if (transcript.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            WZDOBJ << "Recording transcript" << transcript_filename;
+        } else {
+            WZWOBJ << "Failed to open transcript" << transcript_filename
+                   << transcript.errorString();
+        }
+    }
 
     QProcess::start(program, args, QIODevice::ReadWrite);
 }
@@ -78,20 +96,34 @@ void TProcess::handleLine(QString& line) {
 
     line_count++;
     if (line_count % 10000 == 0) {
-        WZDEBUGOBJ(QString("Parsed %1 lines at %2 lines per second")
+        double secs = double(line_time.elapsed()) / 1000;
+        WZDEBUGOBJ(QString("Parsed %1 lines at %2 lines and %3 bytes"
+                           " per second")
                    .arg(line_count)
-                   .arg(double(line_count * 1000) / line_time.elapsed()));
+                   .arg(line_count / secs)
+                   .arg(byte_count / secs));
     }
 }
 
-QString TProcess::bytesToString(const char* bytes, int size) {
+void TProcess::bytesToString(const char* bytes, int size, QString& line) {
 // memo: TColorUtils::stripColorsTags(QString::fromLocal8Bit(ba));
 
+    // Fast path for ASCII, reusing the memory already allocated by line.
+    // Only allocates when line grows or when a parser kept a copy of it.
+    line.resize(size);
+    QChar* dest = line.data();
+    for (int i = 0; i < size; i++) {
+        uchar c = bytes[i];
+        if (c >= 0x80) {
 #ifdef Q_OS_WIN
-    return QString::fromUtf8(bytes, size);
+            line = QString::fromUtf8(bytes, size);
 #else
-    return QString::fromLocal8Bit(bytes, size);
+            line = QString::fromLocal8Bit(bytes, size);
 #endif
+            return;
+        }
+        dest[i] = QLatin1Char(c);
+    }
 }
 
 // Needed because MPlayer uses \r for its status line
@@ -104,29 +136,71 @@ const char* TProcess::EOL(const char* start, const char* end) {
     return eol;
 }
 
-void TProcess::genericRead(QByteArray buffer) {
+void TProcess::genericRead() {
 
-    remaining_output += buffer;
-
-    const char* start = remaining_output.constData();
-    const char* end = start + remaining_output.size();
+    const char* data = input.constData();
+    const char* start = data + input_start;
+    const char* end = data + input.size();
     const char* pos = EOL(start, end);
 
     while (pos < end) {
         if (pos > start) {
-            QString line = bytesToString(start, pos - start);
-            handleLine(line);
+            bytesToString(start, pos - start, line_buffer);
+            handleLine(line_buffer);
         }
         start = pos + 1;
         pos = EOL(start, end);
     }
 
-    remaining_output = remaining_output.mid(
-        start - remaining_output.constData());
+    input_start = start - data;
+    if (input_start >= input.size()) {
+        // Everything parsed. Keeps the reserved memory.
+        input.resize(0);
+        input_start = 0;
+    }
 }
 
 void TProcess::readStdOut() {
-    genericRead(readAllStandardOutput());
+
+    qint64 available = bytesAvailable();
+    if (available <= 0) {
+        return;
+    }
+
+    // Move the unparsed tail to the front, if it is smaller than the parsed
+    // part, instead of copying it on every read
+    int size = input.size();
+    if (input_start > 0 && input_start >= size - input_start) {
+        input.remove(0, input_start);
+        input_start = 0;
+        size = input.size();
+    }
+
+    // Read directly into the buffer. Only allocates when it needs to grow.
+    input.resize(size + available);
+    qint64 bytes = read(input.data() + size, available);
+    if (bytes < 0) {
+        bytes = 0;
+    }
+    input.resize(size + bytes);
+    byte_count += bytes;
+
+    if (transcript.isOpen()) {
+        transcript.write(input.constData() + size, bytes);
+    }
+
+    genericRead();
+}
+
+void TProcess::replay(const char* bytes, int size) {
+
+    if (input_start > 0) {
+        input.remove(0, input_start);
+        input_start = 0;
+    }
+    input.append(bytes, size);
+    byte_count += size;
+    genericRead();
 }
 
 void TProcess::procFinished() {
@@ -137,6 +211,7 @@ void TProcess::procFinished() {
     if (ba > 0) {
         readStdOut();
     }
+    transcript.close();
 }
 
 } // namespace Process
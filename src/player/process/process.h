@@ -20,6 +20,7 @@
 #define PLAYER_PROCESS_PROCESS_H
 
 #include <QProcess>
+#include <QFile>
 #include <QTime>
 
 //! TProcess is a specialized QProcess designed to properly work with mplayer.
@@ -47,25 +48,41 @@ public:
 
     void start();            //!< Start the process
 
+    //! Record the raw output of the process to fileName, empty to disable
+    void setTranscriptFileName(const QString& fileName) {
+        transcript_filename = fileName;
+    }
+    //! Feed output, like a recorded transcript, to the parser
+    void replay(const char* bytes, int size);
+
 protected slots:
     void readStdOut();       //!< Called for reading from standard output
     void procFinished();     //!< Called when the process has finished
 
 protected:
-    //! Called from readStdOut() and readTmpFile() to do all the work
-    void genericRead(QByteArray buffer);
+    //! Called from readStdOut() to split the input into lines
+    void genericRead();
     virtual bool parseLine(QString& line) = 0;
 
 protected:
     QString program;
     QStringList args;
-    QByteArray remaining_output;
 
 private:
+    //! Bytes read from the process. Bytes before input_start are parsed.
+    QByteArray input;
+    int input_start;
+    //! Reused for every line to save an allocation per line
+    QString line_buffer;
+
     int line_count;
+    qint64 byte_count;
     QTime line_time;
 
-    QString bytesToString(const char* bytes, int size);
+    QString transcript_filename;
+    QFile transcript;
+
+    void bytesToString(const char* bytes, int size, QString& line);
     void handleLine(QString& line);
     const char* EOL(const char* start, const char* end);
 };
@@ -0,0 +1,337 @@
+#include "player/thumbnailindex.h"
+#include "settings/preferences.h"
+#include "settings/paths.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QPainter>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+#endif
+
+
+namespace Player {
+
+// Take a thumbnail at least every MIN_INTERVAL_MS ms, with no more than
+// MAX_THUMBNAILS thumbnails per file
+const int MIN_INTERVAL_MS = 10000;
+const int MAX_THUMBNAILS = 200;
+const int THUMBNAIL_WIDTH = 160;
+const int SPRITE_COLUMNS = 10;
+const int SPRITE_QUALITY = 80;
+// Give up on files taking longer to index
+const int INDEX_TIMEOUT = 180000;
+// Drop the least recently used indexes when the cache gets bigger
+const qint64 MAX_CACHE_SIZE = 256 * 1024 * 1024;
+
+// Process running at idle CPU and I/O priority, to keep the indexer out of
+// the way of the player
+class TIdleProcess : public QProcess {
+public:
+    explicit TIdleProcess(QObject* parent) : QProcess(parent) {
+#if defined(Q_OS_WIN) && QT_VERSION >= 0x050700
+        setCreateProcessArgumentsModifier(
+            [](QProcess::CreateProcessArguments* args) {
+                args->flags |= IDLE_PRIORITY_CLASS;
+            });
+#endif
+    }
+
+protected:
+#ifndef Q_OS_WIN
+    // Runs in the child after fork()
+    virtual void setupChildProcess() override {
+        setpriority(PRIO_PROCESS, 0, 19);
+#if defined(Q_OS_LINUX) && defined(SYS_ioprio_set)
+        // IOPRIO_WHO_PROCESS, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT
+        syscall(SYS_ioprio_set, 1, 0, 3 << 13);
+#endif
+    }
+#endif
+};
+
+TThumbnailIndex::TThumbnailIndex(QObject* parent) :
+    QObject(parent),
+    interval_ms(0),
+    count(0),
+    columns(0),
+    proc(0),
+    tempDir(0) {
+
+    setObjectName("thumbnail_index");
+
+    timeoutTimer = new QTimer(this);
+    timeoutTimer->setSingleShot(true);
+    timeoutTimer->setInterval(INDEX_TIMEOUT);
+    connect(timeoutTimer, &QTimer::timeout,
+            this, &TThumbnailIndex::onTimeout);
+}
+
+TThumbnailIndex::~TThumbnailIndex() {
+    stopProcess();
+}
+
+// Identify the file by its path, size and modification time, so a changed
+// file gets a new index
+QString TThumbnailIndex::fileKey(const QString& filename) {
+
+    QFileInfo fi(filename);
+    if (!fi.isFile()) {
+        return QString();
+    }
+
+    QString id = fi.canonicalFilePath()
+                 + "|" + QString::number(fi.size())
+                 + "|" + QString::number(fi.lastModified().toMSecsSinceEpoch());
+    return QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Md5)
+            .toHex();
+}
+
+bool TThumbnailIndex::open(const QString& filename, int duration_ms) {
+
+    if (filename == this->filename && (isReady() || proc)) {
+        return isReady();
+    }
+
+    close();
+    this->filename = filename;
+    key = fileKey(filename);
+    if (key.isEmpty() || duration_ms <= 0) {
+        return false;
+    }
+    if (load()) {
+        return true;
+    }
+
+    interval_ms = qMax(MIN_INTERVAL_MS, duration_ms / MAX_THUMBNAILS);
+    count = duration_ms / interval_ms + 1;
+
+    tempDir = new QTemporaryDir();
+    if (!tempDir->isValid()) {
+        WZWARNOBJ("Failed to create temporary directory");
+        stopProcess();
+        return false;
+    }
+
+    // Seek from keyframe to keyframe, decoding only the frames to save
+    using namespace Settings;
+    QString step = QString::number(double(interval_ms) / 1000);
+    QString scale = "scale=" + QString::number(THUMBNAIL_WIDTH) + ":-2";
+    QStringList args;
+    if (pref->isMPV()) {
+        args << "--no-config" << "--really-quiet" << "--no-audio"
+             << "--no-sub" << "--hr-seek=no" << "--untimed"
+             << "--sstep=" + step
+             << "--frames=" + QString::number(count)
+             << "--vf=" + scale
+             << "--vo=image" << "--vo-image-format=jpg"
+             << "--vo-image-outdir=" + tempDir->path()
+             << "--" << filename;
+    } else {
+        // Quote the directory with the %length% syntax of MPlayer, so a ':'
+        // in the path does not end the suboption
+        QString dir = tempDir->path();
+        args << "-noconfig" << "all" << "-really-quiet" << "-nosound"
+             << "-nosub" << "-benchmark"
+             << "-sstep" << step
+             << "-frames" << QString::number(count)
+             << "-vf" << scale
+             << "-vo" << "jpeg:outdir=%"
+                         + QString::number(dir.toLocal8Bit().length())
+                         + "%" + dir
+             << "--" << filename;
+    }
+
+    proc = new TIdleProcess(this);
+    proc->setStandardOutputFile(QProcess::nullDevice());
+    proc->setStandardErrorFile(QProcess::nullDevice());
+    connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>
+                (&QProcess::finished),
+            this, &TThumbnailIndex::onFinished);
+
+    WZDOBJ << "Indexing" << filename << "every" << interval_ms << "ms";
+    proc->start(pref->player_bin, args);
+    timeoutTimer->start();
+    return false;
+}
+
+void TThumbnailIndex::close() {
+
+    stopProcess();
+    filename.clear();
+    key.clear();
+    sprite = QImage();
+    interval_ms = 0;
+    count = 0;
+    columns = 0;
+}
+
+void TThumbnailIndex::stopProcess() {
+
+    timeoutTimer->stop();
+    if (proc) {
+        proc->disconnect(this);
+        if (proc->state() != QProcess::NotRunning) {
+            proc->kill();
+            proc->waitForFinished(1000);
+        }
+        proc->deleteLater();
+        proc = 0;
+    }
+    delete tempDir;
+    tempDir = 0;
+}
+
+bool TThumbnailIndex::load() {
+
+    QString base = Settings::TPaths::thumbnailIndexPath() + "/" + key;
+    if (!QFileInfo(base + ".ini").exists()) {
+        return false;
+    }
+
+    QSettings ini(base + ".ini", QSettings::IniFormat);
+    interval_ms = ini.value("interval_ms").toInt();
+    count = ini.value("count").toInt();
+    columns = ini.value("columns").toInt();
+    tile_size = ini.value("tile_size").toSize();
+    if (interval_ms <= 0 || count <= 0 || columns <= 0
+        || tile_size.isEmpty() || !sprite.load(base + ".jpg")) {
+        WZWARNOBJ("Failed to load index '" + base + "'");
+        sprite = QImage();
+        return false;
+    }
+
+    // Writing the ini updates its modification time, used by pruneCache()
+    ini.setValue("last_used", QDateTime::currentDateTime());
+
+    WZDOBJ << "Loaded" << count << "thumbnails for" << filename;
+    return true;
+}
+
+// Keep the cache below MAX_CACHE_SIZE by removing the least recently used
+// indexes
+void TThumbnailIndex::pruneCache() {
+
+    QDir dir(Settings::TPaths::thumbnailIndexPath());
+    QFileInfoList inis = dir.entryInfoList(QStringList() << "*.ini",
+                                           QDir::Files, QDir::Time);
+    qint64 total = 0;
+    int dropped = 0;
+    for (int i = 0; i < inis.count(); i++) {
+        const QFileInfo& ini = inis.at(i);
+        QFileInfo jpg(dir.filePath(ini.completeBaseName() + ".jpg"));
+        total += ini.size() + jpg.size();
+        if (total > MAX_CACHE_SIZE) {
+            QFile::remove(jpg.absoluteFilePath());
+            QFile::remove(ini.absoluteFilePath());
+            dropped++;
+        }
+    }
+    if (dropped > 0) {
+        WZDEBUG(QString("Removed %1 least recently used indexes")
+                .arg(dropped));
+    }
+}
+
+bool TThumbnailIndex::createSprite() {
+
+    QDir dir(tempDir->path());
+    QStringList files = dir.entryList(QStringList() << "*.jpg", QDir::Files,
+                                      QDir::Name);
+    if (files.isEmpty()) {
+        WZWARNOBJ("No thumbnails extracted from '" + filename + "'");
+        return false;
+    }
+
+    QImage first(dir.filePath(files.at(0)));
+    if (first.isNull()) {
+        WZWARNOBJ("Failed to load thumbnail '" + files.at(0) + "'");
+        return false;
+    }
+
+    count = qMin(files.count(), MAX_THUMBNAILS);
+    columns = qMin(count, SPRITE_COLUMNS);
+    tile_size = first.size();
+    int rows = (count + columns - 1) / columns;
+    QImage sheet(columns * tile_size.width(), rows * tile_size.height(),
+                 QImage::Format_RGB32);
+    sheet.fill(Qt::black);
+
+    QPainter painter(&sheet);
+    for (int i = 0; i < count; i++) {
+        QImage image = i == 0 ? first : QImage(dir.filePath(files.at(i)));
+        if (!image.isNull()) {
+            QRect r(QPoint((i % columns) * tile_size.width(),
+                           (i / columns) * tile_size.height()), tile_size);
+            painter.drawImage(r, image);
+        }
+    }
+    painter.end();
+    sprite = sheet;
+
+    QString path = Settings::TPaths::thumbnailIndexPath();
+    QString base = path + "/" + key;
+    if (!QDir().mkpath(path)
+        || !sheet.save(base + ".jpg", "JPG", SPRITE_QUALITY)) {
+        WZWARNOBJ("Failed to save index '" + base + "'");
+    } else {
+        QSettings ini(base + ".ini", QSettings::IniFormat);
+        ini.setValue("filename", filename);
+        ini.setValue("interval_ms", interval_ms);
+        ini.setValue("count", count);
+        ini.setValue("columns", columns);
+        ini.setValue("tile_size", tile_size);
+        ini.setValue("last_used", QDateTime::currentDateTime());
+        ini.sync();
+        pruneCache();
+    }
+
+    return true;
+}
+
+void TThumbnailIndex::onFinished(int exitCode, QProcess::ExitStatus) {
+    WZDOBJ << "Indexer finished with exit code" << exitCode;
+
+    timeoutTimer->stop();
+    bool created = createSprite();
+    stopProcess();
+    if (created) {
+        WZDOBJ << "Created" << count << "thumbnails for" << filename;
+        emit ready();
+    }
+}
+
+void TThumbnailIndex::onTimeout() {
+
+    WZWARNOBJ("Indexing '" + filename + "' takes too long, giving up");
+    stopProcess();
+}
+
+QPixmap TThumbnailIndex::thumbnail(int ms) const {
+
+    if (!isReady()) {
+        return QPixmap();
+    }
+
+    int i = qBound(0, qRound(double(ms) / interval_ms), count - 1);
+    QRect r(QPoint((i % columns) * tile_size.width(),
+                   (i / columns) * tile_size.height()), tile_size);
+    return QPixmap::fromImage(sprite.copy(r));
+}
+
+} // namespace Player
+
+#include "moc_thumbnailindex.cpp"
@@ -0,0 +1,71 @@
+#ifndef PLAYER_THUMBNAILINDEX_H
+#define PLAYER_THUMBNAILINDEX_H
+
+#include "wzdebug.h"
+
+#include <QObject>
+#include <QImage>
+#include <QPixmap>
+#include <QProcess>
+
+class QTemporaryDir;
+class QTimer;
+
+
+namespace Player {
+
+// Index of thumbnails taken at fixed intervals from a video file, to show
+// seek previews without seeking the preview player. The thumbnails are
+// extracted in the background by a separate player process, seeking from
+// keyframe to keyframe, at idle CPU and I/O priority, and stored as a single
+// sprite sheet in the cache directory, keyed by the path, size and
+// modification time of the file. The least recently used sprite sheets are
+// removed when the cache grows too big.
+class TThumbnailIndex : public QObject {
+    Q_OBJECT
+    LOG4QT_DECLARE_QCLASS_LOGGER
+public:
+    explicit TThumbnailIndex(QObject* parent);
+    virtual ~TThumbnailIndex() override;
+
+    // Load the index for filename from the cache or start creating it in the
+    // background. Returns true if the index was found in the cache.
+    bool open(const QString& filename, int duration_ms);
+    void close();
+
+    bool isReady() const { return !sprite.isNull(); }
+    QString fileName() const { return filename; }
+    // Thumbnail closest to ms
+    QPixmap thumbnail(int ms) const;
+
+signals:
+    // Emitted when the index for fileName() has been created
+    void ready();
+
+private:
+    QString filename;
+    QString key;
+    int interval_ms;
+    int count;
+    int columns;
+    QSize tile_size;
+    QImage sprite;
+
+    QProcess* proc;
+    QTemporaryDir* tempDir;
+    QTimer* timeoutTimer;
+
+    static QString fileKey(const QString& filename);
+    static void pruneCache();
+    bool load();
+    bool createSprite();
+    void stopProcess();
+
+private slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onTimeout();
+};
+
+} // namespace Player
+
+#endif // PLAYER_THUMBNAILINDEX_H
@@ -153,6 +153,14 @@ QString TPaths::playerInfoFileName() {
     return dataPath() +  "/player_info_version_3.ini";
 }
 
+QString TPaths::dirCacheFileName() {
+    return dataPath() +  "/directories.dat";
+}
+
+QString TPaths::durationCacheFileName() {
+    return dataPath() +  "/durations.dat";
+}
+
 QString TPaths::fileSettingsFileName() {
     return dataPath() +  "/" + TConfig::PROGRAM_ID + "_files.ini";
 }
@@ -161,5 +169,9 @@ QString TPaths::fileSettingsHashPath() {
     return dataPath() +  "/file_settings";
 }
 
+QString TPaths::thumbnailIndexPath() {
+    return genericCachePath() + "/" + TConfig::PROGRAM_ID + "/thumbnail_index";
+}
+
 } // namespace Settings
 
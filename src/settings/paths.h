@@ -41,9 +41,12 @@ public:
     static QString qtTranslationPath();
     static QString subtitleStyleFileName();
     static QString playerInfoFileName();
+    static QString dirCacheFileName();
+    static QString durationCacheFileName();
     static QString fileSettingsFileName();
     static QString fileSettingsHashPath();
     static QString genericCachePath();
+    static QString thumbnailIndexPath();
 
 private:
     static QString configDir;
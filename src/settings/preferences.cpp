@@ -76,7 +76,10 @@ void TPreferences::reset() {
     player_bin = default_mpv_bin;
     mpv_bin = default_mpv_bin;
     mplayer_bin = default_mplayer_bin;
+    mpv_use_ipc = false;
+    mpv_keep_running = false;
     report_player_crashes = true;
+    player_transcript_path = "";
 
     remember_media_settings = false;
     remember_time_pos = false;
@@ -257,6 +260,7 @@ void TPreferences::reset() {
     imageDuration = 10;
 
     useDirectoriePlaylists = false;
+    autoRefreshPlaylist = true;
 
     nameBlacklist.clear();
     titleBlacklist = QStringList() << "RARBG" << "\\.com";
@@ -335,6 +339,7 @@ void TPreferences::reset() {
     cache_for_dvds = 0; // not recommended to use cache for dvds
     cache_for_vcds = 1024;
     cache_for_audiocds = 1024;
+    position_update_interval = 0;
 
     // Network
     ipPrefer = IP_PREFER_AUTO;
@@ -389,6 +394,8 @@ void TPreferences::save() {
     setValue("bin", mpv_bin);
     setValue("vo", mpv_vo);
     setValue("ao", mpv_ao);
+    setValue("use_ipc", mpv_use_ipc);
+    setValue("keep_running", mpv_keep_running);
 
     setValue("hwdec", hwdec);
     setValue("screenshot_template", screenshot_template);
@@ -400,6 +407,7 @@ void TPreferences::save() {
     setValue("player_bin", player_bin);
 
     setValue("report_player_crashes", report_player_crashes);
+    setValue("transcript_path", player_transcript_path);
 
     setValue("remember_media_settings", remember_media_settings);
     setValue("remember_time_pos", remember_time_pos);
@@ -580,6 +588,7 @@ void TPreferences::save() {
     setValue("add_images", addImages);
     setValue("image_duration", imageDuration);
     setValue("use_directorie_playlists", useDirectoriePlaylists);
+    setValue("auto_refresh_playlist", autoRefreshPlaylist);
     setValue("name_blacklist", nameBlacklist);
     setValue("title_blacklist", titleBlacklist);
     endGroup();
@@ -642,6 +651,7 @@ void TPreferences::save() {
     setValue("cache_for_dvds", cache_for_dvds);
     setValue("cache_for_vcds", cache_for_vcds);
     setValue("cache_for_audiocds", cache_for_audiocds);
+    setValue("position_update_interval", position_update_interval);
     endGroup(); // performance
 
 
@@ -880,6 +890,8 @@ void TPreferences::load() {
     mpv_bin = value("bin", mpv_bin).toString();
     mpv_vo = value("vo", mpv_vo).toString();
     mpv_ao = value("ao", mpv_ao).toString();
+    mpv_use_ipc = value("use_ipc", mpv_use_ipc).toBool();
+    mpv_keep_running = value("keep_running", mpv_keep_running).toBool();
     hwdec = value("hwdec", hwdec).toString();
     screenshot_template = value("screenshot_template", screenshot_template)
                           .toString();
@@ -893,6 +905,8 @@ void TPreferences::load() {
 
     report_player_crashes = value("report_player_crashes",
                                   report_player_crashes).toBool();
+    player_transcript_path = value("transcript_path",
+                                   player_transcript_path).toString();
 
     // Media settings per file
     remember_media_settings = value("remember_media_settings",
@@ -1110,6 +1124,8 @@ void TPreferences::load() {
 
     useDirectoriePlaylists = value("use_directorie_playlists",
                                    useDirectoriePlaylists).toBool();
+    autoRefreshPlaylist = value("auto_refresh_playlist",
+                                autoRefreshPlaylist).toBool();
 
     nameBlacklist = value("name_blacklist", nameBlacklist).toStringList();
     titleBlacklist = value("title_blacklist", titleBlacklist).toStringList();
@@ -1183,6 +1199,8 @@ void TPreferences::load() {
     cache_for_vcds = getInt("cache_for_vcds", 0, 100000, cache_for_vcds);
     cache_for_audiocds = getInt("cache_for_audiocds", 0, 100000,
                                 cache_for_audiocds);
+    position_update_interval = getInt("position_update_interval", 0, 10000,
+                                      position_update_interval);
     endGroup(); // performance
 
 
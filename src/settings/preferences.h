@@ -81,8 +81,15 @@ public:
     QString mpv_bin;
     QString mpv_vo;
     QString mpv_ao;
+    //! Use the JSON IPC socket of MPV for status updates and replies
+    bool mpv_use_ipc;
+    //! Keep MPV running between media and open the next with loadfile.
+    //! Requires mpv_use_ipc.
+    bool mpv_keep_running;
 
     bool report_player_crashes;
+    //! Directory to record the raw output of the player in, empty for off
+    QString player_transcript_path;
 
     bool isMPlayer() const { return player_id == ID_MPLAYER; }
     bool isMPV() const { return player_id == ID_MPV; }
@@ -286,6 +293,8 @@ public:
 
     // TODO: check usage
     bool useDirectoriePlaylists;
+    // Update playlists opened from a directory when the directory changes
+    bool autoRefreshPlaylist;
 
     QStringList nameBlacklist;
     QStringList titleBlacklist;
@@ -353,6 +362,9 @@ public:
     int cache_for_dvds;
     int cache_for_vcds;
     int cache_for_audiocds;
+    //! Minimum ms between position updates of the GUI.
+    //! 0 updates at most once per display frame.
+    int position_update_interval;
 
 
     // Network section
@@ -0,0 +1,155 @@
+#include "starttrace.h"
+#include "wzdebug.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, TStartTrace)
+
+bool TStartTrace::enabled = false;
+
+static QString trace_filename;
+static QElapsedTimer trace_timer;
+static QMutex trace_mutex;
+static QJsonArray trace_events;
+// Small ids for the threads seen, the first is the main thread
+static QHash<QThread*, int> trace_threads;
+
+
+void TStartTrace::enable(const QString& filename) {
+
+    QMutexLocker locker(&trace_mutex);
+    trace_filename = filename;
+    trace_events = QJsonArray();
+    trace_threads.clear();
+    trace_timer.start();
+    enabled = true;
+}
+
+qint64 TStartTrace::now() {
+    return trace_timer.nsecsElapsed() / 1000;
+}
+
+void TStartTrace::add(const QString& name, const QString& phase, qint64 ts,
+                      qint64 dur) {
+
+    QMutexLocker locker(&trace_mutex);
+    if (!enabled) {
+        return;
+    }
+
+    QThread* thread = QThread::currentThread();
+    int tid = trace_threads.value(thread, 0);
+    if (tid == 0) {
+        tid = trace_threads.count() + 1;
+        trace_threads.insert(thread, tid);
+
+        QString threadName = thread->objectName();
+        if (threadName.isEmpty()) {
+            threadName = tid == 1 ? "main" : "thread " + QString::number(tid);
+        }
+        QJsonObject meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = QCoreApplication::applicationPid();
+        meta["tid"] = tid;
+        QJsonObject args;
+        args["name"] = threadName;
+        meta["args"] = args;
+        trace_events.append(meta);
+    }
+
+    QJsonObject event;
+    event["name"] = name;
+    event["cat"] = "startup";
+    event["ph"] = phase;
+    event["ts"] = ts;
+    event["pid"] = QCoreApplication::applicationPid();
+    event["tid"] = tid;
+    if (dur >= 0) {
+        event["dur"] = dur;
+    }
+    if (phase == "b" || phase == "e") {
+        // Async events are matched by id
+        event["id"] = QString::number(qHash(name), 16);
+    } else if (phase == "i") {
+        event["s"] = "p";
+    }
+    trace_events.append(event);
+}
+
+void TStartTrace::complete(const QString& name, qint64 start_us) {
+
+    if (enabled) {
+        add(name, "X", start_us, now() - start_us);
+    }
+}
+
+void TStartTrace::begin(const QString& name) {
+
+    if (enabled) {
+        add(name, "b", now());
+    }
+}
+
+void TStartTrace::end(const QString& name) {
+
+    if (enabled) {
+        add(name, "e", now());
+    }
+}
+
+void TStartTrace::instant(const QString& name) {
+
+    if (enabled) {
+        add(name, "i", now());
+    }
+}
+
+void TStartTrace::finish() {
+
+    QMutexLocker locker(&trace_mutex);
+    if (!enabled) {
+        return;
+    }
+    enabled = false;
+
+    QJsonObject trace;
+    trace["traceEvents"] = trace_events;
+    trace["displayTimeUnit"] = "ms";
+    trace_events = QJsonArray();
+    trace_threads.clear();
+
+    QFile file(trace_filename);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact))
+           >= 0) {
+        WZINFO(QString("Wrote start-up trace to '%1' after %2 ms")
+               .arg(trace_filename).arg(trace_timer.elapsed()));
+    } else {
+        WZERROR(QString("Failed to write start-up trace to '%1'. %2")
+                .arg(trace_filename).arg(file.errorString()));
+    }
+}
+
+
+TStartTraceScope::TStartTraceScope(const char* name) :
+    name(name),
+    start(TStartTrace::isEnabled() ? TStartTrace::now() : -1) {
+}
+
+TStartTraceScope::~TStartTraceScope() {
+
+    if (start >= 0) {
+        TStartTrace::complete(name, start);
+    }
+}
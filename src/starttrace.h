@@ -0,0 +1,53 @@
+#ifndef STARTTRACE_H
+#define STARTTRACE_H
+
+#include <QString>
+
+
+// Records the start-up phases of the application, from main() until the
+// player started playing the first media, and writes them to a file in the
+// Chrome trace event format, for viewing in chrome://tracing or Perfetto.
+// Enabled by the command line option --trace-startup. The trace is written
+// by finish() when the first media started playing or, if nothing is played,
+// when the application exits. Recording is thread safe.
+class TStartTrace {
+public:
+    static void enable(const QString& filename);
+    static bool isEnabled() { return enabled; }
+
+    // Microseconds since enable()
+    static qint64 now();
+    // Phase that started at start_us and ends now
+    static void complete(const QString& name, qint64 start_us);
+    // Phase spanning event loop iterations. A phase started with begin()
+    // is ended by end() with the same name.
+    static void begin(const QString& name);
+    static void end(const QString& name);
+    static void instant(const QString& name);
+
+    // Write the trace file and stop recording
+    static void finish();
+
+private:
+    static bool enabled;
+
+    static void add(const QString& name, const QString& phase, qint64 ts,
+                    qint64 dur = -1);
+};
+
+// Records the lifetime of the scope as a phase of the start-up trace
+class TStartTraceScope {
+public:
+    explicit TStartTraceScope(const char* name);
+    ~TStartTraceScope();
+private:
+    const char* name;
+    qint64 start;
+};
+
+#define WZSTARTTRACE_CONCAT2(a, b) a##b
+#define WZSTARTTRACE_CONCAT(a, b) WZSTARTTRACE_CONCAT2(a, b)
+#define WZSTARTTRACE(name) TStartTraceScope \
+    WZSTARTTRACE_CONCAT(start_trace_scope_, __LINE__)(name)
+
+#endif // STARTTRACE_H
@@ -58,7 +58,10 @@ HEADERS += gui/action/menu/menu.h \
     gui/action/toolbareditor.h \
     gui/action/widgetactions.h \
     gui/playlist/addfilesthread.h \
+    gui/playlist/dirscanner.h \
+    gui/playlist/durationprober.h \
     gui/playlist/favlist.h \
+    gui/playlist/folderwatcher.h \
     gui/playlist/playlist.h \
     gui/playlist/playlistitem.h \
     gui/playlist/playlistwidget.h \
@@ -116,13 +119,17 @@ HEADERS += gui/action/menu/menu.h \
     player/info/playerinfo.h \
     player/info/playerinfomplayer.h \
     player/info/playerinfompv.h \
+    player/info/playerinfoprobe.h \
     player/process/exitmsg.h \
     player/process/mplayerprocess.h \
+    player/process/mpvfiltergraph.h \
+    player/process/mpvipc.h \
     player/process/mpvprocess.h \
     player/process/playerprocess.h \
     player/process/process.h \
     player/player.h \
     player/state.h \
+    player/thumbnailindex.h \
     qtfilecopier/qtcopydialog.h \
     qtfilecopier/qtfilecopier.h \
     qtsingleapplication/qtlocalpeer.h \
@@ -151,6 +158,7 @@ HEADERS += gui/action/menu/menu.h \
     images.h \
     mediadata.h \
     name.h \
+    starttrace.h \
     subtracks.h \
     version.h \
     wzdebug.h \
@@ -184,7 +192,10 @@ SOURCES += gui/action/menu/menu.cpp \
     gui/action/toolbareditor.cpp \
     gui/action/widgetactions.cpp \
     gui/playlist/addfilesthread.cpp \
+    gui/playlist/dirscanner.cpp \
+    gui/playlist/durationprober.cpp \
     gui/playlist/favlist.cpp \
+    gui/playlist/folderwatcher.cpp \
     gui/playlist/playlist.cpp \
     gui/playlist/playlistitem.cpp \
     gui/playlist/playlistwidget.cpp \
@@ -242,12 +253,16 @@ SOURCES += gui/action/menu/menu.cpp \
     player/info/playerinfo.cpp \
     player/info/playerinfomplayer.cpp \
     player/info/playerinfompv.cpp \
+    player/info/playerinfoprobe.cpp \
     player/process/exitmsg.cpp \
     player/process/mplayerprocess.cpp \
+    player/process/mpvfiltergraph.cpp \
+    player/process/mpvipc.cpp \
     player/process/mpvprocess.cpp \
     player/process/playerprocess.cpp \
     player/process/process.cpp \
     player/player.cpp \
+    player/thumbnailindex.cpp \
     qtfilecopier/qtcopydialog.cpp \
     qtfilecopier/qtfilecopier.cpp \
     qtsingleapplication/qtlocalpeer.cpp \
@@ -276,6 +291,7 @@ SOURCES += gui/action/menu/menu.cpp \
     images.cpp \
     mediadata.cpp \
     name.cpp \
+    starttrace.cpp \
     subtracks.cpp \
     version.cpp \
     wzdebug.cpp \
@@ -374,4 +390,5 @@ OTHER_FILES += \
     ../man/wzplayer.1 \
     wzplayer.rc \
     ../setup/wzplayer.nsi \
-    ../Makefile
+    ../Makefile \
+    parserbench.pro